@@ -22,6 +22,30 @@ invalid () {
   :
 }
 
+status=0
+
+failed () {
+  echo "[error] $*"
+  status=1
+}
+
+# Simulate model '$1' with the options following it, check the witness and
+# compare it with the witness of the default simulation '$1.witnesssim'
+same_as_default () {
+  name=$1
+  shift
+  $BTORSIM "$@" $name.btor2 > $OUTDIR/$name.mode.witnesssim
+  $BTORSIM -c $name.btor2 $OUTDIR/$name.mode.witnesssim \
+    || failed "invalid witness of '$*' for $name"
+  cmp $OUTDIR/$name.witnesssim $OUTDIR/$name.mode.witnesssim \
+    || failed "witness of '$*' for $name differs from default simulation"
+}
+
+# Check that witness '$2' of model '$1' is valid
+valid () {
+  $BTORSIM -c $1.btor2 $2 || failed "invalid witness '$2' for $1"
+}
+
 mkdir -p $OUTDIR
 
 set -x
@@ -76,3 +100,181 @@ $BTORSIM -b 0 -r 999 ponylink-slaveTXlen-sat.btor2 > $OUTDIR/ponylink-slaveTXlen
 $BTORSIM      -c     ponylink-slaveTXlen-sat.btor2   $OUTDIR/ponylink-slaveTXlen.nowitnesssim || invalid
 # Check witness from model checker
 $BTORSIM      -c     ponylink-slaveTXlen-sat.btor2   $MCWITNESSDIR/ponylink-slaveTXlen.witnessmc
+
+
+### Cone-of-influence pruning
+# Simulation restricted to the cone of the faked property
+same_as_default count2          --coi -b 0 -r 20
+same_as_default count4          --coi -b 0 -r 20
+same_as_default twocount32      --coi -b 0 -r 20
+same_as_default noninitstate    --coi -b 0 -r 20 -s 1
+# Checking restricted to the cone of the claimed properties
+$BTORSIM --coi -c    factorial4even.btor2       $OUTDIR/factorial4even.witnesssim || failed "--coi -c factorial4even"
+$BTORSIM --coi -c    twocount2c.btor2           $OUTDIR/twocount2c.witnesssim     || failed "--coi -c twocount2c"
+
+### Event-driven simulation
+same_as_default count4          --event-driven -b 0 -r 20
+same_as_default factorial4even  --event-driven -b 0 -r 20
+same_as_default twocount2       --event-driven -b 0 -r 20
+same_as_default twocount32      --event-driven -b 0 -r 20
+same_as_default noninitstate    --event-driven -b 0 -r 20 -s 1
+$BTORSIM --event-driven -c twocount2c.btor2     $OUTDIR/twocount2c.witnesssim     || failed "--event-driven -c twocount2c"
+
+### Lazy simulation
+same_as_default count4          --lazy -b 0 -r 20
+same_as_default factorial4even  --lazy -b 0 -r 20
+same_as_default twocount2       --lazy -b 0 -r 20
+same_as_default twocount32      --lazy -b 0 -r 20
+same_as_default noninitstate    --lazy -b 0 -r 20 -s 1
+$BTORSIM --lazy -c   twocount2c.btor2           $OUTDIR/twocount2c.witnesssim     || failed "--lazy -c twocount2c"
+
+### Multi-lane simulation
+# A single lane simulates the same trace as the default simulation
+same_as_default count2          --lanes 1 -r 20
+same_as_default factorial4even  --lanes 1 -r 20
+same_as_default twocount32      --lanes 1 -r 20
+same_as_default noninitstate    --lanes 1 -r 20 -s 1
+# Lane <l> simulates the same trace as the default simulation with seed <l>
+$BTORSIM --lanes 4 -r 20 factorial4even.btor2 | \
+awk -v out=$OUTDIR/factorial4even.lane \
+  '/^sat$/ { lane = n++ } { print > (out lane ".witnesssim") }'
+for lane in 0 1 2 3
+do
+  $BTORSIM -b 0 -r 20 -s $lane factorial4even.btor2 > $OUTDIR/factorial4even.seed$lane.witnesssim
+  valid factorial4even $OUTDIR/factorial4even.lane$lane.witnesssim
+  cmp $OUTDIR/factorial4even.seed$lane.witnesssim $OUTDIR/factorial4even.lane$lane.witnesssim \
+    || failed "witness of lane $lane for factorial4even differs from default simulation"
+done
+
+### Simulation compiled to native code (cached in a private directory)
+mkdir -p -m 700 $OUTDIR/cache
+same_as_default count4          --compile --compile-dir $OUTDIR/cache -b 0 -r 20
+same_as_default factorial4even  --compile --compile-dir $OUTDIR/cache -b 0 -r 20
+same_as_default twocount2       --compile --compile-dir $OUTDIR/cache -b 0 -r 20
+same_as_default twocount32      --compile --compile-dir $OUTDIR/cache -b 0 -r 20
+same_as_default noninitstate    --compile --compile-dir $OUTDIR/cache -b 0 -r 20 -s 1
+# Again with the cached shared objects
+same_as_default count4          --compile --compile-dir $OUTDIR/cache -b 0 -r 20
+
+### Multi-threaded evaluation of steps
+same_as_default count4          --threads 2 -b 0 -r 20
+same_as_default factorial4even  --threads 2 -b 0 -r 20
+same_as_default twocount32      --threads 4 -b 0 -r 20
+same_as_default noninitstate    --threads 2 -b 0 -r 20 -s 1
+$BTORSIM --threads 2 -b 0 -r 999 ponylink-slaveTXlen-sat.btor2 | \
+cmp $OUTDIR/ponylink-slaveTXlen.nowitnesssim - \
+  || failed "trace of '--threads 2' for ponylink-slaveTXlen differs from default simulation"
+
+### Seed-parallel simulation
+# The first seed reaching the property is 1 for noninitstate and 11 for
+# twocount2c, which the default simulation used above
+same_as_default noninitstate    --seeds 0..7 -r 20
+same_as_default noninitstate    --seeds 0..7 --jobs 4 -r 20
+same_as_default twocount2c      --seeds 0..15 -r 20
+same_as_default twocount2c      --seeds 0..15 --jobs 4 -r 20
+
+### Random continuations of witnesses
+# Without inputs the continuation is the witness itself
+for name in count2 count4
+do
+  $BTORSIM --fork 3 -r 20 $name.btor2 $OUTDIR/$name.witnesssim > $OUTDIR/$name.fork.witnesssim
+  cmp $OUTDIR/$name.witnesssim $OUTDIR/$name.fork.witnesssim \
+    || failed "continuation of the witness for $name differs from it"
+done
+# Continuations reaching the property are valid witnesses
+rm -f $OUTDIR/noninitstate.fork*.witnesssim
+$BTORSIM --fork 2 --forks 4 -r 20 noninitstate.btor2 $OUTDIR/noninitstate.witnesssim | \
+awk -v out=$OUTDIR/noninitstate.fork \
+  '/^sat$/ { i = n++ } { print > (out i ".witnesssim") }'
+for witness in $OUTDIR/noninitstate.fork*.witnesssim
+do
+  valid noninitstate $witness
+done
+
+### Ternary simulation (which does not produce witnesses)
+# Without inputs and uninitialized states the property is definitely reached
+# at the last step of the witness of the default simulation
+for name in count2 count4
+do
+  step=`grep -c '^@' $OUTDIR/$name.witnesssim`
+  step=`expr $step - 1`
+  $BTORSIM --ternary -r 20 $name.btor2 > $OUTDIR/$name.ternary
+  grep "^b0 reached at step $step\$" $OUTDIR/$name.ternary \
+    || failed "ternary simulation of $name does not reach b0 at step $step"
+done
+# With unknown inputs and states it is only possibly reached
+$BTORSIM --ternary -r 20 noninitstate.btor2 > $OUTDIR/noninitstate.ternary
+grep "^b0 possibly reached" $OUTDIR/noninitstate.ternary \
+  || failed "ternary simulation of noninitstate does not possibly reach b0"
+
+### Breadth-first reachability
+# Without inputs the shortest witness is the one of the default simulation
+same_as_default count2          --bfs -r 20
+same_as_default count4          --bfs -r 20
+# Otherwise it is valid and not longer than the one of random simulation
+for name in factorial4even noninitstate twocount2 twocount2c twocount32
+do
+  $BTORSIM --bfs -r 20 $name.btor2 > $OUTDIR/$name.bfs.witnesssim
+  valid $name $OUTDIR/$name.bfs.witnesssim
+  if [ `grep -c '^@' $OUTDIR/$name.bfs.witnesssim` -gt `grep -c '^@' $OUTDIR/$name.witnesssim` ]
+  then
+    failed "breadth-first witness for $name longer than simulated witness"
+  fi
+done
+$BTORSIM --bfs --jobs 4 -r 20 twocount32.btor2 | cmp $OUTDIR/twocount32.bfs.witnesssim - \
+  || failed "breadth-first witness for twocount32 differs with '--jobs 4'"
+
+### Coverage-guided fuzzing
+# Without inputs the witness is the one of the default simulation
+same_as_default count2          --fuzz 1000 -r 20
+same_as_default count4          --fuzz 1000 -r 20
+# Otherwise it is valid and the same for the same seed
+for name in factorial4even noninitstate recount4 twocount2 twocount2c twocount32
+do
+  $BTORSIM --fuzz 1000 -r 20 $name.btor2 > $OUTDIR/$name.fuzz.witnesssim
+  grep '^sat$' $OUTDIR/$name.fuzz.witnesssim \
+    || failed "fuzzing $name does not reach a bad state property"
+  valid $name $OUTDIR/$name.fuzz.witnesssim
+  $BTORSIM --fuzz 1000 -r 20 $name.btor2 | cmp $OUTDIR/$name.fuzz.witnesssim - \
+    || failed "fuzzing $name again with the same seed gives another witness"
+done
+
+### Archive-based exploration
+# Without inputs the witness is the one of the default simulation
+same_as_default count2          --explore 1000 -r 20
+same_as_default count4          --explore 1000 -r 20
+# Otherwise it is valid and the same for the same seed
+for name in factorial4even twocount2 twocount2c twocount32
+do
+  $BTORSIM --explore 1000 --explore-steps 10 -r 20 $name.btor2 > $OUTDIR/$name.explore.witnesssim
+  grep '^sat$' $OUTDIR/$name.explore.witnesssim \
+    || failed "exploring $name does not reach a bad state property"
+  valid $name $OUTDIR/$name.explore.witnesssim
+  $BTORSIM --explore 1000 --explore-steps 10 -r 20 $name.btor2 | cmp $OUTDIR/$name.explore.witnesssim - \
+    || failed "exploring $name again with the same seed gives another witness"
+done
+
+### Resampling inputs violating constraints
+# Random simulation of twocount2c with seed 0 violates the constraint
+# (see above), with resampling it produces a valid witness
+$BTORSIM --resample 4 -b 0 -r 20 twocount2c.btor2 > $OUTDIR/twocount2c.resample.witnesssim
+grep '^sat$' $OUTDIR/twocount2c.resample.witnesssim \
+  || failed "resampling twocount2c does not produce a witness"
+valid twocount2c $OUTDIR/twocount2c.resample.witnesssim
+# The evaluation mode does not change the witness
+for mode in --event-driven --lazy "--compile --compile-dir $OUTDIR/cache" "--threads 2"
+do
+  $BTORSIM $mode --resample 4 -b 0 -r 20 twocount2c.btor2 | cmp $OUTDIR/twocount2c.resample.witnesssim - \
+    || failed "resampling twocount2c with '$mode' gives another witness"
+done
+# Continuations with resampling reaching the property are valid witnesses
+rm -f $OUTDIR/twocount2c.fork*.witnesssim
+$BTORSIM --resample 4 --fork 2 --forks 4 -r 20 twocount2c.btor2 $OUTDIR/twocount2c.witnesssim | \
+awk -v out=$OUTDIR/twocount2c.fork \
+  '/^sat$/ { i = n++ } { print > (out i ".witnesssim") }'
+for witness in $OUTDIR/twocount2c.fork*.witnesssim
+do
+  valid twocount2c $witness
+done
+
+exit $status
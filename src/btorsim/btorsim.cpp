@@ -14,25 +14,40 @@
 
 #include <assert.h>
 #include <ctype.h>
+#include <errno.h>
 #include <inttypes.h>
 #include <limits.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "btor2parser/btor2parser.h"
+#include "btorsimbfs.h"
+#include "btorsimexplore.h"
+#include "btorsimfuzz.h"
 #include "btorsimbv.h"
+#include "btorsimengine.h"
+#include "btorsimnative.h"
 #include "btorsimrng.h"
+#include "btorsimserver.h"
 #include "btorsimstate.h"
+#include "btorsimtape.h"
+#include "btorsimthreads.h"
 #include "btorsimvcd.h"
+#include "btorsimxbv.h"
 
 /*------------------------------------------------------------------------*/
 
-int32_t verbosity;
 static bool print_states;
 
 static const char *usage =
@@ -55,6 +70,75 @@ static const char *usage =
     "                           module path in VCD\n"
     "  --info <file>            read additional information for clocks and\n"
     "                           top module name from <file>\n"
+    "  --coi                    only simulate the cone of influence of the\n"
+    "                           claimed (checking mode) or faked ('-b')\n"
+    "                           bad state property (default all), of\n"
+    "                           constraints and of printed signals\n"
+    "  --event-driven           only re-evaluate the fan-out of inputs and\n"
+    "                           states that changed since the previous step\n"
+    "  --lazy                   only evaluate nodes whose values are needed,\n"
+    "                           e.g. only the selected branch of 'ite'\n"
+    "  --lanes <n>              simulate <n> random traces at once, lane <l>\n"
+    "                           uses random seed <s> + <l>, and only print\n"
+    "                           witnesses of lanes reaching bad states\n"
+    "  --compile                compile the model to native code with the C\n"
+    "                           compiler '$CC' (default 'cc'), operators on\n"
+    "                           arrays and bit-vectors wider than 64 bits\n"
+    "                           are still interpreted\n"
+    "  --compile-dir <dir>      cache compiled models in <dir>, which must\n"
+    "                           be owned by and only writable by the user\n"
+    "                           (default '$XDG_CACHE_HOME/btorsim' or\n"
+    "                           '$HOME/.cache/btorsim')\n"
+    "  --threads <n>            evaluate large combinational levels of the\n"
+    "                           model with <n> threads\n"
+    "  --seeds <a>..<b>         simulate random seeds <a> to <b> and only\n"
+    "                           print the witness of the first seed reaching\n"
+    "                           bad states\n"
+    "  --jobs <n>               simulate <n> seeds at once or expand states\n"
+    "                           with <n> threads in '--bfs' (default 1)\n"
+    "  --resample <n>           draw inputs in the cone of a violated\n"
+    "                           constraint again, up to <n> times per step,\n"
+    "                           before giving up on the step (in random\n"
+    "                           simulation and continuations of '--fork')\n"
+    "  --fork <n>               check <witness> up to step <n> and simulate\n"
+    "                           random continuations of '-r' steps from\n"
+    "                           there, continuation <i> uses random seed\n"
+    "                           <s> + <i>, and only print witnesses of\n"
+    "                           continuations reaching bad states\n"
+    "  --forks <k>              number of continuations of '--fork'\n"
+    "                           (default 1)\n"
+    "  --server                 parse <btor> once and answer simulation\n"
+    "                           requests on '<stdin>' (see 'btorsimserver.h')\n"
+    "  --socket <path>          serve clients on the Unix domain socket\n"
+    "                           <path> instead (implies '--server'), which\n"
+    "                           only the owner can connect to since clients\n"
+    "                           can check witness files of the owner\n"
+    "  --ternary                simulate '-r' steps with unknown (X) inputs\n"
+    "                           and uninitialized states, report which bad\n"
+    "                           state properties are definitely, possibly\n"
+    "                           or not reached and which state bits stay X\n"
+    "  --bfs                    explore all states reachable within '-r'\n"
+    "                           steps breadth-first and print a shortest\n"
+    "                           witness of the first bad state property\n"
+    "                           reached\n"
+    "  --bfs-choices <n>        enumerate inputs (and uninitialized states)\n"
+    "                           of at most <n> bits, otherwise draw 2^<n>\n"
+    "                           random values with seed <s> (default 12)\n"
+    "  --bfs-memory <MB>        switch to bitstate hashing once visited\n"
+    "                           states take more than <MB> MB (default 1024)\n"
+    "  --fuzz <n>               mutate inputs of up to <n> runs of '-r' steps\n"
+    "                           guided by coverage (with seed <s>) and print\n"
+    "                           the witness of the first run reaching bad\n"
+    "                           state properties\n"
+    "  --explore <n>            restore <n> times a rarely visited state from\n"
+    "                           an archive of distinct states seen so far and\n"
+    "                           simulate randomly from there, up to bound\n"
+    "                           '-r' (with seed <s>), and print the witness\n"
+    "                           from step 0 of the first bad state reached\n"
+    "  --explore-steps <m>      simulate up to <m> steps after restoring a\n"
+    "                           state in '--explore' (default 100)\n"
+    "  --archive <n>            keep at most <n> states in the archive of\n"
+    "                           '--explore' (default 10000)\n"
     "\n"
     "and '<btor>' is sequential model in 'BTOR' format\n"
     "and '<witness>' a trace in 'BTOR' witness format.\n"
@@ -71,8 +155,35 @@ static FILE *witness_file;
 static int32_t close_model_file;
 static int32_t close_witness_file;
 
-static bool dump_vcd   = false;
-static bool symbol_fmt = false;
+static bool dump_vcd     = false;
+static bool symbol_fmt   = false;
+static bool coi_mode     = false;
+static bool event_driven = false;
+static bool lazy         = false;
+static int32_t lanes     = 0;
+static bool compile_mode = false;
+static const char *compile_dir;
+static int32_t threads   = 0;
+static BtorSimThreadPool *pool;
+static bool seeds        = false;
+static int32_t jobs      = 0;
+static int32_t first_seed;
+static int32_t last_seed;
+static int64_t fork_step = -1;
+static int32_t forks     = 0;
+static int32_t fork_bound;
+static uint32_t fork_seed;
+static bool server_mode  = false;
+static const char *socket_path;
+static bool ternary      = false;
+static bool bfs          = false;
+static int32_t bfs_choices = 12;
+static int32_t bfs_memory  = 1024;
+static int32_t fuzz_runs   = 0;
+static int32_t explorations  = 0;
+static int32_t explore_steps = 100;
+static int32_t archive_size  = 10000;
+static int32_t resample      = 0;
 #ifdef NDEBUG
 static const bool readable_vcd = false;
 #else
@@ -103,6 +214,18 @@ parse_int (const char *str, int32_t *res_ptr)
   return 1;
 }
 
+/* parse a seed range '<a>..<b>' */
+static int32_t
+parse_range (const char *str, int32_t *first_ptr, int32_t *last_ptr)
+{
+  const char *dots = strstr (str, "..");
+  if (!dots) return 0;
+  std::string first (str, dots - str);
+  if (!parse_int (first.c_str (), first_ptr)) return 0;
+  if (!parse_int (dots + 2, last_ptr)) return 0;
+  return *first_ptr <= *last_ptr;
+}
+
 static int32_t
 parse_long (const char *str, int64_t *res_ptr)
 {
@@ -127,1038 +250,1065 @@ parse_long (const char *str, int64_t *res_ptr)
 static int32_t checking_mode = 0;
 static int32_t random_mode   = 0;
 
-static Btor2Parser *model;
+static BtorSimModel model;
 
-static std::vector<Btor2Line *> inputs;
-static std::vector<Btor2Line *> states;
-static std::vector<Btor2Line *> bads;
-static std::vector<Btor2Line *> constraints;
-static std::vector<Btor2Line *> justices;
-
-static std::vector<int64_t> reached_bads;
-
-static int64_t constraints_violated = -1;
-static int64_t num_unreached_bads;
+/* The simulation of the current thread, such that '--seeds' can simulate
+ * several seeds at once, sharing only the model (read-only).  Other threads
+ * start with verbosity 0. */
+static thread_local BtorSim *sim;
 
 static std::map<int64_t, std::string> extra_constraints;
 
-static int64_t num_format_lines;
-static std::vector<Btor2Line *> inits;
-static std::vector<Btor2Line *> nexts;
-
-static std::vector<BtorSimState> current_state;
-static std::vector<BtorSimState> next_state;
+/* number of evaluated steps (several per step if inputs are resampled) and
+ * instructions computed in event-driven or lazy mode */
+static int64_t num_steps;
+static int64_t num_evaluated;
+
+/* With '--resample': the positions of the inputs in the combinational cone
+ * of every constraint (computed on first use), the number of times inputs
+ * were drawn and satisfied all constraints, and the number of steps given
+ * up on. */
+static std::vector<std::vector<size_t>> constraint_inputs;
+static bool collected_constraint_inputs;
+static int64_t num_draws;
+static int64_t num_accepted_draws;
+static int64_t num_given_up;
+
+/* with '--threads' and '-v': seconds spent evaluating steps with all threads,
+ * and for comparison serially in the first steps */
+#define BTORSIM_SERIAL_TIMED_STEPS 8
+static double parallel_seconds;
+static double serial_seconds;
+static int64_t num_parallel_steps;
+static int64_t num_serial_steps;
+
+static thread_local bool print_trace = true;
+/* traces are printed to 'stdout' except while '--fork' captures them */
+static FILE *trace_file = stdout;
 
 static void
-parse_model_line (Btor2Line *l)
+print_state_or_input (int64_t id, int64_t pos, int64_t step, bool is_input)
 {
-  switch (l->tag)
+  Btor2Line *l = btor2parser_get_line_by_id (model.parser, id);
+  switch (sim->current_state[id].type)
   {
-    case BTOR2_TAG_bad: {
-      int64_t i = (int64_t) bads.size ();
-      msg (2, "bad %" PRId64 " at line %" PRId64, i, l->lineno);
-      bads.push_back (l);
-      reached_bads.push_back (-1);
-      num_unreached_bads++;
-    }
-    break;
-
-    case BTOR2_TAG_constraint: {
-      int64_t i = (int64_t) constraints.size ();
-      msg (2, "constraint %" PRId64 " at line %" PRId64, i, l->lineno);
-      constraints.push_back (l);
-    }
-    break;
-
-    case BTOR2_TAG_init: inits[l->args[0]] = l; break;
-
-    case BTOR2_TAG_input: {
-      int64_t i = (int64_t) inputs.size ();
-      if (l->symbol)
-        msg (2,
-             "input %" PRId64 " '%s' at line %" PRId64,
-             i,
-             l->symbol,
-             l->lineno);
-      else
-        msg (2, "input %" PRId64 " at line %" PRId64, i, l->lineno);
-      inputs.push_back (l);
-    }
-    break;
-
-    case BTOR2_TAG_next: nexts[l->args[0]] = l; break;
-
-    case BTOR2_TAG_sort: {
-      switch (l->sort.tag)
-      {
-        case BTOR2_TAG_SORT_bitvec:
-          msg (2,
-               "sort bitvec %u at line %" PRId64,
-               l->sort.bitvec.width,
-               l->lineno);
-          break;
-        case BTOR2_TAG_SORT_array:
-          msg (2,
-               "sort array %u %u at line %" PRId64,
-               l->sort.array.index,
-               l->sort.array.element,
-               l->lineno);
-          break;
-        default:
-          die ("parse error in '%s' at line %" PRId64 ": unsupported sort '%s'",
-               model_path,
-               l->lineno,
-               l->sort.name);
-          break;
-      }
+    case BtorSimState::Type::BITVEC:
+    {
+      std::string value;
+      sim->current_state[id].append_to_string (value);
+      fprintf (trace_file, "%" PRId64 " %s", pos, value.c_str ());
     }
-    break;
-
-    case BTOR2_TAG_state: {
-      int64_t i = (int64_t) states.size ();
       if (l->symbol)
+        fprintf (trace_file,
+                 " %s%s%" PRId64,
+                 l->symbol,
+                 is_input ? "@" : "#",
+                 step);
+      fputc ('\n', trace_file);
+      break;
+    case BtorSimState::Type::ARRAY:
+      for (auto e : sim->current_state[id].array_state->data)
       {
-        msg (2,
-             "state %" PRId64 " '%s' at line %" PRId64,
-             i,
-             l->symbol,
-             l->lineno);
-      }
-      else
-      {
-        msg (2, "state %" PRId64 " at line %" PRId64, i, l->lineno);
+        fprintf (trace_file, "%" PRId64 " [%s]", pos, e.first.c_str ());
+        btorsim_bv_fprint_without_new_line (trace_file, e.second);
+        if (l->symbol)
+          fprintf (trace_file,
+                   " %s%s%" PRId64,
+                   l->symbol,
+                   is_input ? "@" : "#",
+                   step);
+        fputc ('\n', trace_file);
       }
-      states.push_back (l);
-    }
-    break;
-
-    case BTOR2_TAG_add:
-    case BTOR2_TAG_and:
-    case BTOR2_TAG_concat:
-    case BTOR2_TAG_const:
-    case BTOR2_TAG_constd:
-    case BTOR2_TAG_consth:
-    case BTOR2_TAG_dec:
-    case BTOR2_TAG_eq:
-    case BTOR2_TAG_implies:
-    case BTOR2_TAG_inc:
-    case BTOR2_TAG_ite:
-    case BTOR2_TAG_iff:
-    case BTOR2_TAG_mul:
-    case BTOR2_TAG_nand:
-    case BTOR2_TAG_neg:
-    case BTOR2_TAG_neq:
-    case BTOR2_TAG_nor:
-    case BTOR2_TAG_not:
-    case BTOR2_TAG_one:
-    case BTOR2_TAG_ones:
-    case BTOR2_TAG_or:
-    case BTOR2_TAG_output:
-    case BTOR2_TAG_redand:
-    case BTOR2_TAG_redor:
-    case BTOR2_TAG_redxor:
-    case BTOR2_TAG_rol:
-    case BTOR2_TAG_ror:
-    case BTOR2_TAG_sdiv:
-    case BTOR2_TAG_sext:
-    case BTOR2_TAG_sgt:
-    case BTOR2_TAG_sgte:
-    case BTOR2_TAG_slice:
-    case BTOR2_TAG_sll:
-    case BTOR2_TAG_slt:
-    case BTOR2_TAG_slte:
-    case BTOR2_TAG_smod:
-    case BTOR2_TAG_sra:
-    case BTOR2_TAG_srem:
-    case BTOR2_TAG_srl:
-    case BTOR2_TAG_sub:
-    case BTOR2_TAG_udiv:
-    case BTOR2_TAG_uext:
-    case BTOR2_TAG_ugt:
-    case BTOR2_TAG_ugte:
-    case BTOR2_TAG_ult:
-    case BTOR2_TAG_ulte:
-    case BTOR2_TAG_urem:
-    case BTOR2_TAG_xnor:
-    case BTOR2_TAG_xor:
-    case BTOR2_TAG_zero:
-    case BTOR2_TAG_read:
-    case BTOR2_TAG_write: break;
-
-    case BTOR2_TAG_fair:
-    case BTOR2_TAG_justice:
-    case BTOR2_TAG_saddo:
-    case BTOR2_TAG_sdivo:
-    case BTOR2_TAG_smulo:
-    case BTOR2_TAG_ssubo:
-    case BTOR2_TAG_uaddo:
-    case BTOR2_TAG_umulo:
-    case BTOR2_TAG_usubo:
-    default:
-      die ("parse error in '%s' at line %" PRId64 ": unsupported '%" PRId64
-           " %s%s'",
-           model_path,
-           l->lineno,
-           l->id,
-           l->name,
-           l->nargs ? " ..." : "");
       break;
+    default: die ("uninitialized current_state %" PRId64, id);
   }
 }
 
 static void
-parse_model ()
+initialize_inputs (int64_t k, int32_t randomize)
 {
-  assert (model_file);
-  model = btor2parser_new ();
-  if (!btor2parser_read_lines (model, model_file))
-    die ("parse error in '%s' at %s", model_path, btor2parser_error (model));
-  num_format_lines = btor2parser_max_id (model);
-  inits.resize (num_format_lines, nullptr);
-  nexts.resize (num_format_lines, nullptr);
-  Btor2LineIterator it = btor2parser_iter_init (model);
-  Btor2Line *line;
-  while ((line = btor2parser_iter_next (&it))) parse_model_line (line);
+  msg (1, "initializing inputs @%" PRId64, k);
+  if (print_trace) fprintf (trace_file, "@%" PRId64 "\n", k);
+  for (size_t i = 0; i < model.inputs.size (); i++)
+  {
+    // if not set previously by parse_input_part from witness
+    sim->initialize_input (i, randomize);
+    if (print_trace) print_state_or_input (model.inputs[i]->id, i, k, true);
+  }
+}
+
+static void
+initialize_states (int32_t randomly)
+{
+  msg (1, "initializing states at #0");
+  if (print_trace) fputs ("#0\n", trace_file);
+  for (size_t i = 0; i < model.states.size (); i++)
+  {
+    // can be set in parse_state_part from witness
+    sim->initialize_state (i, randomly);
+    Btor2Line *state = model.states[i];
+    if (print_trace && !model.inits[state->id])
+      print_state_or_input (state->id, i, 0, false);
+  }
+}
 
-  for (size_t i = 0; i < states.size (); i++)
+/* Compile the (pruned) step program to native code at its first execution,
+ * after the values of constants are known.  Falls back to interpretation if
+ * compiling it fails. */
+static bool
+load_native ()
+{
+  std::string src;
+  model.tape.emit_native (sim->current_state, src);
+  BtorSimNativeStep fn = btorsim_native_load (src, compile_dir);
+  if (!fn)
   {
-    Btor2Line *state = states[i];
-    if (!nexts[state->id])
+    msg (1, "compiling model failed, interpreting it");
+    compile_mode = false;
+    return false;
+  }
+  model.tape.set_native (fn);
+  return true;
+}
+
+/* Evaluate the step program on the current inputs and states. */
+static void
+execute_step ()
+{
+  BtorSimTape &tape = model.tape;
+  if (event_driven || lazy)
+  {
+    size_t n = event_driven ? tape.execute_incremental (sim->current_state)
+                            : tape.execute_lazy (sim->current_state);
+    msg (1,
+         "evaluated %zu of %zu instructions (activity factor %.3f)",
+         n,
+         tape.size (),
+         tape.size () ? n / (double) tape.size () : 0.0);
+    num_steps++;
+    num_evaluated += n;
+  }
+  else if (compile_mode && (tape.has_native () || load_native ()))
+    tape.execute_native (sim->current_state);
+  else if (pool && verbosity)
+  {
+    using clock = std::chrono::steady_clock;
+    if (num_serial_steps < BTORSIM_SERIAL_TIMED_STEPS)
     {
-      msg (1, "state %d without next function", state->id);
+      auto start = clock::now ();
+      tape.execute (sim->current_state);
+      serial_seconds +=
+          std::chrono::duration<double> (clock::now () - start).count ();
+      num_serial_steps++;
     }
+    auto start = clock::now ();
+    tape.execute_parallel (sim->current_state, *pool);
+    parallel_seconds +=
+        std::chrono::duration<double> (clock::now () - start).count ();
+    num_parallel_steps++;
   }
+  else if (pool)
+    tape.execute_parallel (sim->current_state, *pool);
+  else
+    sim->execute ();
 }
 
+/* Compute next states and check properties of the evaluated step 'k'. */
 static void
-update_current_state (int64_t id, BtorSimBitVector *bv)
+finish_step (int64_t k, int32_t randomize_states_that_are_inputs)
 {
-  assert (0 <= id), assert (id < num_format_lines);
-  msg (5, "updating state %" PRId64, id);
-  current_state[id].update (bv);
+  sim->update_next_states (randomize_states_that_are_inputs);
+  sim->check_properties (k);
+
+  /* Check additional bads from info file */
+  for (auto it : extra_constraints)
+  {
+    BtorSimState s = sim->current_state[it.first];
+    assert (s.type == BtorSimState::Type::BITVEC);
+    if (s.is_zero ()) continue;
+    printf ("[btorsim] Assert failed in test: %s (step %" PRId64 ")\n",
+            it.second.c_str (),
+            k);
+  }
+
+  if (dump_vcd)
+  {
+    for (int i = 0; i < model.num_format_lines; i++)
+    {
+      Btor2Line *l = btor2parser_get_line_by_id (model.parser, i);
+      if (!l) continue;
+      // these are not signals
+      if (l->tag == BTOR2_TAG_sort || l->tag == BTOR2_TAG_init
+          || l->tag == BTOR2_TAG_next || l->tag == BTOR2_TAG_bad
+          || l->tag == BTOR2_TAG_constraint || l->tag == BTOR2_TAG_fair
+          || l->tag == BTOR2_TAG_justice)
+        continue;
+      // only add named signals
+      if (!l->symbol) continue;
+      vcd_writer->add_value_change (k, i, sim->current_state[i]);
+    }
+  }
 }
 
 static void
-update_current_state (int64_t id, BtorSimArrayModel *am)
+simulate_step (int64_t k, int32_t randomize_states_that_are_inputs)
 {
-  assert (0 <= id), assert (id < num_format_lines);
-  msg (5, "updating state %" PRId64, id);
-  current_state[id].update (am);
+  msg (1, "simulating step %" PRId64, k);
+  execute_step ();
+  finish_step (k, randomize_states_that_are_inputs);
 }
 
+/* Threads only take over committing next states (which frees the values of
+ * the current states) if there are at least this many states. */
+#define BTORSIM_PARALLEL_MIN_STATES 4096
+
 static void
-update_current_state (int64_t id, BtorSimState &s)
+transition (int64_t k)
 {
-  assert (0 <= id), assert (id < num_format_lines);
-  msg (5, "updating state %" PRId64, id);
-  current_state[id].update (s);
+  msg (1, "transition %" PRId64, k);
+  sim->delete_inputs ();
+  if (pool && model.states.size () >= BTORSIM_PARALLEL_MIN_STATES
+      && !(print_trace && print_states))
+  {
+    sim->commit_next_states (pool);
+    return;
+  }
+  if (print_trace && print_states) fprintf (trace_file, "#%" PRId64 "\n", k);
+  for (size_t i = 0; i < model.states.size (); i++)
+  {
+    sim->commit_next_state (i);
+    if (print_trace && print_states)
+      print_state_or_input (model.states[i]->id, i, k, false);
+  }
 }
 
 static void
-delete_current_state (int64_t id)
+report_resampling ()
 {
-  assert (0 <= id), assert (id < num_format_lines);
-  if (current_state[id].type) current_state[id].remove ();
+  if (!num_draws) return;
+  msg (1,
+       "%" PRId64 " of %" PRId64
+       " input draws satisfied all constraints (acceptance rate %.3f), "
+       "gave up on %" PRId64 " steps",
+       num_accepted_draws,
+       num_draws,
+       num_accepted_draws / (double) num_draws,
+       num_given_up);
 }
 
-static BtorSimState
-simulate (int64_t id)
+static void
+report ()
 {
-  int32_t sign = id < 0 ? -1 : 1;
-  if (sign < 0) id = -id;
-  assert (0 <= id), assert (id < num_format_lines);
-  BtorSimState res = current_state[id];
-  if (!res.is_set ())
-  {
-    Btor2Line *l = btor2parser_get_line_by_id (model, id);
-    if (!l) die ("internal error: unexpected empty ID %" PRId64, id);
-    BtorSimState args[3];
-    for (uint32_t i = 0; i < l->nargs; i++) args[i] = simulate (l->args[i]);
-    switch (l->tag)
-    {
-      case BTOR2_TAG_add:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_add (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_and:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_and (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_concat:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_concat (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_const:
-        assert (l->nargs == 0);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_char_to_bv (l->constant);
-        break;
-      case BTOR2_TAG_constd:
-        assert (l->nargs == 0);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_constd (l->constant, l->sort.bitvec.width);
-        break;
-      case BTOR2_TAG_consth:
-        assert (l->nargs == 0);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_consth (l->constant, l->sort.bitvec.width);
-        break;
-      case BTOR2_TAG_dec:
-        assert (l->nargs == 1);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_dec (args[0].bv_state);
-        break;
-      case BTOR2_TAG_eq:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        if (args[0].type == BtorSimState::Type::ARRAY)
-        {
-          assert (args[1].type == BtorSimState::Type::ARRAY);
-          res.bv_state =
-              btorsim_am_eq (args[0].array_state, args[1].array_state);
-        }
-        else
-        {
-          assert (args[0].type == BtorSimState::Type::BITVEC);
-          assert (args[1].type == BtorSimState::Type::BITVEC);
-          res.bv_state = btorsim_bv_eq (args[0].bv_state, args[1].bv_state);
-        }
-        break;
-      case BTOR2_TAG_implies:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_implies (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_inc:
-        assert (l->nargs == 1);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_inc (args[0].bv_state);
-        break;
-      case BTOR2_TAG_ite:
-        assert (l->nargs == 3);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        if (res.type == BtorSimState::Type::ARRAY)
-        {
-          assert (args[1].type == BtorSimState::Type::ARRAY);
-          assert (args[2].type == BtorSimState::Type::ARRAY);
-          res.array_state = btorsim_am_ite (
-              args[0].bv_state, args[1].array_state, args[2].array_state);
-        }
-        else
-        {
-          assert (args[1].type == BtorSimState::Type::BITVEC);
-          assert (args[2].type == BtorSimState::Type::BITVEC);
-          res.bv_state = btorsim_bv_ite (
-              args[0].bv_state, args[1].bv_state, args[2].bv_state);
-        }
-        break;
-      case BTOR2_TAG_mul:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_mul (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_nand:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_nand (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_neg:
-        assert (l->nargs == 1);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_neg (args[0].bv_state);
-        break;
-      case BTOR2_TAG_neq:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        if (args[0].type == BtorSimState::Type::ARRAY)
-        {
-          assert (args[1].type == BtorSimState::Type::ARRAY);
-          res.bv_state =
-              btorsim_am_neq (args[0].array_state, args[1].array_state);
-        }
-        else
-        {
-          assert (args[0].type == BtorSimState::Type::BITVEC);
-          assert (args[1].type == BtorSimState::Type::BITVEC);
-          res.bv_state = btorsim_bv_neq (args[0].bv_state, args[1].bv_state);
-        }
-        break;
-      case BTOR2_TAG_nor:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_nor (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_not:
-        assert (l->nargs == 1);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_not (args[0].bv_state);
-        break;
-      case BTOR2_TAG_one:
-        assert (res.type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_one (l->sort.bitvec.width);
-        break;
-      case BTOR2_TAG_ones:
-        assert (res.type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_ones (l->sort.bitvec.width);
-        break;
-      case BTOR2_TAG_or:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_or (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_redand:
-        assert (l->nargs == 1);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_redand (args[0].bv_state);
-        break;
-      case BTOR2_TAG_redor:
-        assert (l->nargs == 1);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_redor (args[0].bv_state);
-        break;
-      case BTOR2_TAG_redxor:
-        assert (l->nargs == 1);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_redxor (args[0].bv_state);
-        break;
-      case BTOR2_TAG_rol:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_rol (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_ror:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_ror (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_slice:
-        assert (l->nargs == 1);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        res.bv_state =
-            btorsim_bv_slice (args[0].bv_state, l->args[1], l->args[2]);
-        break;
-      case BTOR2_TAG_sub:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_sub (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_uext:
-        assert (l->nargs == 1);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        {
-          uint32_t width = args[0].bv_state->width;
-          assert (width <= l->sort.bitvec.width);
-          uint32_t padding = l->sort.bitvec.width - width;
-          if (padding)
-            res.bv_state = btorsim_bv_uext (args[0].bv_state, padding);
-          else
-            res.bv_state = btorsim_bv_copy (args[0].bv_state);
-        }
-        break;
-      case BTOR2_TAG_udiv:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_udiv (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_sdiv:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_sdiv (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_sext:
-        assert (l->nargs == 1);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        {
-          uint32_t width = args[0].bv_state->width;
-          assert (width <= l->sort.bitvec.width);
-          uint32_t padding = l->sort.bitvec.width - width;
-          if (padding)
-            res.bv_state = btorsim_bv_sext (args[0].bv_state, padding);
-          else
-            res.bv_state = btorsim_bv_copy (args[0].bv_state);
-        }
-        break;
-      case BTOR2_TAG_sll:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_sll (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_smod:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_smod (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_srl:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_srl (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_sra:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_sra (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_srem:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_srem (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_ugt:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_ult (args[1].bv_state, args[0].bv_state);
-        break;
-      case BTOR2_TAG_ugte:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_ulte (args[1].bv_state, args[0].bv_state);
-        break;
-      case BTOR2_TAG_ult:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC),
-            assert (args[0].type == BtorSimState::Type::BITVEC),
-            assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_ult (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_ulte:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_ulte (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_urem:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_urem (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_sgt:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_slt (args[1].bv_state, args[0].bv_state);
-        break;
-      case BTOR2_TAG_sgte:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_slte (args[1].bv_state, args[0].bv_state);
-        break;
-      case BTOR2_TAG_slt:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_slt (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_slte:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_slte (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_iff:
-      case BTOR2_TAG_xnor:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_xnor (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_xor:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::BITVEC);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_xor (args[0].bv_state, args[1].bv_state);
-        break;
-      case BTOR2_TAG_zero:
-        assert (res.type == BtorSimState::Type::BITVEC);
-        res.bv_state = btorsim_bv_zero (l->sort.bitvec.width);
-        break;
-      case BTOR2_TAG_read:
-        assert (l->nargs == 2);
-        assert (res.type == BtorSimState::Type::BITVEC);
-        assert (args[0].type == BtorSimState::Type::ARRAY);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        res.bv_state = args[0].array_state->read (args[1].bv_state);
-        {
-          Btor2Line *mem = btor2parser_get_line_by_id (model, l->args[0]);
-          msg (4,
-               "read %s[%s] -> %s",
-               mem->symbol ? mem->symbol : std::to_string (mem->id).c_str (),
-               btorsim_bv_to_string (args[1].bv_state).c_str (),
-               btorsim_bv_to_string (res.bv_state).c_str ());
-        }
-        break;
-      case BTOR2_TAG_write:
-        assert (l->nargs == 3);
-        assert (res.type == BtorSimState::Type::ARRAY);
-        assert (args[0].type == BtorSimState::Type::ARRAY);
-        assert (args[1].type == BtorSimState::Type::BITVEC);
-        assert (args[2].type == BtorSimState::Type::BITVEC);
-        res.array_state =
-            args[0].array_state->write (args[1].bv_state, args[2].bv_state);
-        {
-          Btor2Line *mem = btor2parser_get_line_by_id (model, l->args[0]);
-          msg (4,
-               "write %s[%s] <- %s",
-               mem->symbol ? mem->symbol : std::to_string (mem->id).c_str (),
-               btorsim_bv_to_string (args[1].bv_state).c_str (),
-               btorsim_bv_to_string (args[2].bv_state).c_str ());
-        }
-        break;
-      default:
-        die ("can not randomly simulate operator '%s' at line %" PRId64,
-             l->name,
-             l->lineno);
-        break;
+  bool reached = false;
+  for (int64_t r : sim->reached_bads) reached |= r >= 0;
+  if (verbosity && reached)
+  {
+    printf ("[btorsim] reached bad state properties {");
+    for (size_t i = 0; i < model.bads.size (); i++)
+    {
+      int64_t r = sim->reached_bads[i];
+      if (r >= 0) printf (" b%lu@%" PRId64, i, r);
     }
-    for (uint32_t i = 0; i < l->nargs; i++) args[i].remove ();
-    update_current_state (id, res);
+    printf (" }\n");
   }
-  if (res.type == BtorSimState::Type::ARRAY)
+  else if (!model.bads.empty ())
+    msg (1, "no bad state property reached");
+
+  if ((event_driven || lazy) && num_steps && model.tape.size ())
+    msg (1,
+         "average activity factor %.3f over %" PRId64 " evaluated steps",
+         num_evaluated / (double) (num_steps * model.tape.size ()),
+         num_steps);
+
+  if (num_serial_steps && num_parallel_steps)
   {
-    res.array_state = res.array_state->copy ();
+    double serial   = serial_seconds / num_serial_steps;
+    double parallel = parallel_seconds / num_parallel_steps;
+    msg (1,
+         "evaluated steps in %.6f seconds serially and in %.6f seconds with "
+         "'--threads %u' on average (speedup %.2f)",
+         serial,
+         parallel,
+         pool->size (),
+         parallel ? serial / parallel : 0.0);
   }
+
+  report_resampling ();
+
+  if (sim->constraints_violated >= 0)
+    msg (1, "constraints violated at time %" PRId64, sim->constraints_violated);
+  else if (!model.constraints.empty ())
+    msg (1, "constraints always satisfied");
+}
+
+/* Restrict simulation to the cone of influence of the given bad state
+ * properties (all if empty), constraints and the signals that are printed or
+ * checked.  The values of states outside of the cone are not updated. */
+static void
+prune_to_coi (const std::vector<int64_t> &selected_bads)
+{
+  std::vector<int64_t> roots;
+  if (selected_bads.empty ())
+    for (auto bad : model.bads) roots.push_back (bad->id);
   else
+    for (int64_t i : selected_bads) roots.push_back (model.bads[i]->id);
+  for (auto constraint : model.constraints) roots.push_back (constraint->id);
+  for (auto it : extra_constraints) roots.push_back (it.first);
+  if (print_states)
+    for (auto state : model.states) roots.push_back (state->id);
+  if (dump_vcd)
   {
-    assert (res.type == BtorSimState::Type::BITVEC);
-    if (sign < 0)
-      res.bv_state = btorsim_bv_not (res.bv_state);
-    else
-      res.bv_state = btorsim_bv_copy (res.bv_state);
+    for (int64_t i = 0; i < model.num_format_lines; i++)
+    {
+      Btor2Line *l = btor2parser_get_line_by_id (model.parser, i);
+      if (l && l->symbol && l->tag != BTOR2_TAG_sort) roots.push_back (i);
+    }
   }
-  return res;
+  model.prune (roots);
+  sim->num_unreached_bads = model.num_simulated_bads;
 }
 
-static bool print_trace = true;
-static BtorSimRNG rng;
+/* With '--seeds': the smallest seed found so far whose simulation reached a
+ * bad state property, and the seed simulated by the current thread (-1
+ * otherwise), whose simulation is cancelled if it is larger. */
+static std::atomic<int64_t> first_hit_seed (INT64_MAX);
+static thread_local int64_t simulated_seed = -1;
 
 static void
-print_state_or_input (int64_t id, int64_t pos, int64_t step, bool is_input)
+collect_constraint_inputs ()
 {
-  Btor2Line *l = btor2parser_get_line_by_id (model, id);
-  switch (current_state[id].type)
+  std::vector<int64_t> input_pos (model.num_format_lines, -1);
+  for (size_t i = 0; i < model.inputs.size (); i++)
+    input_pos[model.inputs[i]->id] = i;
+  for (auto constraint : model.constraints)
   {
-    case BtorSimState::Type::BITVEC:
-      printf ("%" PRId64 " ", pos);
-      btorsim_bv_print_without_new_line (current_state[id].bv_state);
-      if (l->symbol)
-        printf (" %s%s%" PRId64, l->symbol, is_input ? "@" : "#", step);
-      fputc ('\n', stdout);
-      break;
-    case BtorSimState::Type::ARRAY:
-      for (auto e : current_state[id].array_state->data)
-      {
-        printf ("%" PRId64 " [%s]", pos, e.first.c_str ());
-        btorsim_bv_print_without_new_line (e.second);
-        if (l->symbol)
-          printf (" %s%s%" PRId64, l->symbol, is_input ? "@" : "#", step);
-        fputc ('\n', stdout);
-      }
-      break;
-    default: die ("uninitialized current_state %" PRId64, id);
+    std::vector<size_t> inputs;
+    std::vector<bool> visited (model.num_format_lines);
+    std::vector<int64_t> stack = {std::abs (constraint->args[0])};
+    while (!stack.empty ())
+    {
+      int64_t id = stack.back ();
+      stack.pop_back ();
+      if (visited[id]) continue;
+      visited[id]  = true;
+      Btor2Line *l = btor2parser_get_line_by_id (model.parser, id);
+      if (l->tag == BTOR2_TAG_input) inputs.push_back (input_pos[id]);
+      if (l->tag == BTOR2_TAG_input || l->tag == BTOR2_TAG_state) continue;
+      for (uint32_t i = 0; i < l->nargs; i++)
+        stack.push_back (std::abs (l->args[i]));
+    }
+    std::sort (inputs.begin (), inputs.end ());
+    constraint_inputs.push_back (inputs);
   }
+  collected_constraint_inputs = true;
 }
 
+/* Draw the inputs of step 'k' before 'initialize_inputs' prints them, and
+ * evaluate the step with them.  As long as a constraint is violated, the
+ * inputs in its cone are drawn again, up to 'resample' times, after which
+ * the step is given up on (and the violation is reported by 'finish_step'
+ * as without '--resample').  The step stays evaluated with the last draw. */
 static void
-initialize_inputs (int64_t k, int32_t randomize)
+resample_inputs (int64_t k)
 {
-  msg (1, "initializing inputs @%" PRId64, k);
-  if (print_trace) printf ("@%" PRId64 "\n", k);
-  for (size_t i = 0; i < inputs.size (); i++)
+  const BtorSimTape &tape = model.tape;
+  if (!collected_constraint_inputs) collect_constraint_inputs ();
+  for (size_t i = 0; i < model.inputs.size (); i++)
+    sim->initialize_input (i, 1);
+  for (int32_t retries = 0;; retries++)
   {
-    Btor2Line *input = inputs[i];
-    if (!current_state[input->id].is_set ())
-    // if not set previously by parse_input_part from witness
+    execute_step ();
+    num_draws++;
+    int64_t violated = -1;
+    for (size_t i = 0; violated < 0 && i < model.constraints.size (); i++)
     {
-      if (input->sort.tag == BTOR2_TAG_SORT_bitvec)
-      {
-        uint32_t width = input->sort.bitvec.width;
-        BtorSimBitVector *update;
-        if (randomize)
-          update = btorsim_bv_new_random (&rng, width);
-        else
-          update = btorsim_bv_new (width);
-        update_current_state (input->id, update);
-      }
-      else
-      {
-        assert (input->sort.tag == BTOR2_TAG_SORT_array);
-        Btor2Line *li =
-            btor2parser_get_line_by_id (model, input->sort.array.index);
-        Btor2Line *le =
-            btor2parser_get_line_by_id (model, input->sort.array.element);
-        assert (li->sort.tag == BTOR2_TAG_SORT_bitvec);
-        assert (le->sort.tag == BTOR2_TAG_SORT_bitvec);
-        BtorSimArrayModel *am = new BtorSimArrayModel (li->sort.bitvec.width,
-                                                       le->sort.bitvec.width);
-        if (randomize)
-        {
-          am->random_seed = btorsim_rng_rand (&rng);
-        }
-        update_current_state (input->id, am);
-      }
+      Btor2Line *constraint = model.constraints[i];
+      if (sim->current_state[tape.slot (constraint->args[0])].is_zero ())
+        violated = i;
+    }
+    if (violated < 0)
+    {
+      num_accepted_draws++;
+      return;
+    }
+    const std::vector<size_t> &inputs = constraint_inputs[violated];
+    if (retries == resample || inputs.empty ())
+    {
+      msg (1,
+           "giving up on step %" PRId64 " violating constraint(%" PRId64
+           ") after %d retries",
+           k,
+           violated,
+           retries);
+      num_given_up++;
+      return;
+    }
+    for (size_t i : inputs)
+    {
+      sim->delete_current_state (model.inputs[i]->id);
+      sim->initialize_input (i, 1);
     }
-    if (print_trace) print_state_or_input (input->id, i, k, true);
   }
 }
 
 static void
-initialize_states (int32_t randomly)
+simulate_random_step (int64_t k)
 {
-  msg (1, "initializing states at #0");
-  if (print_trace) printf ("#0\n");
-  for (size_t i = 0; i < states.size (); i++)
-  {
-    Btor2Line *state = states[i];
-    assert (0 <= state->id), assert (state->id < num_format_lines);
-    Btor2Line *init = inits[state->id];
-    if (!current_state[state->id].is_set ())
-    {  // can be set in parse_state_part from witness
-      switch (current_state[state->id].type)
-      {
-        case BtorSimState::Type::BITVEC: {
-          assert (state->sort.tag == BTOR2_TAG_SORT_bitvec);
-          if (init)
-          {
-            assert (init->nargs == 2);
-            assert (init->args[0] == state->id);
-            BtorSimState update = simulate (init->args[1]);
-            assert (update.type == BtorSimState::Type::BITVEC);
-            update_current_state (state->id, update);
-          }
-          else
-          {
-            BtorSimBitVector *bv;
-            if (randomly)
-              bv = btorsim_bv_new_random (&rng, state->sort.bitvec.width);
-            else
-              bv = btorsim_bv_new (state->sort.bitvec.width);
-            update_current_state (state->id, bv);
-          }
-        }
-        break;
-        case BtorSimState::Type::ARRAY:
-          assert (state->sort.tag == BTOR2_TAG_SORT_array);
-          if (init)
-          {
-            assert (init->nargs == 2);
-            assert (init->args[0] == state->id);
-            BtorSimState update = simulate (init->args[1]);
-            switch (update.type)
-            {
-              case BtorSimState::Type::ARRAY:
-                update_current_state (state->id, update);
-                break;
-              case BtorSimState::Type::BITVEC: {
-                Btor2Line *li =
-                    btor2parser_get_line_by_id (model, state->sort.array.index);
-                Btor2Line *le = btor2parser_get_line_by_id (
-                    model, state->sort.array.element);
-                assert (li->sort.tag == BTOR2_TAG_SORT_bitvec);
-                assert (le->sort.tag == BTOR2_TAG_SORT_bitvec);
-                BtorSimArrayModel *am = new BtorSimArrayModel (
-                    li->sort.bitvec.width, le->sort.bitvec.width);
-                am->const_init = update.bv_state;
-                update_current_state (state->id, am);
-              }
-              break;
-              default: die ("bad result simulating %" PRId64, init->args[1]);
-            }
-          }
-          else
-          {
-            Btor2Line *li =
-                btor2parser_get_line_by_id (model, state->sort.array.index);
-            Btor2Line *le =
-                btor2parser_get_line_by_id (model, state->sort.array.element);
-            assert (li->sort.tag == BTOR2_TAG_SORT_bitvec);
-            assert (le->sort.tag == BTOR2_TAG_SORT_bitvec);
-            BtorSimArrayModel *am = new BtorSimArrayModel (
-                li->sort.bitvec.width, le->sort.bitvec.width);
-            if (randomly)
-            {
-              am->random_seed = btorsim_rng_rand (&rng);
-            }
-            update_current_state (state->id, am);
-          }
-          break;
-        default: die ("uninitialized current_state %" PRId64, state->id);
-      }
-    }
-    if (print_trace && !init) print_state_or_input (state->id, i, 0, false);
+  const int32_t randomize = 1;
+  if (!resample)
+  {
+    initialize_inputs (k, randomize);
+    simulate_step (k, randomize);
+    return;
+  }
+  msg (1, "simulating step %" PRId64, k);
+  resample_inputs (k);
+  initialize_inputs (k, randomize);
+  finish_step (k, randomize);
+}
+
+/* Simulate steps 'first' to 'last' with random inputs, starting from the
+ * current states, and return the last simulated step. */
+static int64_t
+simulate_randomly (int64_t first, int64_t last)
+{
+  simulate_random_step (first);
+
+  int64_t i;
+  for (i = first + 1; i <= last; i++)
+  {
+    if (sim->constraints_violated >= 0) break;
+    if (!sim->num_unreached_bads) break;
+    if (simulated_seed > first_hit_seed.load (std::memory_order_relaxed))
+      break;
+    transition (i);
+    simulate_random_step (i);
   }
+  return i - 1;
 }
 
 static void
-simulate_step (int64_t k, int32_t randomize_states_that_are_inputs)
+random_simulation (int64_t k)
 {
-  msg (1, "simulating step %" PRId64, k);
-  for (int64_t i = 0; i < num_format_lines; i++)
-  {
-    Btor2Line *l = btor2parser_get_line_by_id (model, i);
-    if (!l) continue;
-    if (l->tag == BTOR2_TAG_sort || l->tag == BTOR2_TAG_init
-        || l->tag == BTOR2_TAG_next || l->tag == BTOR2_TAG_bad
-        || l->tag == BTOR2_TAG_constraint || l->tag == BTOR2_TAG_fair
-        || l->tag == BTOR2_TAG_justice || l->tag == BTOR2_TAG_output)
-      continue;
-
-    BtorSimState s = simulate (i);
-#if 0
-    printf ("[btorim] %" PRId64 " %s ", l->id, l->name);
-    if(s.type == BtorSimState::Type::BITVEC) btorsim_bv_print (s.bv_state);
-    fflush (stdout);
-#endif
-    s.remove ();
+  msg (1, "starting random simulation up to bound %" PRId64, k);
+  assert (k >= 0);
+
+  initialize_states (1);
+  simulate_randomly (0, k);
+
+  if (print_trace) fputs (".\n", trace_file), fflush (trace_file);
+  report ();
+}
+
+/* Draw a random value of at most 64 bits in the same way as random
+ * simulation, i.e., with 'btorsim_bv_new_random'. */
+static uint64_t
+random_word (BtorSimRNG *r, uint32_t width)
+{
+  BtorSimBitVector *bv = btorsim_bv_new_random (r, width);
+  uint64_t res         = btorsim_bv_to_uint64 (bv);
+  btorsim_bv_free (bv);
+  return res;
+}
+
+/* Random simulation of 'n' traces at once, where lane 'l' simulates the
+ * same trace as 'random_simulation' with random seed 'seed + l'.  Lanes stop
+ * individually under the same conditions.  The witnesses of lanes that
+ * reach bad state properties are printed by simulating them once more. */
+static void
+lanes_simulation (int64_t k, uint32_t seed, int32_t n)
+{
+  msg (1,
+       "starting random simulation of %d lanes up to bound %" PRId64,
+       n,
+       k);
+  assert (k >= 0), assert (n > 0);
+  const BtorSimTape &tape = model.tape;
+
+  bool supported = tape.supports_lanes ();
+  for (auto lines : {&model.inputs, &model.states})
+    for (auto l : *lines)
+      if (l->sort.tag != BTOR2_TAG_SORT_bitvec || l->sort.bitvec.width > 64)
+        supported = false;
+  if (!supported)
+    die ("'--lanes' only supports bit-vectors of at most 64 bits and no "
+         "arrays");
+
+  std::vector<uint64_t> vals (tape.num_slots () * n);
+  std::vector<uint64_t> next (model.states.size () * n);
+  tape.load_lanes (sim->current_state, vals, n);
+
+  /* initialize states as 'random_simulation' does for every seed */
+  std::vector<BtorSimRNG> rngs (n);
+  bool saved_print_trace = print_trace;
+  print_trace            = false;
+  for (int32_t l = 0; l < n; l++)
+  {
+    btorsim_rng_init (&sim->rng, seed + l);
+    initialize_states (1);
+    for (auto state : model.states)
+      vals[state->id * n + l] = sim->current_state[state->id].bv_word;
+    rngs[l] = sim->rng;
+    sim->reset ();
   }
-  for (size_t i = 0; i < states.size (); i++)
+  print_trace = saved_print_trace;
+
+  /* per lane: time of constraint violation, reached bad state properties and
+   * their number, and whether it is still simulated */
+  std::vector<int64_t> violated (n, -1);
+  std::vector<int64_t> reached (n * model.bads.size (), -1);
+  std::vector<int64_t> unreached (n, model.num_simulated_bads);
+  std::vector<bool> active (n, true);
+  int32_t num_active = n;
+
+  for (int64_t i = 0; i <= k && num_active; i++)
   {
-    Btor2Line *state = states[i];
-    assert (0 <= state->id), assert (state->id < num_format_lines);
-    Btor2Line *next = nexts[state->id];
-    BtorSimState update;
-    if (next)
+    msg (1, "simulating step %" PRId64 " of %d lanes", i, num_active);
+    if (i > 0)
     {
-      assert (next->nargs == 2);
-      assert (next->args[0] == state->id);
-      update = simulate (next->args[1]);
+      for (size_t j = 0; j < model.states.size (); j++)
+      {
+        Btor2Line *state = model.states[j];
+        if (model.nexts[state->id] && !tape.in_coi (state->id)) continue;
+        for (int32_t l = 0; l < n; l++)
+          if (active[l]) vals[state->id * n + l] = next[j * n + l];
+      }
     }
-    else
+    for (auto input : model.inputs)
+      for (int32_t l = 0; l < n; l++)
+        if (active[l])
+          vals[input->id * n + l] =
+              random_word (&rngs[l], input->sort.bitvec.width);
+
+    tape.execute_lanes (vals, n);
+
+    for (size_t j = 0; j < model.states.size (); j++)
     {
-      if (state->sort.tag == BTOR2_TAG_SORT_bitvec)
+      Btor2Line *state = model.states[j];
+      Btor2Line *nxt   = model.nexts[state->id];
+      if (nxt && !tape.in_coi (state->id)) continue;
+      for (int32_t l = 0; l < n; l++)
       {
-        update.type    = BtorSimState::Type::BITVEC;
-        uint32_t width = state->sort.bitvec.width;
-        if (randomize_states_that_are_inputs)
-          update.bv_state = btorsim_bv_new_random (&rng, width);
+        if (!active[l]) continue;
+        if (nxt)
+          next[j * n + l] = vals[tape.slot (nxt->args[1]) * n + l];
         else
-          update.bv_state = btorsim_bv_new (width);
+          next[j * n + l] = random_word (&rngs[l], state->sort.bitvec.width);
       }
-      else
+    }
+
+    for (int32_t l = 0; l < n; l++)
+    {
+      if (!active[l]) continue;
+      for (auto constraint : model.constraints)
+        if (violated[l] < 0 && !vals[tape.slot (constraint->args[0]) * n + l])
+          violated[l] = i;
+      if (violated[l] < 0)
       {
-        assert (state->sort.tag == BTOR2_TAG_SORT_array);
-        update.type = BtorSimState::Type::ARRAY;
-        Btor2Line *li =
-            btor2parser_get_line_by_id (model, state->sort.array.index);
-        Btor2Line *le =
-            btor2parser_get_line_by_id (model, state->sort.array.element);
-        assert (li->sort.tag == BTOR2_TAG_SORT_bitvec);
-        assert (le->sort.tag == BTOR2_TAG_SORT_bitvec);
-        update.array_state = new BtorSimArrayModel (li->sort.bitvec.width,
-                                                    le->sort.bitvec.width);
-        if (randomize_states_that_are_inputs)
-          update.array_state->random_seed = btorsim_rng_rand (&rng);
+        for (size_t j = 0; j < model.bads.size (); j++)
+        {
+          Btor2Line *bad = model.bads[j];
+          if (reached[l * model.bads.size () + j] >= 0) continue;
+          if (!tape.in_coi (bad->id)) continue;
+          if (!vals[tape.slot (bad->args[0]) * n + l]) continue;
+          reached[l * model.bads.size () + j] = i;
+          unreached[l]--;
+        }
+      }
+      if (violated[l] >= 0 || !unreached[l])
+      {
+        active[l] = false;
+        num_active--;
       }
     }
-    assert (!next_state[state->id].is_set ());
-    assert (next_state[state->id].type == update.type);
-    next_state[state->id] = update;
   }
 
-  if (constraints_violated < 0)
+  int32_t num_hits = 0;
+  for (int32_t l = 0; l < n; l++)
   {
-    for (size_t i = 0; i < constraints.size (); i++)
+    if (unreached[l] == model.num_simulated_bads) continue;
+    num_hits++;
+    std::string claims;
+    for (size_t j = 0; j < model.bads.size (); j++)
     {
-      Btor2Line *constraint = constraints[i];
-      BtorSimState s        = current_state[constraint->args[0]];
-      assert (s.type == BtorSimState::Type::BITVEC);
-      if (!btorsim_bv_is_zero (s.bv_state)) continue;
+      int64_t r = reached[l * model.bads.size () + j];
+      if (r < 0) continue;
       msg (1,
-           "constraint(%" PRId64 ") '%" PRId64 " constraint %" PRId64
-           "' violated at time %" PRId64,
-           i,
-           constraint->id,
-           constraint->args[0],
-           k);
-      constraints_violated = k;
+           "lane %d (seed %u) reached bad state property 'b%zu' at step "
+           "%" PRId64,
+           l,
+           seed + l,
+           j,
+           r);
+      if (!claims.empty ()) claims += ' ';
+      claims += 'b' + std::to_string (j);
     }
+    if (!print_trace) continue;
+    printf ("sat\n%s\n", claims.c_str ());
+    btorsim_rng_init (&sim->rng, seed + l);
+    random_simulation (k);
+    for (size_t j = 0; j < model.bads.size (); j++)
+      assert (sim->reached_bads[j] == reached[l * model.bads.size () + j]);
+    sim->reset ();
   }
+  msg (1, "%d of %d lanes reached bad state properties", num_hits, n);
+}
 
-  if (constraints_violated < 0)
-  {
-    for (size_t i = 0; i < bads.size (); i++)
+/* Random simulation of seeds 'first' to 'last' by 'jobs' threads, which
+ * claim seeds in increasing order and simulate them on their own simulators
+ * of the shared model.  The witness of the smallest seed reaching bad
+ * state properties is printed, which does not depend on the number of
+ * threads.  Larger seeds are cancelled as soon as such a seed is found. */
+static void
+seeds_simulation (int64_t k, uint32_t first, uint32_t last, int32_t jobs)
+{
+  msg (1,
+       "starting random simulation of seeds %u to %u with %d jobs up to "
+       "bound %" PRId64,
+       first,
+       last,
+       jobs,
+       k);
+  assert (k >= 0), assert (first <= last), assert (jobs > 0);
+
+  int32_t saved_verbosity = verbosity;
+  bool saved_print_trace  = print_trace;
+  verbosity               = 0;
+  print_trace             = false;
+
+  std::atomic<int64_t> next_seed (first);
+  std::atomic<int64_t> num_simulated (0);
+  BtorSimThreadPool seeds_pool (jobs);
+  seeds_pool.run ([&] (uint32_t t) {
+    /* the other threads simulate on their own simulators */
+    std::unique_ptr<BtorSim> own;
+    if (t)
     {
-      int64_t r = reached_bads[i];
-      if (r >= 0) continue;
-      Btor2Line *bad = bads[i];
-      BtorSimState s = current_state[bad->args[0]];
-      assert (s.type == BtorSimState::Type::BITVEC);
-      if (btorsim_bv_is_zero (s.bv_state)) continue;
-      int64_t bound = reached_bads[i];
-      if (bound >= 0) continue;
-      reached_bads[i] = k;
-      assert (num_unreached_bads > 0);
-      if (!--num_unreached_bads)
-        msg (1,
-             "all %" PRId64 " bad state properties reached",
-             (int64_t) bads.size ());
+      print_trace = false;
+      own.reset (new BtorSim (model));
+      sim = own.get ();
     }
-  }
+    for (;;)
+    {
+      int64_t seed = next_seed.fetch_add (1);
+      if (seed > last || seed > first_hit_seed.load ()) break;
+      simulated_seed = seed;
+      btorsim_rng_init (&sim->rng, (uint32_t) seed);
+      random_simulation (k);
+      num_simulated++;
+      int64_t hit = seed;
+      if (sim->num_unreached_bads == model.num_simulated_bads) hit = INT64_MAX;
+      int64_t cur = first_hit_seed.load ();
+      while (hit < cur && !first_hit_seed.compare_exchange_weak (cur, hit))
+        ;
+      sim->reset ();
+    }
+    simulated_seed = -1;
+    if (t) sim = nullptr;
+  });
 
-  /* Check additional bads from info file */
-  for (auto it : extra_constraints)
+  int64_t seed = first_hit_seed.load ();
+  if (seed == INT64_MAX)
   {
-    BtorSimState s = current_state[it.first];
-    assert (s.type == BtorSimState::Type::BITVEC);
-    if (btorsim_bv_is_zero (s.bv_state)) continue;
-    printf ("[btorsim] Assert failed in test: %s (step %" PRId64 ")\n",
-            it.second.c_str (),
-            k);
+    verbosity = saved_verbosity;
+    msg (1,
+         "none of %" PRId64 " seeds reached bad state properties",
+         num_simulated.load ());
+    print_trace = saved_print_trace;
+    return;
   }
 
-  if (dump_vcd)
+  /* simulate the seed once more to get its claims, and then to print it */
+  btorsim_rng_init (&sim->rng, (uint32_t) seed);
+  random_simulation (k);
+  std::string claims;
+  for (size_t j = 0; j < model.bads.size (); j++)
   {
-    for (int i = 0; i < num_format_lines; i++)
-    {
-      Btor2Line *l = btor2parser_get_line_by_id (model, i);
-      if (!l) continue;
-      // these are not signals
-      if (l->tag == BTOR2_TAG_sort || l->tag == BTOR2_TAG_init
-          || l->tag == BTOR2_TAG_next || l->tag == BTOR2_TAG_bad
-          || l->tag == BTOR2_TAG_constraint || l->tag == BTOR2_TAG_fair
-          || l->tag == BTOR2_TAG_justice)
-        continue;
-      // only add named signals
-      if (!l->symbol) continue;
-      vcd_writer->add_value_change (k, i, current_state[i]);
-    }
+    if (sim->reached_bads[j] < 0) continue;
+    if (!claims.empty ()) claims += ' ';
+    claims += 'b' + std::to_string (j);
   }
+  sim->reset ();
+  verbosity   = saved_verbosity;
+  print_trace = saved_print_trace;
+  msg (1,
+       "seed %" PRId64 " reached bad state properties { %s } after %" PRId64
+       " seeds were simulated",
+       seed,
+       claims.c_str (),
+       num_simulated.load ());
+  if (!print_trace) return;
+  printf ("sat\n%s\n", claims.c_str ());
+  btorsim_rng_init (&sim->rng, (uint32_t) seed);
+  random_simulation (k);
 }
 
+/* Ternary simulation of 'k' steps, in which all inputs and the states
+ * without init are X (unknown) and so are states without next function in
+ * later steps.  One run thus covers all traces, and a bad state property
+ * that is 1 at step 'i' is reached by every trace at step 'i' (unless it
+ * violates constraints), one that is X is possibly reached, and one that is
+ * never 1 or X is not reachable within 'k' steps.  Simulation stops as soon
+ * as all properties are definitely reached or a constraint is 0. */
 static void
-transition (int64_t k)
+ternary_simulation (int64_t k)
 {
-  msg (1, "transition %" PRId64, k);
-  for (int64_t i = 0; i < num_format_lines; i++) delete_current_state (i);
-  if (print_trace && print_states) printf ("#%" PRId64 "\n", k);
-  for (size_t i = 0; i < states.size (); i++)
-  {
-    Btor2Line *state = states[i];
-    assert (0 <= state->id), assert (state->id < num_format_lines);
-    BtorSimState update = next_state[state->id];
-    assert (update.is_set ());
-    update_current_state (state->id, update);
-    switch (next_state[state->id].type)
-    {
-      case BtorSimState::Type::BITVEC:
-        next_state[state->id].bv_state = nullptr;
-        break;
-      case BtorSimState::Type::ARRAY:
-        next_state[state->id].array_state = nullptr;
-        break;
-      default: die ("Invalid state type");
+  msg (1, "starting ternary simulation up to bound %" PRId64, k);
+  assert (k >= 0);
+  const BtorSimTape &tape = model.tape;
+
+  bool supported = tape.supports_ternary ();
+  for (auto lines : {&model.inputs, &model.states})
+    for (auto l : *lines)
+      if (l->sort.tag != BTOR2_TAG_SORT_bitvec) supported = false;
+  if (!supported) die ("'--ternary' does not support arrays");
+
+  const BtorSimXBitVector none = {nullptr, nullptr};
+  std::vector<BtorSimXBitVector> vals (tape.num_slots (), none);
+  std::vector<BtorSimXBitVector> next (model.states.size (), none);
+  tape.load_ternary (sim->current_state, vals);
+
+  auto set = [&] (int64_t s, BtorSimXBitVector v) {
+    if (vals[s].value) btorsim_xbv_free (&vals[s]);
+    vals[s] = v;
+  };
+  auto set_inputs = [&] () {
+    for (auto input : model.inputs)
+      set (input->id, btorsim_xbv_new_x (input->sort.bitvec.width));
+  };
+
+  /* inits are evaluated in the order of states as by 'initialize_states',
+   * states read by inits before their own init are still X */
+  set_inputs ();
+  for (auto state : model.states)
+    set (state->id, btorsim_xbv_new_x (state->sort.bitvec.width));
+  for (auto state : model.states)
+  {
+    Btor2Line *init = model.inits[state->id];
+    if (!init) continue;
+    tape.execute_init_ternary (state->id, vals);
+    set (state->id, btorsim_xbv_copy (&vals[tape.slot (init->args[1])]));
+  }
+
+  /* per state the bits that were X at every step so far, and per bad state
+   * property the first step at which it is definitely and possibly reached */
+  std::vector<BtorSimBitVector *> always_x;
+  for (auto state : model.states)
+    always_x.push_back (btorsim_bv_ones (state->sort.bitvec.width));
+  std::vector<int64_t> definitely (model.bads.size (), -1);
+  std::vector<int64_t> possibly (model.bads.size (), -1);
+  int64_t num_unreached = model.num_simulated_bads;
+
+  for (int64_t i = 0; i <= k && num_unreached; i++)
+  {
+    msg (1, "simulating step %" PRId64 " in ternary mode", i);
+    if (i > 0)
+    {
+      for (size_t j = 0; j < model.states.size (); j++)
+      {
+        if (!next[j].value) continue;
+        set (model.states[j]->id, next[j]);
+        next[j] = none;
+      }
+      set_inputs ();
+    }
+
+    if (print_trace && print_states) fprintf (trace_file, "#%" PRId64 "\n", i);
+    for (size_t j = 0; j < model.states.size (); j++)
+    {
+      Btor2Line *state           = model.states[j];
+      const BtorSimXBitVector &v = vals[state->id];
+      BtorSimBitVector *unknown  = btorsim_bv_not (v.known);
+      BtorSimBitVector *tmp      = always_x[j];
+      always_x[j]                = btorsim_bv_and (tmp, unknown);
+      btorsim_bv_free (tmp);
+      btorsim_bv_free (unknown);
+      if (!print_trace || !print_states) continue;
+      char *bits = btorsim_xbv_to_char (&v);
+      fprintf (trace_file, "%zu %s", j, bits);
+      if (state->symbol)
+        fprintf (trace_file, " %s#%" PRId64, state->symbol, i);
+      fputc ('\n', trace_file);
+      free (bits);
+    }
+
+    tape.execute_ternary (vals);
+
+    for (size_t j = 0; j < model.states.size (); j++)
+    {
+      Btor2Line *state = model.states[j];
+      Btor2Line *nxt   = model.nexts[state->id];
+      if (nxt && !tape.in_coi (state->id)) continue;
+      if (nxt)
+        next[j] = btorsim_xbv_copy (&vals[tape.slot (nxt->args[1])]);
+      else
+        next[j] = btorsim_xbv_new_x (state->sort.bitvec.width);
+    }
+
+    bool violated = false;
+    for (auto constraint : model.constraints)
+    {
+      const BtorSimXBitVector &v = vals[tape.slot (constraint->args[0])];
+      if (btorsim_xbv_is_known (&v) && btorsim_bv_is_zero (v.value))
+        violated = true;
+    }
+    if (violated)
+    {
+      msg (1, "constraints violated by all traces at step %" PRId64, i);
+      break;
+    }
+
+    for (size_t j = 0; j < model.bads.size (); j++)
+    {
+      Btor2Line *bad = model.bads[j];
+      if (!tape.in_coi (bad->id)) continue;
+      const BtorSimXBitVector &v = vals[tape.slot (bad->args[0])];
+      bool known                 = btorsim_xbv_is_known (&v);
+      if (possibly[j] < 0 && !(known && btorsim_bv_is_zero (v.value)))
+        possibly[j] = i;
+      if (definitely[j] < 0 && known && !btorsim_bv_is_zero (v.value))
+      {
+        definitely[j] = i;
+        num_unreached--;
+      }
     }
-    if (print_trace && print_states)
-      print_state_or_input (state->id, i, k, false);
   }
-}
 
-static void
-report ()
-{
-  if (verbosity && num_unreached_bads < (int64_t) bads.size ())
+  for (size_t j = 0; j < model.bads.size (); j++)
   {
-    printf ("[btorsim] reached bad state properties {");
-    for (size_t i = 0; i < bads.size (); i++)
+    if (!tape.in_coi (model.bads[j]->id)) continue;
+    if (definitely[j] >= 0)
     {
-      int64_t r = reached_bads[i];
-      if (r >= 0) printf (" b%lu@%" PRId64, i, r);
+      printf ("b%zu reached at step %" PRId64, j, definitely[j]);
+      if (possibly[j] < definitely[j])
+        printf (" (possibly at step %" PRId64 ")", possibly[j]);
+      fputc ('\n', stdout);
     }
-    printf (" }\n");
+    else if (possibly[j] >= 0)
+      printf ("b%zu possibly reached at step %" PRId64 "\n", j, possibly[j]);
+    else
+      printf ("b%zu unreachable up to step %" PRId64 "\n", j, k);
   }
-  else if (!bads.empty ())
-    msg (1, "no bad state property reached");
+  for (size_t j = 0; j < model.states.size (); j++)
+  {
+    Btor2Line *state = model.states[j];
+    if (tape.in_coi (state->id) && !btorsim_bv_is_zero (always_x[j]))
+    {
+      char *bits = btorsim_bv_to_char (always_x[j]);
+      for (char *p = bits; *p; p++) *p = *p == '1' ? 'x' : '.';
+      printf ("state %zu never leaves x in bits %s", j, bits);
+      if (state->symbol) printf (" %s", state->symbol);
+      fputc ('\n', stdout);
+      free (bits);
+    }
+    btorsim_bv_free (always_x[j]);
+  }
+  fflush (stdout);
 
-  if (constraints_violated >= 0)
-    msg (1, "constraints violated at time %" PRId64, constraints_violated);
-  else if (!constraints.empty ())
-    msg (1, "constraints always satisfied");
+  for (BtorSimXBitVector &v : vals)
+    if (v.value) btorsim_xbv_free (&v);
+  for (BtorSimXBitVector &v : next)
+    if (v.value) btorsim_xbv_free (&v);
 }
 
+/* Explicit-state search (see 'BtorSimBFS') up to bound 'k' with 'jobs'
+ * threads.  The witness of the bad state property reached first is printed
+ * by simulating it, which also checks it. */
 static void
-random_simulation (int64_t k)
+bfs_search (int64_t k, uint32_t seed, int32_t jobs)
 {
-  msg (1, "starting random simulation up to bound %" PRId64, k);
-  assert (k >= 0);
-
-  const int32_t randomize = 1;
+  msg (1,
+       "starting breadth-first search with %d jobs up to bound %" PRId64,
+       jobs,
+       k);
+  assert (k >= 0), assert (jobs > 0);
+
+  std::string error;
+  if (!BtorSimBFS::supports (model, error)) die ("'--bfs': %s", error.c_str ());
+
+  BtorSimBFS::Options options;
+  options.depth           = k;
+  options.num_threads     = jobs;
+  options.max_choice_bits = bfs_choices;
+  options.max_bytes       = (size_t) bfs_memory << 20;
+  options.seed            = seed;
+  BtorSimBFS search (model, options);
+
+  if (!search.search ())
+  {
+    if (search.saturated && search.exhaustive)
+      msg (1,
+           "no bad state property reachable, all %zu reachable states "
+           "visited within %" PRId64 " steps",
+           search.num_states (),
+           search.explored_depth);
+    else if (search.exhaustive)
+      msg (1,
+           "no bad state property reachable within %" PRId64
+           " steps (%zu states visited)",
+           k,
+           search.num_states ());
+    else
+      msg (1,
+           "no bad state property reached within %" PRId64
+           " steps (%zu states visited, incomplete due to %s)",
+           k,
+           search.num_states (),
+           search.is_bitstate () ? "bitstate hashing" : "sampled choices");
+    return;
+  }
 
-  initialize_states (randomize);
-  initialize_inputs (0, randomize);
-  simulate_step (0, randomize);
+  int64_t last = search.witness_inputs.size () - 1;
+  msg (1,
+       "reached bad state property 'b%" PRId64 "' at step %" PRId64
+       " after visiting %zu states",
+       search.reached_bad,
+       last,
+       search.num_states ());
+
+  if (print_trace) printf ("sat\nb%" PRId64 "\n", search.reached_bad);
+  for (size_t i = 0; i < model.states.size (); i++)
+  {
+    Btor2Line *state = model.states[i];
+    if (model.inits[state->id]) continue;
+    sim->update_current_state (
+        state->id,
+        btorsim_bv_uint64_to_bv (search.witness_states[i],
+                                 state->sort.bitvec.width));
+  }
+  initialize_states (0);
+  for (int64_t i = 0; i <= last; i++)
+  {
+    if (i) transition (i);
+    for (size_t j = 0; j < model.inputs.size (); j++)
+      sim->update_current_state (
+          model.inputs[j]->id,
+          btorsim_bv_uint64_to_bv (search.witness_inputs[i][j],
+                                   model.inputs[j]->sort.bitvec.width));
+    initialize_inputs (i, 0);
+    simulate_step (i, 0);
+  }
+  assert (sim->reached_bads[search.reached_bad] == last);
+  if (print_trace) fputs (".\n", trace_file), fflush (trace_file);
+}
 
-  for (int64_t i = 1; i <= k; i++)
+/* Coverage-guided fuzzing (see 'BtorSimFuzzer') of up to 'runs' runs of up
+ * to 'k' steps.  The witness of the first run reaching bad state properties
+ * is printed by simulating it once more, with the same random values of
+ * arrays and states without next function. */
+static void
+fuzz_simulation (int64_t k, uint32_t seed, int32_t runs)
+{
+  msg (1, "starting fuzzing of up to %d runs up to bound %" PRId64, runs, k);
+  assert (k >= 0), assert (runs > 0);
+
+  BtorSimFuzzer::Options options;
+  options.depth = k;
+  options.runs  = runs;
+  options.seed  = seed;
+  BtorSimFuzzer fuzzer (model, options);
+  bool reached = fuzzer.fuzz ();
+  msg (1,
+       "%s after %" PRIu64 " runs of %" PRIu64
+       " simulated steps, %zu of %zu coverage points covered, %zu entries "
+       "in corpus",
+       reached ? "reached bad state properties"
+               : "no bad state property reached",
+       fuzzer.num_runs,
+       fuzzer.num_steps,
+       fuzzer.num_covered,
+       fuzzer.num_points,
+       fuzzer.corpus_size ());
+  if (!reached) return;
+
+  std::string claims;
+  for (int64_t j : fuzzer.reached_bads)
   {
-    if (constraints_violated >= 0) break;
-    if (!num_unreached_bads) break;
-    transition (i);
-    initialize_inputs (i, randomize);
-    simulate_step (i, randomize);
+    if (!claims.empty ()) claims += ' ';
+    claims += 'b' + std::to_string (j);
   }
+  if (print_trace) printf ("sat\n%s\n", claims.c_str ());
+  btorsim_rng_init (&sim->rng, seed);
+  fuzzer.load_states (*sim);
+  initialize_states (1);
+  for (int64_t i = 0; i <= fuzzer.reached_at; i++)
+  {
+    if (i) transition (i);
+    fuzzer.load_inputs (*sim, i);
+    initialize_inputs (i, 1);
+    simulate_step (i, 1);
+  }
+#ifndef NDEBUG
+  for (int64_t j : fuzzer.reached_bads)
+    assert (sim->reached_bads[j] == fuzzer.reached_at);
+#endif
+  if (print_trace) fputs (".\n", trace_file), fflush (trace_file);
+}
 
-  if (print_trace) printf (".\n"), fflush (stdout);
-  report ();
+/* Exploration from an archive of states (see 'BtorSimExplorer') with up to
+ * 'n' restarts up to bound 'k'.  The witness of the first bad state reached
+ * is printed from step 0 by simulating its parts once more. */
+static void
+explore_simulation (int64_t k, uint32_t seed, int32_t n)
+{
+  msg (1, "starting exploration with %d restarts up to bound %" PRId64, n, k);
+  assert (k >= 0), assert (n > 0);
+
+  BtorSimExplorer::Options options;
+  options.depth        = k;
+  options.iterations   = n;
+  options.segment      = explore_steps;
+  options.archive_size = archive_size;
+  options.seed         = seed;
+  BtorSimExplorer explorer (model, options);
+
+  using clock  = std::chrono::steady_clock;
+  auto start   = clock::now ();
+  bool reached = explorer.explore ();
+  double seconds =
+      std::chrono::duration<double> (clock::now () - start).count ();
+  msg (1,
+       "%s after %" PRIu64 " restarts and %" PRIu64 " simulated steps",
+       reached ? "reached bad state properties"
+               : "no bad state property reached",
+       explorer.num_iterations,
+       explorer.num_steps);
+  msg (1,
+       "discovered %zu distinct states in %.2f seconds (%.0f per second), "
+       "%zu archived",
+       explorer.num_unique (),
+       seconds,
+       seconds ? explorer.num_unique () / seconds : 0.0,
+       explorer.archived ());
+  if (!reached) return;
+
+  std::string claims;
+  for (int64_t j : explorer.reached_bads)
+  {
+    if (!claims.empty ()) claims += ' ';
+    claims += 'b' + std::to_string (j);
+  }
+  if (print_trace) printf ("sat\n%s\n", claims.c_str ());
+  const std::vector<BtorSimExplorer::Part> &parts = explorer.witness;
+  btorsim_rng_init (&sim->rng, parts[0].seed);
+  initialize_states (1);
+  int64_t i = 0;
+  for (size_t p = 1; p < parts.size (); p++)
+  {
+    btorsim_rng_init (&sim->rng, parts[p].seed);
+    for (int64_t j = 0; j < parts[p].steps; j++, i++)
+    {
+      if (i) transition (i);
+      initialize_inputs (i, 1);
+      simulate_step (i, 1);
+    }
+  }
+  assert (i == explorer.reached_at + 1);
+#ifndef NDEBUG
+  for (int64_t j : explorer.reached_bads)
+    assert (sim->reached_bads[j] == explorer.reached_at);
+#endif
+  if (print_trace) fputs (".\n", trace_file), fflush (trace_file);
 }
 
 static int64_t charno;
@@ -1220,22 +1370,60 @@ prev_char (int32_t ch)
   char_saved = 1;
 }
 
+/* With '--server' witnesses are checked by the threads serving clients,
+ * and errors in witnesses are thrown as 'CheckError' to the server instead
+ * of stopping it (see 'check_witness'). */
+struct CheckError
+{
+  std::string msg;
+};
+static bool throw_check_errors;
+
+static std::string
+vformat (const char *fmt, va_list ap)
+{
+  char buf[256];
+  va_list copy;
+  va_copy (copy, ap);
+  int n = vsnprintf (buf, sizeof buf, fmt, copy);
+  va_end (copy);
+  if (n < 0) return fmt;
+  if ((size_t) n < sizeof buf) return buf;
+  std::string res (n + 1, 0);
+  vsnprintf (&res[0], n + 1, fmt, ap);
+  res.resize (n);
+  return res;
+}
+
+static void
+check_error (const char *msg, ...)
+{
+  va_list ap;
+  va_start (ap, msg);
+  std::string error = vformat (msg, ap);
+  va_end (ap);
+  if (throw_check_errors) throw CheckError{error};
+  die ("%s", error.c_str ());
+}
+
 static void
 parse_error (const char *msg, ...)
 {
-  fflush (stdout);
   assert (witness_path);
-  fprintf (stderr,
-           "*** 'btorsim' parse error in '%s' at line %" PRId64
-           " column %" PRId64 ": ",
-           witness_path,
-           lineno,
-           columno);
+  char pos[64];
+  snprintf (pos,
+            sizeof pos,
+            "' at line %" PRId64 " column %" PRId64 ": ",
+            lineno,
+            columno);
   va_list ap;
   va_start (ap, msg);
-  vfprintf (stderr, msg, ap);
+  std::string error =
+      std::string ("parse error in '") + witness_path + pos + vformat (msg, ap);
   va_end (ap);
-  fprintf (stderr, "\n");
+  if (throw_check_errors) throw CheckError{error};
+  fflush (stdout);
+  fprintf (stderr, "*** 'btorsim' %s\n", error.c_str ());
   exit (1);
 }
 
@@ -1372,11 +1560,11 @@ parse_state_part (int64_t k)
     charno               = 1;
     assert (lineno > 1);
     lineno--;
-    if (state_pos >= (int64_t) states.size ())
+    if (state_pos >= (int64_t) model.states.size ())
       parse_error ("less than %" PRId64 " states defined", state_pos);
-    Btor2Line *state = states[state_pos];
+    Btor2Line *state = model.states[state_pos];
     assert (state);
-    assert (0 <= state->id), assert (state->id < num_format_lines);
+    assert (0 <= state->id), assert (state->id < model.num_format_lines);
     bool is_const_init = false;
     if (state->sort.tag == BTOR2_TAG_SORT_bitvec)
     {
@@ -1436,9 +1624,9 @@ parse_state_part (int64_t k)
       }
       assert (state->sort.tag == BTOR2_TAG_SORT_array);
       Btor2Line *li =
-          btor2parser_get_line_by_id (model, state->sort.array.index);
+          btor2parser_get_line_by_id (model.parser, state->sort.array.index);
       Btor2Line *le =
-          btor2parser_get_line_by_id (model, state->sort.array.element);
+          btor2parser_get_line_by_id (model.parser, state->sort.array.element);
       assert (li->sort.tag == BTOR2_TAG_SORT_bitvec);
       assert (le->sort.tag == BTOR2_TAG_SORT_bitvec);
       is_const_init = BTOR2_COUNT_STACK (array_index) == 2
@@ -1454,12 +1642,12 @@ parse_state_part (int64_t k)
         parse_error ("expected element of width '%u'",
                      state->sort.array.element);
       }
-      if (!current_state[state->id].array_state)
+      if (!sim->current_state[state->id].array_state)
       {
-        current_state[state->id].array_state = new BtorSimArrayModel (
+        sim->current_state[state->id].array_state = new BtorSimArrayModel (
             li->sort.bitvec.width, le->sort.bitvec.width);
       }
-      assert (current_state[state->id].array_state);
+      assert (sim->current_state[state->id].array_state);
     }
 
     BtorSimBitVector *idx = 0;
@@ -1468,17 +1656,18 @@ parse_state_part (int64_t k)
     BtorSimBitVector *val = btorsim_bv_char_to_bv (constant.start);
     if (k == 0)
     {
-      Btor2Line *init = inits[state->id];
-      if (init && nexts[state->id])
+      Btor2Line *init = model.inits[state->id];
+      if (init && model.nexts[state->id])
       {
         msg (4, "init & next for state %" PRId64, state->id);
         assert (init->nargs == 2);
         assert (init->args[0] == state->id);
-        BtorSimState tmp = simulate (init->args[1]);
+        model.tape.execute_init (state->id, sim->current_state);
+        BtorSimState tmp = sim->get_value (init->args[1]);
         if (state->sort.tag == BTOR2_TAG_SORT_bitvec)
         {
           assert (tmp.type == BtorSimState::Type::BITVEC);
-          if (btorsim_bv_compare (val, tmp.bv_state))
+          if (tmp.compare (val))
             parse_error ("incompatible initialized state %" PRId64
                          " id %" PRId64,
                          state_pos,
@@ -1490,7 +1679,7 @@ parse_state_part (int64_t k)
           if (is_const_init)
           {
             assert (tmp.type == BtorSimState::Type::BITVEC);
-            element = btorsim_bv_copy (tmp.bv_state);
+            element = tmp.copy_bv ();
           }
           else
           {
@@ -1514,11 +1703,11 @@ parse_state_part (int64_t k)
     }
     lineno++;
     charno = saved_charno;
-    if (k > 0 && nexts[state->id])
+    if (k > 0 && model.nexts[state->id] && model.tape.in_coi (state->id))
     {
       if (state->sort.tag == BTOR2_TAG_SORT_bitvec)
       {
-        if (btorsim_bv_compare (val, current_state[state->id].bv_state))
+        if (sim->current_state[state->id].compare (val))
         {
           parse_error ("incompatible assignment for state %" PRId64
                        " id %" PRId64 " in time frame %" PRId64,
@@ -1531,8 +1720,8 @@ parse_state_part (int64_t k)
       {
         BtorSimBitVector *tmp =
             is_const_init
-                ? current_state[state->id].array_state->get_const_init ()
-                : current_state[state->id].array_state->check (idx);
+                ? sim->current_state[state->id].array_state->get_const_init ()
+                : sim->current_state[state->id].array_state->check (idx);
         if (tmp && btorsim_bv_compare (val, tmp))
         {
           parse_error ("incompatible assignment for state %" PRId64
@@ -1546,25 +1735,25 @@ parse_state_part (int64_t k)
     }
     if (state->sort.tag == BTOR2_TAG_SORT_bitvec)
     {
-      update_current_state (state->id, val);
+      sim->update_current_state (state->id, val);
     }
     else
     {
-      assert (current_state[state->id].type == BtorSimState::Type::ARRAY);
+      assert (sim->current_state[state->id].type == BtorSimState::Type::ARRAY);
       BtorSimState tmp;
       tmp.type = BtorSimState::Type::ARRAY;
       if (is_const_init)
       {
         tmp.array_state =
-            current_state[state->id].array_state->set_const_init (val);
+            sim->current_state[state->id].array_state->set_const_init (val);
       }
       else
       {
         tmp.array_state =
-            current_state[state->id].array_state->write (idx, val);
+            sim->current_state[state->id].array_state->write (idx, val);
         btorsim_bv_free (idx);
       }
-      update_current_state (state->id, tmp);
+      sim->update_current_state (state->id, tmp);
       btorsim_bv_free (val);
     }
   }
@@ -1584,7 +1773,7 @@ parse_input_part (int64_t k)
     charno               = 1;
     assert (lineno > 1);
     lineno--;
-    if (input_pos >= (int64_t) inputs.size ())
+    if (input_pos >= (int64_t) model.inputs.size ())
     {
       parse_error ("less than %" PRId64 " defined", input_pos);
     }
@@ -1630,9 +1819,9 @@ parse_input_part (int64_t k)
              k);
       }
     }
-    Btor2Line *input = inputs[input_pos];
+    Btor2Line *input = model.inputs[input_pos];
     assert (input);
-    if (current_state[input->id].type == BtorSimState::Type::BITVEC)
+    if (sim->current_state[input->id].type == BtorSimState::Type::BITVEC)
     {
       if (strlen (constant.start) != input->sort.bitvec.width)
       {
@@ -1640,8 +1829,8 @@ parse_input_part (int64_t k)
         parse_error ("expected constant of width '%u'",
                      input->sort.bitvec.width);
       }
-      assert (0 <= input->id), assert (input->id < num_format_lines);
-      if (current_state[input->id].bv_state)
+      assert (0 <= input->id), assert (input->id < model.num_format_lines);
+      if (sim->current_state[input->id].is_set ())
       {
         parse_error ("input %" PRId64 " id %" PRId64
                      " assigned twice in frame %" PRId64,
@@ -1652,18 +1841,18 @@ parse_input_part (int64_t k)
       BtorSimBitVector *val = btorsim_bv_char_to_bv (constant.start);
       lineno++;
       charno = saved_charno;
-      update_current_state (input->id, val);
+      sim->update_current_state (input->id, val);
     }
     else
     {
-      assert (current_state[input->id].type == BtorSimState::Type::ARRAY);
+      assert (sim->current_state[input->id].type == BtorSimState::Type::ARRAY);
       BtorSimBitVector *idx = btorsim_bv_char_to_bv (array_index.start);
       BtorSimBitVector *val = btorsim_bv_char_to_bv (constant.start);
       lineno++;
       charno = saved_charno;
       BtorSimArrayModel *am =
-          current_state[input->id].array_state->write (idx, val);
-      update_current_state (input->id, am);
+          sim->current_state[input->id].array_state->write (idx, val);
+      sim->update_current_state (input->id, am);
     }
   }
 }
@@ -1682,6 +1871,105 @@ parse_frame (int64_t k)
   return !found_end_of_witness;
 }
 
+/* With '--fork': replay the witness up to step 'n' and simulate 'forks'
+ * random continuations of 'k' steps from a snapshot of the simulation at
+ * step 'n', where continuation 'i' uses random seed 'seed + i'.  Only the
+ * witnesses of continuations reaching bad state properties are printed,
+ * each starting with the replayed part of the witness, which is captured
+ * once.  With '--vcd' the VCD trace of the first such continuation (or of
+ * the first continuation if none reaches one) is written. */
+static void
+fork_simulation (int64_t n, int64_t k, uint32_t seed, int32_t forks)
+{
+  msg (1,
+       "forking %d random continuations of %" PRId64
+       " steps at step %" PRId64,
+       forks,
+       k,
+       n);
+  char *prefix = nullptr, *trace = nullptr;
+  size_t prefix_size = 0, trace_size = 0;
+  if (print_trace && !(trace_file = open_memstream (&prefix, &prefix_size)))
+    die ("failed to capture trace");
+
+  for (int64_t i = 0; i < n; i++)
+    if (!parse_frame (i) && i + 1 < n)
+      die ("can not fork at step %" PRId64 " of witness with %" PRId64
+           " frames",
+           n,
+           i + 1);
+  if (n)
+    transition (n);
+  else
+  {
+    parse_state_part (0);
+    initialize_states (0);
+  }
+  /* the rest of the witness is replaced by the continuations */
+  while (next_char () != EOF)
+    ;
+  if (print_trace) fclose (trace_file), trace_file = stdout;
+
+  BtorSim::Snapshot snapshot;
+  BtorSimVCDWriter::Snapshot vcd_start, vcd_selected;
+  bool vcd_reached = false;
+  sim->save (snapshot);
+  if (dump_vcd) vcd_writer->save (vcd_start);
+
+  int32_t num_hits = 0;
+  for (int32_t i = 0; i < forks; i++)
+  {
+    sim->restore (snapshot);
+    if (dump_vcd) vcd_writer->restore (vcd_start);
+    btorsim_rng_init (&sim->rng, seed + i);
+    if (print_trace && !(trace_file = open_memstream (&trace, &trace_size)))
+      die ("failed to capture trace");
+    int64_t last = simulate_randomly (n, n + k);
+    if (print_trace)
+      fputs (".\n", trace_file), fclose (trace_file), trace_file = stdout;
+
+    std::string claims;
+    for (size_t j = 0; j < model.bads.size (); j++)
+    {
+      if (sim->reached_bads[j] < 0) continue;
+      if (!claims.empty ()) claims += ' ';
+      claims += 'b' + std::to_string (j);
+    }
+    bool reached = !claims.empty ();
+    if (dump_vcd && !vcd_reached && (reached || !i))
+    {
+      vcd_writer->update_time (last + 1);
+      vcd_writer->save (vcd_selected);
+      vcd_reached = reached;
+    }
+    if (reached)
+    {
+      num_hits++;
+      msg (1,
+           "continuation %d (seed %u) reached bad state properties { %s }",
+           i,
+           seed + i,
+           claims.c_str ());
+      if (print_trace)
+      {
+        printf ("sat\n%s\n", claims.c_str ());
+        fwrite (prefix, 1, prefix_size, stdout);
+        fwrite (trace, 1, trace_size, stdout);
+        fflush (stdout);
+      }
+    }
+    free (trace);
+    trace = nullptr;
+  }
+  free (prefix);
+  if (dump_vcd) vcd_writer->restore (vcd_selected);
+  msg (1,
+       "%d of %d continuations reached bad state properties",
+       num_hits,
+       forks);
+  report_resampling ();
+}
+
 static void
 parse_sat_witness ()
 {
@@ -1711,7 +1999,7 @@ parse_sat_witness ()
     }
     if (type == 'b')
     {
-      if (bad >= (int64_t) bads.size ())
+      if (bad >= (int64_t) model.bads.size ())
       {
         parse_error ("invalid bad state property number %" PRId64, bad);
       }
@@ -1727,6 +2015,13 @@ parse_sat_witness ()
     }
     if (ch == '\n') break;
   }
+  if (coi_mode) prune_to_coi (claimed_bad_witnesses);
+
+  if (fork_step >= 0)
+  {
+    fork_simulation (fork_step, fork_bound, fork_seed, forks);
+    return;
+  }
 
   int64_t k = 0;
   while (parse_frame (k)) k++;
@@ -1735,19 +2030,19 @@ parse_sat_witness ()
   if (dump_vcd) vcd_writer->update_time (k + 1);
 
   report ();
-  if (print_trace) printf (".\n"), fflush (stdout);
+  if (print_trace) fputs (".\n", trace_file), fflush (trace_file);
 
   for (size_t i = 0; i < claimed_bad_witnesses.size (); i++)
   {
     int64_t bad_pos = claimed_bad_witnesses[i];
-    int64_t bound   = reached_bads[bad_pos];
-    Btor2Line *l    = bads[bad_pos];
+    int64_t bound   = sim->reached_bads[bad_pos];
+    Btor2Line *l    = model.bads[bad_pos];
     if (bound < 0)
     {
-      die ("claimed bad state property 'b%" PRId64 "' id %" PRId64
-           " not reached",
-           bad_pos,
-           l->id);
+      check_error ("claimed bad state property 'b%" PRId64 "' id %" PRId64
+                   " not reached",
+                   bad_pos,
+                   l->id);
     }
   }
 }
@@ -1756,12 +2051,18 @@ static void
 parse_unknown_witness ()
 {
   msg (1, "parsing unknown witness %" PRId64, count_unknown_witnesses);
+  if (coi_mode) prune_to_coi (claimed_bad_witnesses);
+  if (fork_step >= 0)
+  {
+    fork_simulation (fork_step, fork_bound, fork_seed, forks);
+    return;
+  }
   int64_t k = 0;
 
   while (parse_frame (k)) k++;
 
   report ();
-  if (print_trace) printf (".\n"), fflush (stdout);
+  if (print_trace) fputs (".\n", trace_file), fflush (trace_file);
 
   msg (1, "finished parsing k = %" PRId64 " frames", k);
 }
@@ -1770,7 +2071,7 @@ static void
 parse_unsat_witness ()
 {
   msg (1, "parsing 'unsat' witness %" PRId64, count_unsat_witnesses);
-  die ("'unsat' witnesses not supported yet");
+  check_error ("'unsat' witnesses not supported yet");
 }
 
 static bool
@@ -1787,7 +2088,7 @@ parse_and_check_witness ()
     count_witnesses++;
     count_unknown_witnesses++;
     if (count_sat_witnesses + count_unknown_witnesses > 1)
-      die ("more than one actual witness not supported yet");
+      check_error ("more than one actual witness not supported yet");
     prev_char (ch);
     parse_unknown_witness ();
     return true;
@@ -1806,7 +2107,7 @@ parse_and_check_witness ()
            witness_path,
            lineno - 1);
       if (count_witnesses > 1)
-        die ("more than one actual witness not supported yet");
+        check_error ("more than one actual witness not supported yet");
       parse_sat_witness ();
       return true;
     }
@@ -1859,46 +2160,95 @@ parse_and_check_all_witnesses ()
        charno / (double) (1l << 20));
 }
 
-void
-setup_states ()
+/* With '--server': check the witness 'path' on a new simulator of the
+ * model parsed by the server.  Checks are serialized, since the witness
+ * parser is not reentrant.  Errors in the witness are reported as in
+ * checking mode but do not stop the server. */
+static bool
+check_witness (const char *path, std::string &res)
 {
-  current_state.resize (num_format_lines);
-  next_state.resize (num_format_lines);
-  if (dump_vcd) vcd_writer->prev_value.resize (num_format_lines);
+  static std::mutex mutex;
+  std::lock_guard<std::mutex> lock (mutex);
+  FILE *file = fopen (path, "r");
+  if (!file)
+  {
+    res = std::string ("failed to open witness file '") + path
+          + "' for reading";
+    return false;
+  }
 
-  for (int i = 0; i < num_format_lines; i++)
+  witness_file            = file;
+  witness_path            = path;
+  charno                  = 0;
+  columno                 = 0;
+  lineno                  = 1;
+  char_saved              = 0;
+  found_end_of_witness    = 0;
+  found_initial_frame     = 0;
+  count_sat_witnesses     = 0;
+  count_unsat_witnesses   = 0;
+  count_unknown_witnesses = 0;
+  count_witnesses         = 0;
+  claimed_bad_witnesses.clear ();
+  claimed_justice_witnesses.clear ();
+  /* 'print_trace' and 'sim' are specific to the serving thread */
+  print_trace        = false;
+  throw_check_errors = true;
+  std::unique_ptr<BtorSim> checker (new BtorSim (model));
+  sim = checker.get ();
+
+  bool ok = true;
+  try
   {
-    Btor2Line *l = btor2parser_get_line_by_id (model, i);
-    if (l)
-    {
-      Btor2Sort *sort = get_sort (l, model);
-      switch (sort->tag)
-      {
-        case BTOR2_TAG_SORT_bitvec:
-          current_state[i].type = BtorSimState::Type::BITVEC;
-          next_state[i].type    = BtorSimState::Type::BITVEC;
-          if (dump_vcd)
-          {
-            vcd_writer->prev_value[i].type = BtorSimState::Type::BITVEC;
-          }
-          break;
-        case BTOR2_TAG_SORT_array:
-          current_state[i].type = BtorSimState::Type::ARRAY;
-          next_state[i].type    = BtorSimState::Type::ARRAY;
-          if (dump_vcd)
-          {
-            vcd_writer->prev_value[i].type = BtorSimState::Type::ARRAY;
-          }
-          break;
-        default: die ("Unknown sort");
-      }
-    }
+    parse_and_check_all_witnesses ();
+    res.clear ();
+    for (size_t i = 0; i < model.bads.size (); i++)
+      if (sim->reached_bads[i] >= 0)
+        res += " b" + std::to_string (i) + "@"
+               + std::to_string (sim->reached_bads[i]);
+  }
+  catch (const CheckError &e)
+  {
+    BTOR2_RELEASE_STACK (constant);
+    BTOR2_RELEASE_STACK (symbol);
+    BTOR2_RELEASE_STACK (array_index);
+    res = e.msg;
+    ok  = false;
   }
+  throw_check_errors = false;
+  sim                = nullptr;
+  witness_file       = nullptr;
+  witness_path       = nullptr;
+  fclose (file);
+  return ok;
+}
 
-  for (auto state : states)
+static void
+serve ()
+{
+  /* the model is shared by all clients and must not be pruned again by
+   * checking witnesses */
+  if (coi_mode) prune_to_coi (std::vector<int64_t> ()), coi_mode = false;
+  BtorSimServer server (model, check_witness);
+  if (!socket_path)
   {
-    assert (current_state[state->id].type != BtorSimState::Type::INVALID);
-    assert (next_state[state->id].type != BtorSimState::Type::INVALID);
+    msg (1, "serving requests on '<stdin>'");
+    server.serve (0, 1);
+    return;
+  }
+  std::string error;
+  if (!server.listen (socket_path, error)) die ("%s", error.c_str ());
+}
+
+/* The VCD writer starts with unset values of the same types as the model. */
+static void
+setup_vcd ()
+{
+  vcd_writer->prev_value.resize (model.num_format_lines);
+  for (int64_t i = 0; i < model.num_format_lines; i++)
+  {
+    vcd_writer->prev_value[i].type  = sim->current_state[i].type;
+    vcd_writer->prev_value[i].width = sim->current_state[i].width;
   }
 }
 
@@ -1948,6 +2298,110 @@ main (int32_t argc, char const *argv[])
     }
     else if (!strcmp (argv[i], "--hierarchical-symbols"))
       symbol_fmt = true;
+    else if (!strcmp (argv[i], "--coi"))
+      coi_mode = true;
+    else if (!strcmp (argv[i], "--event-driven"))
+      event_driven = true;
+    else if (!strcmp (argv[i], "--lazy"))
+      lazy = true;
+    else if (!strcmp (argv[i], "--lanes"))
+    {
+      if (++i == argc) die ("argument to '--lanes' missing");
+      if (!parse_int (argv[i], &lanes) || !lanes)
+        die ("invalid number in '--lanes %s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "--compile"))
+      compile_mode = true;
+    else if (!strcmp (argv[i], "--compile-dir"))
+    {
+      if (++i == argc) die ("argument to '--compile-dir' missing");
+      compile_dir = argv[i];
+    }
+    else if (!strcmp (argv[i], "--threads"))
+    {
+      if (++i == argc) die ("argument to '--threads' missing");
+      if (!parse_int (argv[i], &threads) || !threads)
+        die ("invalid number in '--threads %s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "--seeds"))
+    {
+      if (++i == argc) die ("argument to '--seeds' missing");
+      if (!parse_range (argv[i], &first_seed, &last_seed))
+        die ("invalid range in '--seeds %s'", argv[i]);
+      seeds = true;
+    }
+    else if (!strcmp (argv[i], "--jobs"))
+    {
+      if (++i == argc) die ("argument to '--jobs' missing");
+      if (!parse_int (argv[i], &jobs) || !jobs)
+        die ("invalid number in '--jobs %s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "--fork"))
+    {
+      if (++i == argc) die ("argument to '--fork' missing");
+      if (!parse_long (argv[i], &fork_step) || fork_step < 0)
+        die ("invalid number in '--fork %s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "--forks"))
+    {
+      if (++i == argc) die ("argument to '--forks' missing");
+      if (!parse_int (argv[i], &forks) || !forks)
+        die ("invalid number in '--forks %s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "--server"))
+      server_mode = true;
+    else if (!strcmp (argv[i], "--socket"))
+    {
+      if (++i == argc) die ("argument to '--socket' missing");
+      socket_path = argv[i];
+      server_mode = true;
+    }
+    else if (!strcmp (argv[i], "--ternary"))
+      ternary = true;
+    else if (!strcmp (argv[i], "--bfs"))
+      bfs = true;
+    else if (!strcmp (argv[i], "--bfs-choices"))
+    {
+      if (++i == argc) die ("argument to '--bfs-choices' missing");
+      if (!parse_int (argv[i], &bfs_choices) || bfs_choices > 30)
+        die ("invalid number in '--bfs-choices %s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "--bfs-memory"))
+    {
+      if (++i == argc) die ("argument to '--bfs-memory' missing");
+      if (!parse_int (argv[i], &bfs_memory) || !bfs_memory)
+        die ("invalid number in '--bfs-memory %s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "--fuzz"))
+    {
+      if (++i == argc) die ("argument to '--fuzz' missing");
+      if (!parse_int (argv[i], &fuzz_runs) || !fuzz_runs)
+        die ("invalid number in '--fuzz %s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "--explore"))
+    {
+      if (++i == argc) die ("argument to '--explore' missing");
+      if (!parse_int (argv[i], &explorations) || !explorations)
+        die ("invalid number in '--explore %s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "--explore-steps"))
+    {
+      if (++i == argc) die ("argument to '--explore-steps' missing");
+      if (!parse_int (argv[i], &explore_steps) || !explore_steps)
+        die ("invalid number in '--explore-steps %s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "--archive"))
+    {
+      if (++i == argc) die ("argument to '--archive' missing");
+      if (!parse_int (argv[i], &archive_size) || !archive_size)
+        die ("invalid number in '--archive %s'", argv[i]);
+    }
+    else if (!strcmp (argv[i], "--resample"))
+    {
+      if (++i == argc) die ("argument to '--resample' missing");
+      if (!parse_int (argv[i], &resample) || !resample)
+        die ("invalid number in '--resample %s'", argv[i]);
+    }
     else if (!strcmp (argv[i], "--info"))
     {
       if (++i == argc) die ("argument to '--info' missing");
@@ -1965,6 +2419,24 @@ main (int32_t argc, char const *argv[])
     else
       model_path = argv[i];
   }
+  if (server_mode)
+  {
+    if (witness_path) die ("can not check witness file with '--server'");
+    if (!socket_path && !model_path)
+      die ("'--server' requires a model file unless '--socket' is used");
+    /* responses are written to '<stdout>' */
+    if (!socket_path && verbosity)
+      die ("can not use '-v' with '--server' unless '--socket' is used");
+    if (r >= 0 || s >= 0 || fake_bad >= 0 || fake_justice >= 0)
+      die ("can not simulate randomly or fake properties with '--server'");
+    if (lanes || seeds || fork_step >= 0 || forks)
+      die ("can not combine '--server' with '--lanes', '--seeds' or '--fork'");
+    if (print_states || dump_vcd)
+      die ("can not print states or write VCD traces with '--server'");
+    if (event_driven || lazy || compile_mode || threads)
+      die ("can not combine '--server' with '--event-driven', '--lazy', "
+           "'--compile' or '--threads'");
+  }
   if (model_path)
   {
     if (!(model_file = fopen (model_path, "r")))
@@ -1982,7 +2454,13 @@ main (int32_t argc, char const *argv[])
       die ("failed to open witness file '%s' for reading", witness_path);
     close_witness_file = 1;
   }
-  if (model_path && witness_path)
+  if (server_mode)
+  {
+    msg (1, "server mode: no witness and '--server' specified");
+    checking_mode = 0;
+    random_mode   = 0;
+  }
+  else if (model_path && witness_path)
   {
     msg (1, "checking mode: both model and witness specified");
     checking_mode = 1;
@@ -1994,14 +2472,133 @@ main (int32_t argc, char const *argv[])
     checking_mode = 0;
     random_mode   = 1;
   }
-  if (checking_mode)
+  if (forks && fork_step < 0) die ("'--forks' requires '--fork'");
+  if (fork_step >= 0)
+  {
+    if (!checking_mode) die ("'--fork' requires a witness");
+    if (r < 0) r = 20;
+    if (s < 0) s = 0;
+    if (!forks) forks = 1;
+    fork_bound = r;
+    fork_seed  = s;
+  }
+  else if (checking_mode)
   {
     if (r >= 0)
       die ("number of random test vectors specified in checking mode");
     if (s >= 0) die ("random seed specified in checking mode");
+  }
+  if (checking_mode)
+  {
     if (fake_bad >= 0) die ("can not fake bad state property in checking mode");
     if (fake_justice >= 0)
       die ("can not fake justice property in checking mode");
+    if (lanes) die ("can not simulate lanes in checking mode");
+    if (seeds) die ("can not simulate seeds in checking mode");
+  }
+  if (lanes)
+  {
+    if (fake_bad >= 0 || fake_justice >= 0)
+      die ("can not fake properties with '--lanes'");
+    if (print_states || dump_vcd)
+      die ("can not print states or write VCD traces with '--lanes'");
+    if (event_driven || lazy || compile_mode)
+      die ("can not combine '--lanes' with '--event-driven', '--lazy' or "
+           "'--compile'");
+  }
+  if (event_driven + lazy + compile_mode + (threads > 0) > 1)
+    die ("can only use one of '--event-driven', '--lazy', '--compile' and "
+         "'--threads'");
+  if (lanes && threads) die ("can not combine '--lanes' and '--threads'");
+  if (jobs && !seeds && !bfs) die ("'--jobs' requires '--seeds' or '--bfs'");
+  if (seeds)
+  {
+    if (s >= 0) die ("can not combine '-s' and '--seeds'");
+    if (fake_bad >= 0 || fake_justice >= 0)
+      die ("can not fake properties with '--seeds'");
+    if (print_states || dump_vcd)
+      die ("can not print states or write VCD traces with '--seeds'");
+    if (lanes || event_driven || lazy || compile_mode || threads)
+      die ("can not combine '--seeds' with '--lanes', '--event-driven', "
+           "'--lazy', '--compile' or '--threads'");
+    if (!jobs) jobs = 1;
+  }
+  if (ternary)
+  {
+    if (!random_mode) die ("'--ternary' requires random mode");
+    if (s >= 0 || fake_bad >= 0 || fake_justice >= 0)
+      die ("can not use random seeds or fake properties with '--ternary'");
+    if (lanes || seeds || dump_vcd)
+      die ("can not combine '--ternary' with '--lanes', '--seeds' or "
+           "'--vcd'");
+    if (event_driven || lazy || compile_mode || threads)
+      die ("can not combine '--ternary' with '--event-driven', '--lazy', "
+           "'--compile' or '--threads'");
+  }
+  if (bfs)
+  {
+    if (!random_mode) die ("'--bfs' requires random mode");
+    if (fake_bad >= 0 || fake_justice >= 0)
+      die ("can not fake properties with '--bfs'");
+    if (lanes || seeds || ternary || dump_vcd)
+      die ("can not combine '--bfs' with '--lanes', '--seeds', '--ternary' "
+           "or '--vcd'");
+    if (event_driven || lazy || compile_mode || threads)
+      die ("can not combine '--bfs' with '--event-driven', '--lazy', "
+           "'--compile' or '--threads'");
+    if (!jobs) jobs = 1;
+  }
+  if (fuzz_runs)
+  {
+    if (!random_mode) die ("'--fuzz' requires random mode");
+    if (fake_bad >= 0 || fake_justice >= 0)
+      die ("can not fake properties with '--fuzz'");
+    if (lanes || seeds || ternary || bfs || dump_vcd)
+      die ("can not combine '--fuzz' with '--lanes', '--seeds', '--ternary', "
+           "'--bfs' or '--vcd'");
+    if (event_driven || lazy || compile_mode || threads)
+      die ("can not combine '--fuzz' with '--event-driven', '--lazy', "
+           "'--compile' or '--threads'");
+  }
+  if (explorations)
+  {
+    if (!random_mode) die ("'--explore' requires random mode");
+    if (fake_bad >= 0 || fake_justice >= 0)
+      die ("can not fake properties with '--explore'");
+    if (lanes || seeds || ternary || bfs || fuzz_runs || dump_vcd)
+      die ("can not combine '--explore' with '--lanes', '--seeds', "
+           "'--ternary', '--bfs', '--fuzz' or '--vcd'");
+    if (event_driven || lazy || compile_mode || threads)
+      die ("can not combine '--explore' with '--event-driven', '--lazy', "
+           "'--compile' or '--threads'");
+  }
+  if (resample)
+  {
+    if (!random_mode && fork_step < 0)
+      die ("'--resample' requires random mode or '--fork'");
+    if (lanes || seeds || server_mode)
+      die ("can not combine '--resample' with '--lanes', '--seeds' or "
+           "'--server'");
+    if (ternary || bfs || fuzz_runs || explorations)
+      die ("can not combine '--resample' with '--ternary', '--bfs', "
+           "'--fuzz' or '--explore'");
+  }
+  if (compile_mode && !compile_dir)
+  {
+    /* a private per-user cache, shared temporary directories are unsafe */
+    static std::string dir;
+    const char *xdg = getenv ("XDG_CACHE_HOME"), *home = getenv ("HOME");
+    if (xdg && *xdg)
+      dir = xdg;
+    else if (home && *home)
+      dir = std::string (home) + "/.cache";
+    else
+      die ("'--compile' requires '--compile-dir', '$XDG_CACHE_HOME' or "
+           "'$HOME'");
+    if (mkdir (dir.c_str (), 0700) && errno != EEXIST)
+      die ("can not create directory '%s'", dir.c_str ());
+    dir += "/btorsim";
+    compile_dir = dir.c_str ();
   }
   if (dump_vcd)
   {
@@ -2011,32 +2608,67 @@ main (int32_t argc, char const *argv[])
       extra_constraints = vcd_writer->read_info_file (info_path);
     }
   }
+  if (threads) pool = new BtorSimThreadPool (threads);
   assert (model_path);
   msg (1, "reading BTOR model from '%s'", model_path);
-  parse_model ();
-  if (fake_bad >= (int64_t) bads.size ())
+  if (!model.parse (model_file, model_path)) die ("%s", model.error.c_str ());
+  if (fake_bad >= (int64_t) model.bads.size ())
     die ("invalid faked bad state property number %" PRId64, fake_bad);
-  if (fake_justice >= (int64_t) justices.size ())
+  if (fake_justice >= (int64_t) model.justices.size ())
     die ("invalid faked justice property number %" PRId64, fake_justice);
   if (close_model_file && fclose (model_file))
     die ("can not close model file '%s'", model_path);
-  setup_states ();
-  if (random_mode)
+  sim = new BtorSim (model);
+  if (dump_vcd) setup_vcd ();
+  if (lazy || compile_mode)
+  {
+    for (auto it : extra_constraints) model.tape.observe (it.first);
+    if (dump_vcd)
+      for (int64_t i = 0; i < model.num_format_lines; i++)
+      {
+        Btor2Line *l = btor2parser_get_line_by_id (model.parser, i);
+        if (l && l->symbol) model.tape.observe (i);
+      }
+  }
+  if (server_mode)
+    serve ();
+  else if (random_mode)
   {
     if (r < 0) r = 20;
     if (s < 0) s = 0;
     msg (1, "using random seed %d", s);
-    btorsim_rng_init (&rng, (uint32_t) s);
-    if (print_trace)
+    btorsim_rng_init (&sim->rng, (uint32_t) s);
+    if (coi_mode)
     {
-      if (fake_bad >= 0 && fake_justice >= 0)
-        printf ("sat\nb%" PRId64 " j%" PRId64 "\n", fake_bad, fake_justice);
-      else if (fake_bad >= 0)
-        printf ("sat\nb%" PRId64 "\n", fake_bad);
-      else if (fake_justice >= 0)
-        printf ("sat\nj%" PRId64 "\n", fake_justice);
+      std::vector<int64_t> selected_bads;
+      if (fake_bad >= 0) selected_bads.push_back (fake_bad);
+      prune_to_coi (selected_bads);
+    }
+    if (lanes)
+      lanes_simulation (r, (uint32_t) s, lanes);
+    else if (seeds)
+      seeds_simulation (r, first_seed, last_seed, jobs);
+    else if (ternary)
+      ternary_simulation (r);
+    else if (bfs)
+      bfs_search (r, (uint32_t) s, jobs);
+    else if (fuzz_runs)
+      fuzz_simulation (r, (uint32_t) s, fuzz_runs);
+    else if (explorations)
+      explore_simulation (r, (uint32_t) s, explorations);
+    else
+    {
+      if (print_trace)
+      {
+        if (fake_bad >= 0 && fake_justice >= 0)
+          printf ("sat\nb%" PRId64 " j%" PRId64 "\n", fake_bad, fake_justice);
+        else if (fake_bad >= 0)
+          printf ("sat\nb%" PRId64 "\n", fake_bad);
+        else if (fake_justice >= 0)
+          printf ("sat\nj%" PRId64 "\n", fake_justice);
+      }
+      random_simulation (r);
     }
-    random_simulation (r);
   }
   else
   {
@@ -2048,13 +2680,10 @@ main (int32_t argc, char const *argv[])
   }
   if (dump_vcd)
   {
-    vcd_writer->write_vcd (model);
+    vcd_writer->write_vcd (model.parser);
     delete vcd_writer;
   }
-  btor2parser_delete (model);
-  for (int64_t i = 0; i < num_format_lines; i++)
-    if (current_state[i].type) current_state[i].remove ();
-  for (int64_t i = 0; i < num_format_lines; i++)
-    if (next_state[i].type) next_state[i].remove ();
+  delete pool;
+  delete sim;
   return 0;
 }
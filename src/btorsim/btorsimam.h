@@ -51,6 +51,12 @@ struct BtorSimArrayModel
    */
   std::unordered_map<std::string, BtorSimBitVector*> data;
 
+  /* Arrays are not modified after they are constructed and initialized (all
+   * operations return copies), which allows to share them copy-on-write in
+   * snapshots of simulators.  The number of owners, not thread-safe.
+   */
+  uint32_t refs = 1;
+
   BtorSimArrayModel (uint64_t index_width, uint64_t element_width)
       : index_width (index_width), element_width (element_width){};
   BtorSimArrayModel (uint64_t index_width,
@@ -92,6 +98,18 @@ struct BtorSimArrayModel
   /* return a copy of the array */
   BtorSimArrayModel* copy () const;
 
+  /* share the array with another owner */
+  BtorSimArrayModel* share ()
+  {
+    refs++;
+    return this;
+  }
+  /* drop one owner, deletes the array with the last one */
+  void unshare ()
+  {
+    if (!--refs) delete this;
+  }
+
   /* equality checks test for:
    * - same global init (unless all elements were already accessed)
    * - same random seed (unless all elements were already accessed)
@@ -0,0 +1,434 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#include "btorsimbatch.h"
+
+#include <assert.h>
+
+#include "util/btor2mem.h"
+
+/*------------------------------------------------------------------------*/
+
+/* The kernels below are written as simple loops over the values of a batch
+ * so that the compiler vectorizes them.  On x86-64 ELF targets we
+ * additionally let the compiler emit AVX2 and AVX-512 versions, the best
+ * one for the host CPU is selected at load time. */
+
+#if defined(__x86_64__) && defined(__ELF__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define BTORSIM_BATCH_KERNEL \
+  __attribute__ ((target_clones ("avx512f", "avx2", "default")))
+#endif
+#endif
+#ifndef BTORSIM_BATCH_KERNEL
+#define BTORSIM_BATCH_KERNEL
+#endif
+
+/* number of values processed at once by kernels that need per-value
+ * temporaries, e.g., carries */
+#define BTORSIM_BATCH_BLOCK 64
+
+static uint64_t
+get_top_mask (uint32_t width)
+{
+  assert (width);
+  return width % 64 ? ((uint64_t) 1 << (width % 64)) - 1 : ~(uint64_t) 0;
+}
+
+/* 32-bit word 'k' of 'bv' starting from the LSB */
+static uint32_t
+get_word (const BtorSimBitVector *bv, uint32_t k)
+{
+  return k < bv->len ? bv->bits[bv->len - 1 - k] : 0;
+}
+
+/*------------------------------------------------------------------------*/
+
+void
+btorsim_bv_batch_set (uint32_t width,
+                      size_t n,
+                      uint64_t *out,
+                      size_t i,
+                      const BtorSimBitVector *bv)
+{
+  assert (out);
+  assert (i < n);
+  assert (bv);
+  assert (bv->width == width);
+
+  size_t j, nlimbs;
+
+  nlimbs = BTORSIM_BV_BATCH_LIMBS (width);
+  for (j = 0; j < nlimbs; j++)
+    out[j * n + i] = (uint64_t) get_word (bv, 2 * j)
+                     | (uint64_t) get_word (bv, 2 * j + 1) << 32;
+}
+
+BtorSimBitVector *
+btorsim_bv_batch_get (uint32_t width, size_t n, const uint64_t *in, size_t i)
+{
+  assert (in);
+  assert (i < n);
+
+  uint32_t k;
+  uint64_t limb;
+  BtorSimBitVector *res;
+
+  res = btorsim_bv_new (width);
+  for (k = 0; k < res->len; k++)
+  {
+    limb                         = in[(k / 2) * n + i];
+    res->bits[res->len - 1 - k] = (uint32_t) (k % 2 ? limb >> 32 : limb);
+  }
+  return res;
+}
+
+void
+btorsim_bv_batch_random (BtorSimRNG64 *rng,
+                         uint32_t width,
+                         size_t n,
+                         uint64_t *out)
+{
+  assert (rng);
+  assert (out);
+
+  size_t i, nlimbs, top;
+  uint64_t mask;
+
+  nlimbs = BTORSIM_BV_BATCH_LIMBS (width);
+  top    = (nlimbs - 1) * n;
+  mask   = get_top_mask (width);
+  btorsim_rng64_fill (rng, out, nlimbs * n);
+  for (i = top; i < top + n; i++) out[i] &= mask;
+}
+
+/*------------------------------------------------------------------------*/
+
+BTORSIM_BATCH_KERNEL void
+btorsim_bv_batch_not (uint32_t width,
+                      size_t n,
+                      const uint64_t *a,
+                      uint64_t *out)
+{
+  assert (a);
+  assert (out);
+
+  size_t i, nlimbs, top;
+  uint64_t mask;
+
+  nlimbs = BTORSIM_BV_BATCH_LIMBS (width);
+  top    = (nlimbs - 1) * n;
+  mask   = get_top_mask (width);
+  for (i = 0; i < top; i++) out[i] = ~a[i];
+  for (i = top; i < top + n; i++) out[i] = ~a[i] & mask;
+}
+
+BTORSIM_BATCH_KERNEL void
+btorsim_bv_batch_and (uint32_t width,
+                      size_t n,
+                      const uint64_t *a,
+                      const uint64_t *b,
+                      uint64_t *out)
+{
+  assert (a);
+  assert (b);
+  assert (out);
+
+  size_t i, size;
+
+  size = BTORSIM_BV_BATCH_LIMBS (width) * n;
+  for (i = 0; i < size; i++) out[i] = a[i] & b[i];
+}
+
+BTORSIM_BATCH_KERNEL void
+btorsim_bv_batch_or (uint32_t width,
+                     size_t n,
+                     const uint64_t *a,
+                     const uint64_t *b,
+                     uint64_t *out)
+{
+  assert (a);
+  assert (b);
+  assert (out);
+
+  size_t i, size;
+
+  size = BTORSIM_BV_BATCH_LIMBS (width) * n;
+  for (i = 0; i < size; i++) out[i] = a[i] | b[i];
+}
+
+BTORSIM_BATCH_KERNEL void
+btorsim_bv_batch_xor (uint32_t width,
+                      size_t n,
+                      const uint64_t *a,
+                      const uint64_t *b,
+                      uint64_t *out)
+{
+  assert (a);
+  assert (b);
+  assert (out);
+
+  size_t i, size;
+
+  size = BTORSIM_BV_BATCH_LIMBS (width) * n;
+  for (i = 0; i < size; i++) out[i] = a[i] ^ b[i];
+}
+
+/*------------------------------------------------------------------------*/
+
+/* out = ((a & ma) ^ xa) + ((b & mb) ^ xb) + cin, which covers addition,
+ * subtraction (xb = ~0, cin = 1) and negation (ma = 0, xb = ~0, cin = 1) */
+BTORSIM_BATCH_KERNEL static void
+add_batch (uint32_t width,
+           size_t n,
+           const uint64_t *a,
+           uint64_t ma,
+           uint64_t xa,
+           const uint64_t *b,
+           uint64_t mb,
+           uint64_t xb,
+           uint64_t cin,
+           uint64_t *out)
+{
+  size_t i, i0, j, m, nlimbs;
+  uint64_t carry[BTORSIM_BATCH_BLOCK], mask, x, y, s, c;
+  const uint64_t *pa, *pb;
+  uint64_t *po;
+
+  nlimbs = BTORSIM_BV_BATCH_LIMBS (width);
+  mask   = get_top_mask (width);
+  for (i0 = 0; i0 < n; i0 += BTORSIM_BATCH_BLOCK)
+  {
+    m = n - i0 < BTORSIM_BATCH_BLOCK ? n - i0 : BTORSIM_BATCH_BLOCK;
+    for (i = 0; i < m; i++) carry[i] = cin;
+    for (j = 0; j < nlimbs; j++)
+    {
+      pa = a + j * n + i0;
+      pb = b + j * n + i0;
+      po = out + j * n + i0;
+      for (i = 0; i < m; i++)
+      {
+        x = (pa[i] & ma) ^ xa;
+        y = (pb[i] & mb) ^ xb;
+        s = x + y;
+        c = s < x;
+        s += carry[i];
+        c |= s < carry[i];
+        carry[i] = c;
+        po[i]    = s;
+      }
+    }
+    po = out + (nlimbs - 1) * n + i0;
+    for (i = 0; i < m; i++) po[i] &= mask;
+  }
+}
+
+void
+btorsim_bv_batch_add (uint32_t width,
+                      size_t n,
+                      const uint64_t *a,
+                      const uint64_t *b,
+                      uint64_t *out)
+{
+  assert (a);
+  assert (b);
+  assert (out);
+  add_batch (width, n, a, ~(uint64_t) 0, 0, b, ~(uint64_t) 0, 0, 0, out);
+}
+
+void
+btorsim_bv_batch_sub (uint32_t width,
+                      size_t n,
+                      const uint64_t *a,
+                      const uint64_t *b,
+                      uint64_t *out)
+{
+  assert (a);
+  assert (b);
+  assert (out);
+  add_batch (width,
+             n,
+             a,
+             ~(uint64_t) 0,
+             0,
+             b,
+             ~(uint64_t) 0,
+             ~(uint64_t) 0,
+             1,
+             out);
+}
+
+void
+btorsim_bv_batch_neg (uint32_t width,
+                      size_t n,
+                      const uint64_t *a,
+                      uint64_t *out)
+{
+  assert (a);
+  assert (out);
+  add_batch (width, n, a, 0, 0, a, ~(uint64_t) 0, ~(uint64_t) 0, 1, out);
+}
+
+/*------------------------------------------------------------------------*/
+
+BTORSIM_BATCH_KERNEL static void
+mul_batch_single_limb (size_t n,
+                       uint64_t mask,
+                       const uint64_t *a,
+                       const uint64_t *b,
+                       uint64_t *out)
+{
+  size_t i;
+  for (i = 0; i < n; i++) out[i] = (a[i] * b[i]) & mask;
+}
+
+void
+btorsim_bv_batch_mul (uint32_t width,
+                      size_t n,
+                      const uint64_t *a,
+                      const uint64_t *b,
+                      uint64_t *out)
+{
+  assert (a);
+  assert (b);
+  assert (out);
+
+  size_t i, j, k, nlimbs, nwords;
+  uint32_t *wa, *wb, *wr;
+  uint64_t x;
+
+  nlimbs = BTORSIM_BV_BATCH_LIMBS (width);
+  if (nlimbs == 1)
+  {
+    mul_batch_single_limb (n, get_top_mask (width), a, b, out);
+    return;
+  }
+
+  /* schoolbook multiplication of 32-bit words truncated to the bit-width,
+   * one value at a time */
+  nwords = 2 * nlimbs;
+  BTOR2_NEWN (wa, 3 * nwords);
+  wb = wa + nwords;
+  wr = wb + nwords;
+  for (i = 0; i < n; i++)
+  {
+    for (j = 0; j < nlimbs; j++)
+    {
+      wa[2 * j]     = (uint32_t) a[j * n + i];
+      wa[2 * j + 1] = (uint32_t) (a[j * n + i] >> 32);
+      wb[2 * j]     = (uint32_t) b[j * n + i];
+      wb[2 * j + 1] = (uint32_t) (b[j * n + i] >> 32);
+    }
+    BTOR2_CLRN (wr, nwords);
+    for (j = 0; j < nwords; j++)
+    {
+      if (!wa[j]) continue;
+      for (k = 0, x = 0; j + k < nwords; k++)
+      {
+        x += (uint64_t) wa[j] * wb[k] + wr[j + k];
+        wr[j + k] = (uint32_t) x;
+        x >>= 32;
+      }
+    }
+    for (j = 0; j < nlimbs; j++)
+      out[j * n + i] = (uint64_t) wr[2 * j] | (uint64_t) wr[2 * j + 1] << 32;
+    out[(nlimbs - 1) * n + i] &= get_top_mask (width);
+  }
+  BTOR2_DELETE (wa);
+}
+
+/*------------------------------------------------------------------------*/
+
+BTORSIM_BATCH_KERNEL void
+btorsim_bv_batch_eq (uint32_t width,
+                     size_t n,
+                     const uint64_t *a,
+                     const uint64_t *b,
+                     uint64_t *out)
+{
+  assert (a);
+  assert (b);
+  assert (out);
+
+  size_t i, i0, j, m, nlimbs;
+  uint64_t diff[BTORSIM_BATCH_BLOCK];
+  const uint64_t *pa, *pb;
+
+  nlimbs = BTORSIM_BV_BATCH_LIMBS (width);
+  for (i0 = 0; i0 < n; i0 += BTORSIM_BATCH_BLOCK)
+  {
+    m = n - i0 < BTORSIM_BATCH_BLOCK ? n - i0 : BTORSIM_BATCH_BLOCK;
+    for (i = 0; i < m; i++) diff[i] = 0;
+    for (j = 0; j < nlimbs; j++)
+    {
+      pa = a + j * n + i0;
+      pb = b + j * n + i0;
+      for (i = 0; i < m; i++) diff[i] |= pa[i] ^ pb[i];
+    }
+    for (i = 0; i < m; i++) out[i0 + i] = diff[i] == 0;
+  }
+}
+
+BTORSIM_BATCH_KERNEL void
+btorsim_bv_batch_ult (uint32_t width,
+                      size_t n,
+                      const uint64_t *a,
+                      const uint64_t *b,
+                      uint64_t *out)
+{
+  assert (a);
+  assert (b);
+  assert (out);
+
+  size_t i, i0, j, m, nlimbs;
+  uint64_t lt[BTORSIM_BATCH_BLOCK];
+  const uint64_t *pa, *pb;
+
+  nlimbs = BTORSIM_BV_BATCH_LIMBS (width);
+  for (i0 = 0; i0 < n; i0 += BTORSIM_BATCH_BLOCK)
+  {
+    m = n - i0 < BTORSIM_BATCH_BLOCK ? n - i0 : BTORSIM_BATCH_BLOCK;
+    for (i = 0; i < m; i++) lt[i] = 0;
+    /* more significant limbs override the result of less significant ones */
+    for (j = 0; j < nlimbs; j++)
+    {
+      pa = a + j * n + i0;
+      pb = b + j * n + i0;
+      for (i = 0; i < m; i++)
+        lt[i] = (pa[i] < pb[i]) | ((pa[i] == pb[i]) & lt[i]);
+    }
+    for (i = 0; i < m; i++) out[i0 + i] = lt[i];
+  }
+}
+
+BTORSIM_BATCH_KERNEL void
+btorsim_bv_batch_ite (uint32_t width,
+                      size_t n,
+                      const uint64_t *c,
+                      const uint64_t *a,
+                      const uint64_t *b,
+                      uint64_t *out)
+{
+  assert (c);
+  assert (a);
+  assert (b);
+  assert (out);
+
+  size_t i, j, nlimbs;
+  uint64_t mask;
+
+  /* the least significant limbs last, as 'out' may be the same as 'c' */
+  nlimbs = BTORSIM_BV_BATCH_LIMBS (width);
+  for (j = nlimbs; j-- > 0;)
+    for (i = 0; i < n; i++)
+    {
+      mask           = -(c[i] & 1);
+      out[j * n + i] = (a[j * n + i] & mask) | (b[j * n + i] & ~mask);
+    }
+}
@@ -0,0 +1,123 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#ifndef BTOR2BATCH_H_INCLUDED
+#define BTOR2BATCH_H_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "btorsimbv.h"
+
+#if __cplusplus
+extern "C" {
+#endif
+
+/* Batched operations on 'n' bit-vectors of the same bit-width 'width'.
+ *
+ * Batches are stored as structure of arrays: each value consists of
+ * BTORSIM_BV_BATCH_LIMBS (width) 64-bit limbs, least significant limb first,
+ * and limb 'j' of value 'i' is stored at index 'j * n + i'.  Bits above
+ * 'width' in the most significant limb are zero, the kernels expect this
+ * of their inputs and guarantee it for their results.
+ *
+ * Results of 'eq' and 'ult' are 1-bit values, i.e., one limb per value, and
+ * the condition of 'ite' is a batch of 1-bit values.
+ *
+ * The output batch may be the same as an input batch. */
+
+#define BTORSIM_BV_BATCH_LIMBS(width) (((size_t) (width) + 63) / 64)
+
+/* store 'bv' as value 'i' of batch 'out' */
+void btorsim_bv_batch_set (uint32_t width,
+                           size_t n,
+                           uint64_t *out,
+                           size_t i,
+                           const BtorSimBitVector *bv);
+/* return a new bit-vector for value 'i' of batch 'in' */
+BtorSimBitVector *btorsim_bv_batch_get (uint32_t width,
+                                        size_t n,
+                                        const uint64_t *in,
+                                        size_t i);
+
+/* fill batch 'out' with random values */
+void btorsim_bv_batch_random (BtorSimRNG64 *rng,
+                              uint32_t width,
+                              size_t n,
+                              uint64_t *out);
+
+void btorsim_bv_batch_not (uint32_t width,
+                           size_t n,
+                           const uint64_t *a,
+                           uint64_t *out);
+
+void btorsim_bv_batch_neg (uint32_t width,
+                           size_t n,
+                           const uint64_t *a,
+                           uint64_t *out);
+
+void btorsim_bv_batch_and (uint32_t width,
+                           size_t n,
+                           const uint64_t *a,
+                           const uint64_t *b,
+                           uint64_t *out);
+
+void btorsim_bv_batch_or (uint32_t width,
+                          size_t n,
+                          const uint64_t *a,
+                          const uint64_t *b,
+                          uint64_t *out);
+
+void btorsim_bv_batch_xor (uint32_t width,
+                           size_t n,
+                           const uint64_t *a,
+                           const uint64_t *b,
+                           uint64_t *out);
+
+void btorsim_bv_batch_add (uint32_t width,
+                           size_t n,
+                           const uint64_t *a,
+                           const uint64_t *b,
+                           uint64_t *out);
+
+void btorsim_bv_batch_sub (uint32_t width,
+                           size_t n,
+                           const uint64_t *a,
+                           const uint64_t *b,
+                           uint64_t *out);
+
+void btorsim_bv_batch_mul (uint32_t width,
+                           size_t n,
+                           const uint64_t *a,
+                           const uint64_t *b,
+                           uint64_t *out);
+
+void btorsim_bv_batch_eq (uint32_t width,
+                          size_t n,
+                          const uint64_t *a,
+                          const uint64_t *b,
+                          uint64_t *out);
+
+void btorsim_bv_batch_ult (uint32_t width,
+                           size_t n,
+                           const uint64_t *a,
+                           const uint64_t *b,
+                           uint64_t *out);
+
+void btorsim_bv_batch_ite (uint32_t width,
+                           size_t n,
+                           const uint64_t *c,
+                           const uint64_t *a,
+                           const uint64_t *b,
+                           uint64_t *out);
+
+#if __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,481 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#include "btorsimbfs.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+
+#include "btorsimhelpers.h"
+#include "btorsimthreads.h"
+
+/*------------------------------------------------------------------------*/
+
+/* bit-vectors of at most 64 bits at bit 'offset' of packed 'words' */
+static uint64_t
+get_bits (const uint64_t *words, uint32_t offset, uint32_t width)
+{
+  assert (0 < width), assert (width <= 64);
+  uint32_t i = offset / 64, shift = offset % 64;
+  uint64_t res = words[i] >> shift;
+  if (shift && shift + width > 64) res |= words[i + 1] << (64 - shift);
+  return width == 64 ? res : res & (((uint64_t) 1 << width) - 1);
+}
+
+/* the bits at 'offset' have to be 0 */
+static void
+put_bits (uint64_t *words, uint32_t offset, uint32_t width, uint64_t value)
+{
+  assert (0 < width), assert (width <= 64);
+  assert (width == 64 || !(value >> width));
+  uint32_t i = offset / 64, shift = offset % 64;
+  words[i] |= value << shift;
+  if (shift && shift + width > 64) words[i + 1] |= value >> (64 - shift);
+}
+
+static uint32_t
+num_words (uint64_t bits)
+{
+  return std::max<uint64_t> (1, (bits + 63) / 64);
+}
+
+static uint64_t
+mix (uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSimVisitedSet::BtorSimVisitedSet (uint32_t num_words, size_t max_bytes)
+    : num_words (num_words), max_bytes (max_bytes)
+{
+  assert (num_words);
+  table.assign (1024, -1);
+}
+
+uint64_t
+BtorSimVisitedSet::hash (const uint64_t *state, uint64_t seed) const
+{
+  uint64_t res = mix (seed + 0x9e3779b97f4a7c15ull);
+  for (uint32_t i = 0; i < num_words; i++) res = mix (res ^ state[i]);
+  return res;
+}
+
+size_t
+BtorSimVisitedSet::bytes () const
+{
+  if (bitstate) return bits.size () * sizeof (uint64_t);
+  return (states.capacity () + table.size ()) * sizeof (uint64_t);
+}
+
+bool
+BtorSimVisitedSet::insert (const uint64_t *state)
+{
+  if (bitstate)
+  {
+    if (!insert_bitstate (state)) return false;
+    count++;
+    return true;
+  }
+
+  uint64_t mask = table.size () - 1, b;
+  for (b = hash (state, 0) & mask; table[b] >= 0; b = (b + 1) & mask)
+    if (!memcmp (&states[table[b] * num_words], state, num_words * 8))
+      return false;
+  table[b] = count++;
+  states.insert (states.end (), state, state + num_words);
+  if (2 * count > table.size ()) enlarge ();
+  if (bytes () > max_bytes) switch_to_bitstate ();
+  return true;
+}
+
+void
+BtorSimVisitedSet::enlarge ()
+{
+  table.assign (2 * table.size (), -1);
+  uint64_t mask = table.size () - 1;
+  for (size_t i = 0; i < count; i++)
+  {
+    uint64_t b = hash (&states[i * num_words], 0) & mask;
+    while (table[b] >= 0) b = (b + 1) & mask;
+    table[b] = i;
+  }
+}
+
+/* Each state sets the bits 'h1 + i * h2' for 'i < 3' (double hashing). */
+bool
+BtorSimVisitedSet::insert_bitstate (const uint64_t *state)
+{
+  uint64_t mask = bits.size () * 64 - 1;
+  uint64_t h1 = hash (state, 1), h2 = hash (state, 2) | 1;
+  bool res = false;
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    uint64_t pos = (h1 + i * h2) & mask, bit = (uint64_t) 1 << (pos % 64);
+    if (bits[pos / 64] & bit) continue;
+    bits[pos / 64] |= bit;
+    res = true;
+  }
+  return res;
+}
+
+void
+BtorSimVisitedSet::switch_to_bitstate ()
+{
+  size_t n = 1;
+  while (2 * n * sizeof (uint64_t) <= max_bytes) n *= 2;
+  msg (1,
+       "switching to bitstate hashing with %zu bytes after %zu states",
+       n * sizeof (uint64_t),
+       count);
+  bits.assign (n, 0);
+  bitstate = true;
+  for (size_t i = 0; i < count; i++) insert_bitstate (&states[i * num_words]);
+  std::vector<uint64_t> ().swap (states);
+  std::vector<int64_t> ().swap (table);
+}
+
+/*------------------------------------------------------------------------*/
+
+/* A range of the frontier expanded by one thread, with its successors (the
+ * parent node, label and state of each) and the first step reaching a bad
+ * state property. */
+struct BtorSimBFS::Chunk
+{
+  size_t begin, end;
+  std::vector<uint64_t> successors;
+  int64_t hit_node = -1, hit_bad = -1;
+  std::vector<uint64_t> hit_label;
+};
+
+static uint64_t
+count_state_bits (const BtorSimModel &model)
+{
+  uint64_t res = 0;
+  for (auto state : model.states) res += state->sort.bitvec.width;
+  return res;
+}
+
+BtorSimBFS::BtorSimBFS (BtorSimModel &model, const Options &options)
+    : model (model),
+      options (options),
+      state_words (num_words (count_state_bits (model))),
+      visited (state_words, options.max_bytes)
+{
+  assert (options.depth >= 0), assert (options.num_threads > 0);
+  assert (options.max_choice_bits < 64);
+
+  uint32_t offset = 0;
+  for (auto state : model.states)
+  {
+    uint32_t width = state->sort.bitvec.width;
+    state_offset.push_back (offset);
+    offset += width;
+    if (model.inits[state->id]) continue;
+    uninit.push_back (state);
+    uninit_offset.push_back (uninit_bits);
+    uninit_bits += width;
+  }
+  for (auto input : model.inputs)
+  {
+    input_offset.push_back (input_bits);
+    input_bits += input->sort.bitvec.width;
+  }
+  label_words = num_words (std::max (input_bits, uninit_bits));
+
+  for (uint32_t t = 0; t < options.num_threads; t++)
+    sims.emplace_back (new BtorSim (model));
+}
+
+BtorSimBFS::~BtorSimBFS () {}
+
+bool
+BtorSimBFS::supports (const BtorSimModel &model, std::string &error)
+{
+  for (auto lines : {&model.inputs, &model.states})
+    for (auto l : *lines)
+      if (l->sort.tag != BTOR2_TAG_SORT_bitvec || l->sort.bitvec.width > 64)
+      {
+        error = "only bit-vectors of at most 64 bits and no arrays supported";
+        return false;
+      }
+  for (auto state : model.states)
+    if (!model.nexts[state->id])
+    {
+      error = "state " + std::to_string (state->id) + " without next function";
+      return false;
+    }
+  return true;
+}
+
+/*------------------------------------------------------------------------*/
+
+/* Set 'label' to the values of 'lines' at bit 'offsets': the bits of
+ * combination 'choice' if they are enumerated, otherwise random values. */
+void
+BtorSimBFS::choose (uint64_t *label,
+                    uint32_t bits,
+                    const std::vector<uint32_t> &offsets,
+                    const std::vector<Btor2Line *> &lines,
+                    uint64_t choice,
+                    BtorSimRNG64 *rng) const
+{
+  std::fill (label, label + label_words, 0);
+  if (!rng)
+  {
+    if (bits) put_bits (label, 0, bits, choice);
+    return;
+  }
+  for (size_t i = 0; i < lines.size (); i++)
+  {
+    uint32_t width = lines[i]->sort.bitvec.width;
+    uint64_t value = btorsim_rng64_rand (rng);
+    if (width < 64) value &= ((uint64_t) 1 << width) - 1;
+    put_bits (label, offsets[i], width, value);
+  }
+}
+
+void
+BtorSimBFS::initial_states ()
+{
+  BtorSim &sim   = *sims[0];
+  bool enumerate = uninit_bits <= options.max_choice_bits;
+  uint32_t bits  = enumerate ? uninit_bits : options.max_choice_bits;
+  uint64_t n     = (uint64_t) 1 << bits;
+  if (!enumerate) exhaustive = false;
+
+  BtorSimRNG64 rng;
+  btorsim_rng64_init (&rng, options.seed);
+  std::vector<uint64_t> label (label_words), state (state_words);
+  for (uint64_t c = 0; c < n; c++)
+  {
+    choose (label.data (),
+            uninit_bits,
+            uninit_offset,
+            uninit,
+            c,
+            enumerate ? nullptr : &rng);
+    sim.reset ();
+    for (size_t j = 0; j < uninit.size (); j++)
+      sim.current_state[uninit[j]->id].update_word (get_bits (
+          label.data (), uninit_offset[j], uninit[j]->sort.bitvec.width));
+    std::fill (state.begin (), state.end (), 0);
+    for (size_t j = 0; j < model.states.size (); j++)
+    {
+      Btor2Line *l = model.states[j];
+      sim.initialize_state (j, false);
+      put_bits (state.data (),
+                state_offset[j],
+                l->sort.bitvec.width,
+                sim.current_state[l->id].bv_word);
+    }
+    if (!visited.insert (state.data ())) continue;
+    frontier.push_back (parents.size ());
+    frontier_states.insert (
+        frontier_states.end (), state.begin (), state.end ());
+    parents.push_back (-1);
+    labels.insert (labels.end (), label.begin (), label.end ());
+  }
+  sim.reset ();
+}
+
+/* Evaluate all choices of inputs of the frontier states of 'chunk' at
+ * 'step', until a bad state property is reached. */
+void
+BtorSimBFS::expand (BtorSim &sim, Chunk &chunk, int64_t step, bool successors)
+{
+  const BtorSimTape &tape = model.tape;
+  bool enumerate          = input_bits <= options.max_choice_bits;
+  uint32_t bits           = enumerate ? input_bits : options.max_choice_bits;
+  uint64_t n              = (uint64_t) 1 << bits;
+
+  std::vector<uint64_t> label (label_words), next (state_words);
+  for (size_t f = chunk.begin; f < chunk.end; f++)
+  {
+    int64_t node          = frontier[f];
+    const uint64_t *state = &frontier_states[f * state_words];
+    for (size_t j = 0; j < model.states.size (); j++)
+    {
+      Btor2Line *l = model.states[j];
+      sim.current_state[l->id].update_word (
+          get_bits (state, state_offset[j], l->sort.bitvec.width));
+    }
+
+    /* random choices only depend on the seed and the position of the state
+     * in the search */
+    BtorSimRNG64 rng;
+    if (!enumerate)
+      btorsim_rng64_init (&rng, mix (options.seed ^ mix (step)) ^ f);
+
+    for (uint64_t c = 0; c < n; c++)
+    {
+      choose (label.data (),
+              input_bits,
+              input_offset,
+              model.inputs,
+              c,
+              enumerate ? nullptr : &rng);
+      for (size_t i = 0; i < model.inputs.size (); i++)
+      {
+        Btor2Line *l = model.inputs[i];
+        sim.current_state[l->id].update_word (
+            get_bits (label.data (), input_offset[i], l->sort.bitvec.width));
+      }
+      sim.execute ();
+
+      bool violated = false;
+      for (auto constraint : model.constraints)
+        if (!sim.current_state[tape.slot (constraint->args[0])].bv_word)
+          violated = true;
+      if (violated) continue;
+
+      for (size_t j = 0; j < model.bads.size (); j++)
+      {
+        Btor2Line *bad = model.bads[j];
+        if (!tape.in_coi (bad->id)) continue;
+        if (!sim.current_state[tape.slot (bad->args[0])].bv_word) continue;
+        chunk.hit_node  = node;
+        chunk.hit_bad   = j;
+        chunk.hit_label = label;
+        return;
+      }
+      if (!successors) continue;
+
+      /* states outside of the cone of influence keep their values */
+      std::fill (next.begin (), next.end (), 0);
+      for (size_t j = 0; j < model.states.size (); j++)
+      {
+        Btor2Line *l   = model.states[j];
+        uint32_t width = l->sort.bitvec.width;
+        uint64_t value = get_bits (state, state_offset[j], width);
+        if (tape.in_coi (l->id))
+          value = sim.current_state[tape.slot (model.nexts[l->id]->args[1])]
+                      .bv_word;
+        put_bits (next.data (), state_offset[j], width, value);
+      }
+      chunk.successors.push_back (node);
+      chunk.successors.insert (
+          chunk.successors.end (), label.begin (), label.end ());
+      chunk.successors.insert (
+          chunk.successors.end (), next.begin (), next.end ());
+    }
+  }
+}
+
+void
+BtorSimBFS::make_witness (int64_t node, const uint64_t *label)
+{
+  std::vector<int64_t> path;
+  for (int64_t i = node; i >= 0; i = parents[i]) path.push_back (i);
+  std::reverse (path.begin (), path.end ());
+
+  witness_states.assign (model.states.size (), 0);
+  const uint64_t *initial = &labels[path[0] * label_words];
+  for (size_t j = 0, k = 0; j < model.states.size (); j++)
+  {
+    Btor2Line *l = model.states[j];
+    if (model.inits[l->id]) continue;
+    witness_states[j] =
+        get_bits (initial, uninit_offset[k++], l->sort.bitvec.width);
+  }
+
+  witness_inputs.clear ();
+  for (size_t t = 1; t <= path.size (); t++)
+  {
+    const uint64_t *l =
+        t < path.size () ? &labels[path[t] * label_words] : label;
+    witness_inputs.emplace_back ();
+    for (size_t i = 0; i < model.inputs.size (); i++)
+      witness_inputs.back ().push_back (get_bits (
+          l, input_offset[i], model.inputs[i]->sort.bitvec.width));
+  }
+}
+
+bool
+BtorSimBFS::search ()
+{
+  initial_states ();
+  msg (1, "starting search from %zu initial states", frontier.size ());
+
+  BtorSimThreadPool pool (options.num_threads);
+  uint64_t choices = (uint64_t) 1 << std::min (input_bits,
+                                               options.max_choice_bits);
+  if (input_bits > options.max_choice_bits) exhaustive = false;
+  size_t chunk_size = std::max<uint64_t> (1, 4096 / choices);
+  size_t batch      = 16 * options.num_threads;
+  size_t record     = 1 + label_words + state_words;
+
+  for (int64_t step = 0; step <= options.depth && !frontier.empty (); step++)
+  {
+    bool successors = step < options.depth;
+    std::vector<int64_t> next_frontier;
+    std::vector<uint64_t> next_states;
+    size_t num_chunks = (frontier.size () + chunk_size - 1) / chunk_size;
+    for (size_t first = 0; first < num_chunks; first += batch)
+    {
+      std::vector<Chunk> chunks (std::min (batch, num_chunks - first));
+      for (size_t i = 0; i < chunks.size (); i++)
+      {
+        chunks[i].begin = (first + i) * chunk_size;
+        chunks[i].end =
+            std::min (frontier.size (), chunks[i].begin + chunk_size);
+      }
+      std::atomic<size_t> next_chunk (0);
+      pool.run ([&] (uint32_t t) {
+        for (size_t i; (i = next_chunk.fetch_add (1)) < chunks.size ();)
+          expand (*sims[t], chunks[i], step, successors);
+      });
+
+      for (Chunk &chunk : chunks)
+      {
+        const std::vector<uint64_t> &succ = chunk.successors;
+        for (size_t i = 0; i < succ.size (); i += record)
+        {
+          const uint64_t *state = &succ[i + 1 + label_words];
+          if (!visited.insert (state)) continue;
+          next_frontier.push_back (parents.size ());
+          next_states.insert (next_states.end (), state, state + state_words);
+          parents.push_back (succ[i]);
+          labels.insert (labels.end (),
+                         succ.begin () + i + 1,
+                         succ.begin () + i + 1 + label_words);
+        }
+        if (chunk.hit_bad < 0) continue;
+        reached_bad = chunk.hit_bad;
+        make_witness (chunk.hit_node, chunk.hit_label.data ());
+        if (visited.is_bitstate ()) exhaustive = false;
+        return true;
+      }
+    }
+
+    explored_depth = step;
+    if (!successors) break;
+    if (next_frontier.empty ()) saturated = true;
+    msg (1,
+         "explored step %" PRId64 ": %zu new states, %zu visited states "
+         "(%zu bytes)",
+         step,
+         next_frontier.size (),
+         visited.size (),
+         visited.bytes ());
+    frontier.swap (next_frontier);
+    frontier_states.swap (next_states);
+  }
+  if (visited.is_bitstate ()) exhaustive = false;
+  return false;
+}
@@ -0,0 +1,151 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#ifndef BTOR2BFS_H_INCLUDED
+#define BTOR2BFS_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "btorsimengine.h"
+
+/* Set of visited states packed into 'num_words' words each.  States are
+ * stored exactly until the set takes more than 'max_bytes' bytes, then the
+ * set switches to bitstate hashing: a bit array of 'max_bytes' bytes, in
+ * which every state sets 3 bits.  States whose bits are all set are
+ * considered visited, which (rarely) also holds for unvisited states. */
+class BtorSimVisitedSet
+{
+ public:
+  BtorSimVisitedSet (uint32_t num_words, size_t max_bytes);
+
+  /* insert 'state', returns false if it was already (considered) visited */
+  bool insert (const uint64_t *state);
+
+  size_t size () const { return count; }
+  bool is_bitstate () const { return bitstate; }
+  size_t bytes () const;
+
+ private:
+  uint32_t num_words;
+  size_t max_bytes;
+  size_t count  = 0;
+  bool bitstate = false;
+
+  /* exact: the states one after the other, and an open addressing table of
+   * their indices (-1 for empty buckets) with a power of two size */
+  std::vector<uint64_t> states;
+  std::vector<int64_t> table;
+  /* bitstate: bit array with a power of two size */
+  std::vector<uint64_t> bits;
+
+  uint64_t hash (const uint64_t *state, uint64_t seed) const;
+  bool insert_bitstate (const uint64_t *state);
+  void enlarge ();
+  void switch_to_bitstate ();
+};
+
+/* Explicit-state breadth-first search ('btorsim --bfs') for models with few
+ * state bits, which explores all states reachable in up to 'depth' steps
+ * until a bad state property is reached.
+ *
+ * States are packed into bit-vectors of all states (in declaration order).
+ * Initial states are all combinations of the values of states without init,
+ * and successors of a state are computed for all combinations of input
+ * values.  If there are more than 'max_choice_bits' bits to choose,
+ * 2^'max_choice_bits' random combinations are drawn instead.  Steps
+ * violating constraints have no successors and do not reach bad states.
+ * Layers are expanded by 'num_threads' threads on their own simulators
+ * ('BtorSim'), in chunks of states whose successors are merged into the
+ * visited set in the order of the layer, such that results do not depend on
+ * the number of threads.  The first bad state property reached is thus
+ * reached on a shortest path.
+ *
+ * Only models with bit-vectors of at most 64 bits, without arrays and with
+ * next functions of all states are supported. */
+class BtorSimBFS
+{
+ public:
+  struct Options
+  {
+    int64_t depth            = 20;
+    uint32_t num_threads     = 1;
+    uint32_t max_choice_bits = 12;
+    size_t max_bytes         = (size_t) 1 << 30;
+    uint64_t seed            = 0;
+  };
+
+  BtorSimBFS (BtorSimModel &model, const Options &options);
+  ~BtorSimBFS ();
+
+  /* whether 'model' is supported, otherwise the reason is in 'error' */
+  static bool supports (const BtorSimModel &model, std::string &error);
+
+  /* search for a bad state property, returns whether one was reached */
+  bool search ();
+
+  /* the reached bad state property and the shortest path reaching it: the
+   * values of states at step 0 (by position), and of inputs at steps 0 to
+   * 'witness_inputs.size () - 1' (by position) */
+  int64_t reached_bad = -1;
+  std::vector<uint64_t> witness_states;
+  std::vector<std::vector<uint64_t>> witness_inputs;
+
+  /* the number of visited states and the last fully explored step, and
+   * whether all choices were enumerated and states stored exactly, and
+   * whether no new states were found (i.e. all reachable states were
+   * visited if 'exhaustive') */
+  size_t num_states () const { return visited.size (); }
+  int64_t explored_depth = -1;
+  bool exhaustive        = true;
+  bool saturated         = false;
+  bool is_bitstate () const { return visited.is_bitstate (); }
+
+ private:
+  struct Chunk;
+
+  BtorSimModel &model;
+  Options options;
+  std::vector<std::unique_ptr<BtorSim>> sims;
+
+  /* bit offsets of states and inputs, and of the states without init in
+   * labels of initial states */
+  std::vector<uint32_t> state_offset, input_offset, uninit_offset;
+  std::vector<Btor2Line *> uninit;
+  uint32_t state_words, label_words;
+  uint32_t input_bits = 0, uninit_bits = 0;
+
+  BtorSimVisitedSet visited;
+
+  /* Every visited state is a node of the search tree, with the node of its
+   * predecessor (-1 for initial states) and its label, i.e., the values of
+   * the inputs of the step from its predecessor or, for initial states, the
+   * values of states without init. */
+  std::vector<int64_t> parents;
+  std::vector<uint64_t> labels;
+
+  /* the frontier, i.e., the nodes of the current layer and their states */
+  std::vector<int64_t> frontier;
+  std::vector<uint64_t> frontier_states;
+
+  void initial_states ();
+  void choose (uint64_t *label,
+               uint32_t bits,
+               const std::vector<uint32_t> &offsets,
+               const std::vector<Btor2Line *> &lines,
+               uint64_t choice,
+               BtorSimRNG64 *rng) const;
+  void expand (BtorSim &sim, Chunk &chunk, int64_t step, bool successors);
+  void make_witness (int64_t node, const uint64_t *label);
+};
+
+#endif
@@ -66,6 +66,56 @@ set_rem_bits_to_zero (BtorSimBitVector *bv)
     bv->bits[0] &= BTOR2_MASK_REM_BITS (bv);
 }
 
+/* Word-level helpers.  Words are addressed from the LSB, i.e., word 'i' is
+ * bits[len - 1 - i] and holds bits [i * BTORSIM_BV_TYPE_BW, (i + 1) *
+ * BTORSIM_BV_TYPE_BW - 1] of the bit vector. */
+
+#define BTOR2_WORD(bv, i) ((bv)->bits[(bv)->len - 1 - (i)])
+
+/* mask selecting bits [lo, up] of the bit vector within word 'i' */
+static BTORSIM_BV_TYPE
+bit_range_mask (uint32_t i, uint32_t up, uint32_t lo)
+{
+  BTORSIM_BV_TYPE res;
+  uint32_t ulo, uup;
+
+  ulo = lo / BTORSIM_BV_TYPE_BW;
+  uup = up / BTORSIM_BV_TYPE_BW;
+  if (i < ulo || i > uup) return 0;
+  res = ~(BTORSIM_BV_TYPE) 0;
+  if (i == ulo) res &= res << (lo % BTORSIM_BV_TYPE_BW);
+  if (i == uup && up % BTORSIM_BV_TYPE_BW != BTORSIM_BV_TYPE_BW - 1)
+    res &= ((BTORSIM_BV_TYPE) 1 << (up % BTORSIM_BV_TYPE_BW + 1)) - 1;
+  return res;
+}
+
+/* the BTORSIM_BV_TYPE_BW bits starting at bit 'pos', bits beyond the width of
+ * the bit vector read as zero (funnel shift of two adjacent words) */
+static BTORSIM_BV_TYPE
+get_word_at (const BtorSimBitVector *bv, uint64_t pos)
+{
+  uint64_t i;
+  uint32_t k;
+  BTORSIM_BV_TYPE lo, hi;
+
+  i = pos / BTORSIM_BV_TYPE_BW;
+  k = pos % BTORSIM_BV_TYPE_BW;
+  lo = i < bv->len ? BTOR2_WORD (bv, i) : 0;
+  if (k == 0) return lo;
+  hi = i + 1 < bv->len ? BTOR2_WORD (bv, i + 1) : 0;
+  return (lo >> k) | (hi << (BTORSIM_BV_TYPE_BW - k));
+}
+
+/* same as get_word_at but 'pos' may be negative, bits below the LSB read as
+ * zero */
+static BTORSIM_BV_TYPE
+get_word_at_signed (const BtorSimBitVector *bv, int64_t pos)
+{
+  if (pos >= 0) return get_word_at (bv, pos);
+  if (pos <= -(int64_t) BTORSIM_BV_TYPE_BW) return 0;
+  return get_word_at (bv, 0) << -pos;
+}
+
 /*------------------------------------------------------------------------*/
 
 BtorSimBitVector *
@@ -108,8 +158,8 @@ btorsim_bv_new_random_bit_range (BtorSimRNG *rng,
   res->bits[0] = (BTORSIM_BV_TYPE) btorsim_rng_pick_rand (
       rng, 0, ((~0) >> (BTORSIM_BV_TYPE_BW - bw % BTORSIM_BV_TYPE_BW)) - 1);
 
-  for (i = 0; i < lo; i++) btorsim_bv_set_bit (res, i, 0);
-  for (i = up + 1; i < res->width; i++) btorsim_bv_set_bit (res, i, 0);
+  for (i = 0; i < res->len; i++)
+    BTOR2_WORD (res, i) &= bit_range_mask (i, up, lo);
 
   set_rem_bits_to_zero (res);
 
@@ -122,6 +172,42 @@ btorsim_bv_new_random (BtorSimRNG *rng, uint32_t bw)
   return btorsim_bv_new_random_bit_range (rng, bw, bw - 1, 0);
 }
 
+BtorSimBitVector *
+btorsim_bv_new_random64_bit_range (BtorSimRNG64 *rng,
+                                   uint32_t bw,
+                                   uint32_t up,
+                                   uint32_t lo)
+{
+  assert (rng);
+  assert (bw > 0);
+  assert (lo <= up);
+  assert (up < bw);
+
+  uint32_t i;
+  uint64_t r;
+  BtorSimBitVector *res;
+
+  /* one draw per two words, masked to [lo, up] while storing */
+  res = btorsim_bv_new (bw);
+  for (i = 0; i < res->len; i += 2)
+  {
+    r                   = btorsim_rng64_rand (rng);
+    BTOR2_WORD (res, i) = (BTORSIM_BV_TYPE) r & bit_range_mask (i, up, lo);
+    if (i + 1 < res->len)
+      BTOR2_WORD (res, i + 1) =
+          (BTORSIM_BV_TYPE) (r >> 32) & bit_range_mask (i + 1, up, lo);
+  }
+
+  assert (rem_bits_zero_dbg (res));
+  return res;
+}
+
+BtorSimBitVector *
+btorsim_bv_new_random64 (BtorSimRNG64 *rng, uint32_t bw)
+{
+  return btorsim_bv_new_random64_bit_range (rng, bw, bw - 1, 0);
+}
+
 void
 btorsim_bv_free (BtorSimBitVector *bv)
 {
@@ -190,35 +276,26 @@ btorsim_bv_const (const char *str, uint32_t bw)
 {
   assert (strlen (str) <= bw);
 
-  uint32_t i, j, bit;
+  uint32_t i, j;
+  BTORSIM_BV_TYPE word;
   BtorSimBitVector *res;
 
-  res = btorsim_bv_new (bw);
+  res  = btorsim_bv_new (bw);
+  word = 0;
   for (i = 0; i < bw; i++)
   {
     j = bw - 1 - i;
     assert (str[j] == '0' || str[j] == '1');
-    bit = str[j] == '0' ? 0 : 1;
-    btorsim_bv_set_bit (res, i, bit);
+    word |= (BTORSIM_BV_TYPE) (str[j] - '0') << (i % BTORSIM_BV_TYPE_BW);
+    if (i % BTORSIM_BV_TYPE_BW == BTORSIM_BV_TYPE_BW - 1 || i == bw - 1)
+    {
+      BTOR2_WORD (res, i / BTORSIM_BV_TYPE_BW) = word;
+      word                                     = 0;
+    }
   }
   return res;
 }
 
-#ifndef NDEBUG
-static int32_t
-is_bin_str (const char *c)
-{
-  const char *p;
-  char ch;
-
-  assert (c != NULL);
-
-  for (p = c; (ch = *p); p++)
-    if (ch != '0' && ch != '1') return 0;
-  return 1;
-}
-#endif
-
 static const char *
 strip_zeroes (const char *a)
 {
@@ -227,184 +304,117 @@ strip_zeroes (const char *a)
   return a;
 }
 
-static char *
-mult_unbounded_bin_str (const char *a, const char *b)
-{
-  assert (a);
-  assert (b);
-  assert (is_bin_str (a));
-  assert (is_bin_str (b));
-
-  char *res, *r, c, x, y, s, m;
-  uint32_t alen, blen, rlen, i;
-  const char *p;
+/* Decimal conversion operates on arrays of words in little-endian order
+ * (least significant word first) and handles 9 decimal digits per step. */
 
-  a = strip_zeroes (a);
-  if (!*a) return btorsim_strdup ("");
-  if (a[0] == '1' && !a[1]) return btorsim_strdup (b);
+#define BTOR2_DEC_CHUNK_DIGITS 9
+#define BTOR2_DEC_CHUNK 1000000000u
 
-  b = strip_zeroes (b);
-  if (!*b) return btorsim_strdup ("");
-  if (b[0] == '1' && !b[1]) return btorsim_strdup (a);
+static const BTORSIM_BV_TYPE pow10_table[BTOR2_DEC_CHUNK_DIGITS + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
 
-  alen = strlen (a);
-  blen = strlen (b);
-  rlen = alen + blen;
-  BTOR2_NEWN (res, rlen + 1);
-  res[rlen] = 0;
-
-  for (r = res; r < res + blen; r++) *r = '0';
-  for (p = a; p < a + alen; p++) *r++ = *p;
-  assert (r == res + rlen);
+/* words = words * m + a, return carry */
+static BTORSIM_BV_TYPE
+mul_add_words (BTORSIM_BV_TYPE *words,
+               uint32_t n,
+               BTORSIM_BV_TYPE m,
+               BTORSIM_BV_TYPE a)
+{
+  uint32_t i;
+  uint64_t x;
 
-  for (i = 0; i < alen; i++)
+  for (i = 0, x = a; i < n; i++)
   {
-    m = res[rlen - 1];
-    c = '0';
-
-    if (m == '1')
-    {
-      p = b + blen;
-      r = res + blen;
-
-      while (res < r && b < p)
-      {
-        assert (b < p);
-        x  = *--p;
-        y  = *--r;
-        s  = x ^ y ^ c;
-        c  = (x & y) | (x & c) | (y & c);
-        *r = s;
-      }
-    }
-
-    memmove (res + 1, res, rlen - 1);
-    res[0] = c;
+    x += (uint64_t) words[i] * m;
+    words[i] = (BTORSIM_BV_TYPE) x;
+    x >>= BTORSIM_BV_TYPE_BW;
   }
-
-  return res;
+  return (BTORSIM_BV_TYPE) x;
 }
 
-static char *
-add_unbounded_bin_str (const char *a, const char *b)
+/* words = words / d, return remainder */
+static BTORSIM_BV_TYPE
+div_words (BTORSIM_BV_TYPE *words, uint32_t n, BTORSIM_BV_TYPE d)
 {
-  assert (a);
-  assert (b);
-  assert (is_bin_str (a));
-  assert (is_bin_str (b));
-
-  char *res, *r, c, x, y, s, *tmp;
-  uint32_t alen, blen, rlen;
-  const char *p, *q;
-
-  a = strip_zeroes (a);
-  b = strip_zeroes (b);
-
-  if (!*a) return btorsim_strdup (b);
-  if (!*b) return btorsim_strdup (a);
+  assert (d);
 
-  alen = strlen (a);
-  blen = strlen (b);
-  rlen = (alen < blen) ? blen : alen;
-  rlen++;
-
-  BTOR2_NEWN (res, rlen + 1);
+  uint32_t i;
+  uint64_t x, r;
 
-  p = a + alen;
-  q = b + blen;
+  for (i = n, r = 0; i > 0; i--)
+  {
+    x            = (r << BTORSIM_BV_TYPE_BW) | words[i - 1];
+    words[i - 1] = (BTORSIM_BV_TYPE) (x / d);
+    r            = x % d;
+  }
+  return (BTORSIM_BV_TYPE) r;
+}
 
-  c = '0';
+/* Convert the 'len' decimal digits in 'str' into words, '*nwords' is set to
+ * the number of significant words (at least 1). */
+static BTORSIM_BV_TYPE *
+dec_to_words (const char *str, uint32_t len, uint32_t *nwords)
+{
+  assert (str);
+  assert (nwords);
 
-  r  = res + rlen;
-  *r = 0;
+  BTORSIM_BV_TYPE *res, chunk, carry;
+  uint32_t n, size, i, k;
+  const char *p, *end;
 
-  while (res < r)
-  {
-    x    = (a < p) ? *--p : '0';
-    y    = (b < q) ? *--q : '0';
-    s    = x ^ y ^ c;
-    c    = (x & y) | (x & c) | (y & c);
-    *--r = s;
-  }
+  /* log2 (10) < 3402 / 1024 */
+  size = (uint32_t) (((uint64_t) len * 3402 / 1024) / BTORSIM_BV_TYPE_BW + 2);
+  BTOR2_CNEWN (res, size);
+  n = 1;
 
-  p = strip_zeroes (res);
-  if ((p != res))
+  /* first chunk takes the excess digits, all others are complete */
+  end = str + len;
+  k   = len % BTOR2_DEC_CHUNK_DIGITS;
+  if (!k) k = BTOR2_DEC_CHUNK_DIGITS;
+  for (p = str; p < end; k = BTOR2_DEC_CHUNK_DIGITS)
   {
-    tmp = btorsim_strdup (p);
-    if (!tmp)
+    for (chunk = 0, i = 0; i < k && p < end; i++, p++)
     {
-      free (res);
-      return 0;
+      assert ('0' <= *p && *p <= '9');
+      chunk = 10 * chunk + (*p - '0');
+    }
+    carry = mul_add_words (res, n, pow10_table[i], chunk);
+    if (carry)
+    {
+      assert (n < size);
+      res[n++] = carry;
     }
-    free (res);
-    res = tmp;
   }
-
+  while (n > 1 && !res[n - 1]) n--;
+  *nwords = n;
   return res;
 }
 
-static const char *digit2const_table[10] = {
-    "",
-    "1",
-    "10",
-    "11",
-    "100",
-    "101",
-    "110",
-    "111",
-    "1000",
-    "1001",
-};
-
-static const char *
-digit2const (char ch)
+#ifndef NDEBUG
+/* number of significant bits of 'words', at least 1 */
+static uint32_t
+get_words_bit_len (const BTORSIM_BV_TYPE *words, uint32_t n)
 {
-  assert ('0' <= ch);
-  assert (ch <= '9');
+  assert (n > 0);
 
-  return digit2const_table[ch - '0'];
+  if (!words[n - 1]) return 1;
+  return n * BTORSIM_BV_TYPE_BW - __builtin_clz (words[n - 1]);
 }
 
-static char *
-dec_to_bin_str (const char *str, uint32_t len)
+/* true if 'words' is a power of two */
+static bool
+is_power_of_two_words (const BTORSIM_BV_TYPE *words, uint32_t n)
 {
-  assert (str);
-
-  const char *end, *p;
-  char *res, *tmp;
+  assert (n > 0);
 
-  res = btorsim_strdup ("");
-  if (!res) return 0;
-
-  end = str + len;
-  for (p = str; p < end; p++)
-  {
-    tmp = mult_unbounded_bin_str (res, "1010"); /* *10 */
-    if (!tmp)
-    {
-      free (res);
-      return 0;
-    }
-    free (res);
-    res = tmp;
-
-    tmp = add_unbounded_bin_str (res, digit2const (*p));
-    if (!tmp)
-    {
-      free (res);
-      return 0;
-    }
-    free (res);
-    res = tmp;
-  }
+  uint32_t i;
 
-  assert (strip_zeroes (res) == res);
-  if (strlen (res)) return res;
-  free (res);
-  return btorsim_strdup ("0");
+  if (!words[n - 1] || (words[n - 1] & (words[n - 1] - 1))) return false;
+  for (i = 0; i < n - 1; i++)
+    if (words[i]) return false;
+  return true;
 }
 
-#ifndef NDEBUG
 static int32_t
 check_constd (const char *str, uint32_t width)
 {
@@ -412,22 +422,17 @@ check_constd (const char *str, uint32_t width)
   assert (width);
 
   int32_t is_neg, is_min_val = 0, res;
-  char *bits;
-  size_t size_bits, len;
+  BTORSIM_BV_TYPE *words;
+  uint32_t nwords, size_bits, len;
 
   is_neg    = (str[0] == '-');
   len       = is_neg ? strlen (str) - 1 : strlen (str);
-  bits      = dec_to_bin_str (is_neg ? str + 1 : str, len);
-  size_bits = strlen (bits);
-  if (is_neg)
-  {
-    is_min_val = (bits[0] == '1');
-    for (size_t i = 1; is_min_val && i < size_bits; i++)
-      is_min_val = (bits[i] == '0');
-  }
+  words     = dec_to_words (is_neg ? str + 1 : str, len, &nwords);
+  size_bits = get_words_bit_len (words, nwords);
+  if (is_neg) is_min_val = is_power_of_two_words (words, nwords);
   res = ((is_neg && !is_min_val) || size_bits <= width)
         && (!is_neg || is_min_val || size_bits + 1 <= width);
-  free (bits);
+  free (words);
   return res;
 }
 #endif
@@ -437,36 +442,20 @@ btorsim_bv_constd (const char *str, uint32_t bw)
 {
   assert (check_constd (str, bw));
 
-  bool is_neg, is_min_val;
-  ;
+  bool is_neg;
   BtorSimBitVector *res, *tmp;
-  char *bits;
-  uint32_t size_bits, len;
+  BTORSIM_BV_TYPE *words;
+  uint32_t nwords, len, i;
 
-  is_min_val = false;
-  is_neg     = (str[0] == '-');
-  len        = is_neg ? strlen (str) - 1 : strlen (str);
-  bits       = dec_to_bin_str (is_neg ? str + 1 : str, len);
-  size_bits  = strlen (bits);
-  if (is_neg)
-  {
-    is_min_val = (bits[0] == '1');
-    for (size_t i = 1; is_min_val && i < size_bits; i++)
-      is_min_val = (bits[i] == '0');
-  }
-  assert (((is_neg && !is_min_val) || size_bits <= bw)
-          && (!is_neg || is_min_val || size_bits + 1 <= bw));
+  is_neg = (str[0] == '-');
+  len    = is_neg ? strlen (str) - 1 : strlen (str);
+  words  = dec_to_words (is_neg ? str + 1 : str, len, &nwords);
+  assert (get_words_bit_len (words, nwords) <= bw);
 
-  res = btorsim_bv_char_to_bv (bits);
-  free (bits);
-  assert (res->width == size_bits);
-  /* zero-extend to bw */
-  if (size_bits < bw)
-  {
-    tmp = btorsim_bv_uext (res, bw - size_bits);
-    free (res);
-    res = tmp;
-  }
+  res = btorsim_bv_new (bw);
+  for (i = 0; i < nwords && i < res->len; i++) BTOR2_WORD (res, i) = words[i];
+  free (words);
+  assert (rem_bits_zero_dbg (res));
   if (is_neg)
   {
     tmp = btorsim_bv_neg (res);
@@ -749,12 +738,28 @@ btorsim_bv_hash (const BtorSimBitVector *bv)
 void
 btorsim_bv_print_without_new_line (const BtorSimBitVector *bv)
 {
+  btorsim_bv_fprint_without_new_line (stdout, bv);
+}
+
+void
+btorsim_bv_fprint_without_new_line (FILE *file, const BtorSimBitVector *bv)
+{
+  assert (file);
   assert (bv);
 
-  int64_t i;
+  char buf[256], *s;
 
-  for (i = bv->width - 1; i >= 0; i--)
-    printf ("%d", btorsim_bv_get_bit (bv, i));
+  if (bv->width < sizeof buf)
+  {
+    btorsim_bv_to_char_buf (bv, buf);
+    fwrite (buf, 1, bv->width, file);
+  }
+  else
+  {
+    s = btorsim_bv_to_char (bv);
+    fwrite (s, 1, bv->width, file);
+    BTOR2_DELETE (s);
+  }
 }
 
 void
@@ -785,120 +790,130 @@ btorsim_bv_print_all (const BtorSimBitVector *bv)
 
 /*------------------------------------------------------------------------*/
 
-char *
-btorsim_bv_to_char (const BtorSimBitVector *bv)
+/* binary representation of every byte value, MSB first */
+#define BTOR2_BIN1(p) p "0", p "1"
+#define BTOR2_BIN2(p) BTOR2_BIN1 (p "0"), BTOR2_BIN1 (p "1")
+#define BTOR2_BIN4(p) BTOR2_BIN2 (p "00"), BTOR2_BIN2 (p "01"), \
+                      BTOR2_BIN2 (p "10"), BTOR2_BIN2 (p "11")
+#define BTOR2_BIN8(p) BTOR2_BIN4 (p "0000"), BTOR2_BIN4 (p "0001"), \
+                      BTOR2_BIN4 (p "0010"), BTOR2_BIN4 (p "0011"), \
+                      BTOR2_BIN4 (p "0100"), BTOR2_BIN4 (p "0101"), \
+                      BTOR2_BIN4 (p "0110"), BTOR2_BIN4 (p "0111"), \
+                      BTOR2_BIN4 (p "1000"), BTOR2_BIN4 (p "1001"), \
+                      BTOR2_BIN4 (p "1010"), BTOR2_BIN4 (p "1011"), \
+                      BTOR2_BIN4 (p "1100"), BTOR2_BIN4 (p "1101"), \
+                      BTOR2_BIN4 (p "1110"), BTOR2_BIN4 (p "1111")
+
+static const char byte2bin_table[256][9] = {BTOR2_BIN8 ("")};
+
+static const char nibble2hex_table[] = "0123456789abcdef";
+
+void
+btorsim_bv_to_char_buf (const BtorSimBitVector *bv, char *buf)
 {
   assert (bv);
+  assert (buf);
 
-  uint32_t i, bw, bit;
-  char *res;
+  uint32_t i, n, byte;
+  char *p;
 
-  bw = bv->width;
-  BTOR2_NEWN (res, bw + 1);
-  for (i = 0; i < bw; i++)
+  /* fill from the end, one byte of 'bv' at a time starting at the LSB */
+  p  = buf + bv->width;
+  *p = '\0';
+  n  = bv->width / 8;
+  for (i = 0; i < n; i++)
   {
-    bit             = btorsim_bv_get_bit (bv, i);
-    res[bw - 1 - i] = bit ? '1' : '0';
+    byte = (BTOR2_WORD (bv, i / 4) >> (8 * (i % 4))) & 0xff;
+    p -= 8;
+    memcpy (p, byte2bin_table[byte], 8);
+  }
+  if ((n = bv->width % 8))
+  {
+    byte = (BTOR2_WORD (bv, i / 4) >> (8 * (i % 4))) & 0xff;
+    memcpy (buf, byte2bin_table[byte] + 8 - n, n);
   }
-  res[bw] = '\0';
-
-  return res;
 }
 
-char *
-btorsim_bv_to_hex_char (const BtorSimBitVector *bv)
+void
+btorsim_bv_to_hex_char_buf (const BtorSimBitVector *bv, char *buf)
 {
   assert (bv);
+  assert (buf);
 
-  uint32_t len, i, j, k, tmp;
-  char *res, ch;
+  uint32_t i, j, len;
+  BTORSIM_BV_TYPE word;
+  char *p;
 
+  /* fill from the end, one word of 'bv' at a time starting at the LSB */
   len = (bv->width + 3) / 4;
-  BTOR2_CNEWN (res, len + 1);
-  for (i = 0, j = len - 1; i < bv->width;)
+  p   = buf + len;
+  *p  = '\0';
+  for (i = 0; i < bv->len; i++)
   {
-    tmp = btorsim_bv_get_bit (bv, i++);
-    for (k = 1; i < bv->width && k <= 3; i++, k++)
-      tmp |= btorsim_bv_get_bit (bv, i) << k;
-    ch       = tmp < 10 ? '0' + tmp : 'a' + (tmp - 10);
-    res[j--] = ch;
+    word = BTOR2_WORD (bv, i);
+    for (j = 0; j < BTORSIM_BV_TYPE_BW / 4 && p > buf; j++, word >>= 4)
+      *--p = nibble2hex_table[word & 0xf];
   }
-
-  return res;
 }
 
-static uint32_t
-get_first_one_bit_idx (const BtorSimBitVector *bv)
+char *
+btorsim_bv_to_char (const BtorSimBitVector *bv)
 {
   assert (bv);
 
-  uint32_t i;
+  char *res;
 
-  for (i = bv->width - 1; i < UINT_MAX; i--)
-  {
-    if (btorsim_bv_get_bit (bv, i)) break;
-    if (i == 0) return UINT_MAX;
-  }
-  return i;
+  BTOR2_NEWN (res, bv->width + 1);
+  btorsim_bv_to_char_buf (bv, res);
+  return res;
 }
 
 char *
-btorsim_bv_to_dec_char (const BtorSimBitVector *bv)
+btorsim_bv_to_hex_char (const BtorSimBitVector *bv)
 {
   assert (bv);
 
-  BtorSimBitVector *tmp, *div, *rem, *ten;
-  uint32_t i;
-  char *res, ch, *p, *q;
-  BtorCharStack stack;
+  char *res;
 
-  if (btorsim_bv_is_zero (bv))
-  {
-    BTOR2_CNEWN (res, 2);
-    res[0] = '0';
-    return res;
-  }
+  BTOR2_NEWN (res, (bv->width + 3) / 4 + 1);
+  btorsim_bv_to_hex_char_buf (bv, res);
+  return res;
+}
 
-  BTOR2_INIT_STACK (stack);
+char *
+btorsim_bv_to_dec_char (const BtorSimBitVector *bv)
+{
+  assert (bv);
 
-  if (bv->width < 4)
-  {
-    ten = btorsim_bv_uint64_to_bv (10, 4);
-    tmp = btorsim_bv_uext ((BtorSimBitVector *) bv, 4 - bv->width);
-  }
-  else
+  BTORSIM_BV_TYPE *words, chunk;
+  uint32_t i, n, size;
+  char *res, *p;
+
+  n = bv->len;
+  BTOR2_NEWN (words, n);
+  for (i = 0; i < n; i++) words[i] = BTOR2_WORD (bv, i);
+  while (n > 0 && !words[n - 1]) n--;
+
+  /* log10 (2) < 1233 / 4096 */
+  size = (uint32_t) ((uint64_t) bv->width * 1233 / 4096 + 2);
+  BTOR2_NEWN (res, size + 1);
+  p  = res + size;
+  *p = 0;
+  if (!n) *--p = '0';
+  while (n > 0)
   {
-    ten = btorsim_bv_uint64_to_bv (10, bv->width);
-    tmp = btorsim_bv_copy (bv);
-  }
-  while (!btorsim_bv_is_zero (tmp))
-  {
-    div = btorsim_bv_udiv (tmp, ten);
-    rem = btorsim_bv_urem (tmp, ten);
-    ch  = 0;
-    for (i = get_first_one_bit_idx (rem); i < UINT_MAX; i--)
+    chunk = div_words (words, n, BTOR2_DEC_CHUNK);
+    if (!words[n - 1]) n--;
+    /* all but the most significant chunk are padded with zeroes */
+    for (i = 0; i < BTOR2_DEC_CHUNK_DIGITS && (n || chunk); i++)
     {
-      ch <<= 1;
-      if (btorsim_bv_get_bit (rem, i)) ch += 1;
+      assert (p > res);
+      *--p = '0' + chunk % 10;
+      chunk /= 10;
     }
-    assert (ch < 10);
-    ch += '0';
-    BTOR2_PUSH_STACK (stack, ch);
-    free (rem);
-    free (tmp);
-    tmp = div;
   }
-  free (tmp);
-  free (ten);
-  if (BTOR2_EMPTY_STACK (stack)) BTOR2_PUSH_STACK (stack, '0');
-  BTOR2_NEWN (res, BTOR2_COUNT_STACK (stack) + 1);
-  q = res;
-  p = stack.top;
-  while (p > stack.start) *q++ = *--p;
-  assert (res + BTOR2_COUNT_STACK (stack) == q);
-  *q = 0;
-  assert ((uint32_t) BTOR2_COUNT_STACK (stack) == strlen (res));
-  BTOR2_RELEASE_STACK (stack);
+  free (words);
+  memmove (res, p, res + size + 1 - p);
   return res;
 }
 
@@ -1034,20 +1049,18 @@ btorsim_bv_power_of_two (const BtorSimBitVector *bv)
 {
   assert (bv);
 
-  int64_t i, j;
-  uint32_t bit;
-  bool iszero;
+  uint32_t i, cnt;
+  int64_t res;
 
-  for (i = 0, j = 0, iszero = true; i < bv->width; i++)
+  for (i = 0, cnt = 0, res = 0; i < bv->len; i++)
   {
-    bit = btorsim_bv_get_bit (bv, i);
-    if (!bit) continue;
-    if (bit && !iszero) return -1;
-    assert (bit && iszero);
-    j      = i;
-    iszero = false;
+    if (!BTOR2_WORD (bv, i)) continue;
+    cnt += __builtin_popcount (BTOR2_WORD (bv, i));
+    if (cnt > 1) return -1;
+    res = (int64_t) i * BTORSIM_BV_TYPE_BW + __builtin_ctz (BTOR2_WORD (bv, i));
   }
-  return j;
+  /* zero is reported as 2^0 */
+  return res;
 }
 
 int32_t
@@ -1068,15 +1081,12 @@ btorsim_bv_get_num_trailing_zeros (const BtorSimBitVector *bv)
 {
   assert (bv);
 
-  uint32_t i, res;
-
-  for (i = 0, res = 0; i < bv->width; i++)
-  {
-    if (btorsim_bv_get_bit (bv, i)) break;
-    res += 1;
-  }
+  uint32_t i;
 
-  return res;
+  for (i = 0; i < bv->len; i++)
+    if (BTOR2_WORD (bv, i))
+      return i * BTORSIM_BV_TYPE_BW + __builtin_ctz (BTOR2_WORD (bv, i));
+  return bv->width;
 }
 
 uint32_t
@@ -1084,15 +1094,13 @@ btorsim_bv_get_num_leading_zeros (const BtorSimBitVector *bv)
 {
   assert (bv);
 
-  uint32_t i, res;
-
-  for (i = bv->width - 1, res = 0; i < UINT_MAX; i--)
-  {
-    if (btorsim_bv_get_bit (bv, i)) break;
-    res += 1;
-  }
+  uint32_t i, spare;
 
-  return res;
+  spare = BTORSIM_BV_TYPE_BW * bv->len - bv->width;
+  for (i = 0; i < bv->len; i++)
+    if (bv->bits[i])
+      return i * BTORSIM_BV_TYPE_BW + __builtin_clz (bv->bits[i]) - spare;
+  return bv->width;
 }
 
 uint32_t
@@ -1100,15 +1108,17 @@ btorsim_bv_get_num_leading_ones (const BtorSimBitVector *bv)
 {
   assert (bv);
 
-  uint32_t i, res;
+  uint32_t i, spare;
+  BTORSIM_BV_TYPE x;
 
-  for (i = bv->width - 1, res = 0; i < UINT_MAX; i--)
+  spare = BTORSIM_BV_TYPE_BW * bv->len - bv->width;
+  for (i = 0; i < bv->len; i++)
   {
-    if (!btorsim_bv_get_bit (bv, i)) break;
-    res += 1;
+    x = ~bv->bits[i];
+    if (i == 0 && spare) x &= BTOR2_MASK_REM_BITS (bv);
+    if (x) return i * BTORSIM_BV_TYPE_BW + __builtin_clz (x) - spare;
   }
-
-  return res;
+  return bv->width;
 }
 
 /*------------------------------------------------------------------------*/
@@ -1197,76 +1207,76 @@ btorsim_bv_dec (const BtorSimBitVector *bv)
   return res;
 }
 
-BtorSimBitVector *
-btorsim_bv_redand (const BtorSimBitVector *bv)
+/* 1-bit result of a predicate */
+static BtorSimBitVector *
+new_bool (bool bit)
+{
+  BtorSimBitVector *res = btorsim_bv_new (1);
+  res->bits[0]          = bit;
+  assert (rem_bits_zero_dbg (res));
+  return res;
+}
+
+bool
+btorsim_bv_redand_p (const BtorSimBitVector *bv)
 {
   assert (bv);
 
   uint32_t i;
-  uint32_t bit;
-  uint32_t mask0;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (1);
-  assert (rem_bits_zero_dbg (res));
+  BTORSIM_BV_TYPE mask0;
 
   if (bv->width == BTORSIM_BV_TYPE_BW * bv->len)
     mask0 = ~(BTORSIM_BV_TYPE) 0;
   else
     mask0 = BTOR2_MASK_REM_BITS (bv);
 
-  bit = (bv->bits[0] == mask0);
+  if (bv->bits[0] != mask0) return false;
+  for (i = 1; i < bv->len; i++)
+    if (bv->bits[i] != ~(BTORSIM_BV_TYPE) 0) return false;
+  return true;
+}
 
-  for (i = 1; bit && i < bv->len; i++)
-    if (bv->bits[i] != ~(BTORSIM_BV_TYPE) 0) bit = 0;
+BtorSimBitVector *
+btorsim_bv_redand (const BtorSimBitVector *bv)
+{
+  assert (bv);
+  return new_bool (btorsim_bv_redand_p (bv));
+}
 
-  btorsim_bv_set_bit (res, 0, bit);
+bool
+btorsim_bv_redor_p (const BtorSimBitVector *bv)
+{
+  assert (bv);
 
-  assert (rem_bits_zero_dbg (res));
-  return res;
+  uint32_t i;
+  for (i = 0; i < bv->len; i++)
+    if (bv->bits[i]) return true;
+  return false;
 }
 
 BtorSimBitVector *
 btorsim_bv_redor (const BtorSimBitVector *bv)
 {
   assert (bv);
+  return new_bool (btorsim_bv_redor_p (bv));
+}
 
-  uint32_t i;
-  uint32_t bit;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (1);
-  assert (rem_bits_zero_dbg (res));
-  bit = 0;
-  for (i = 0; !bit && i < bv->len; i++)
-    if (bv->bits[i]) bit = 1;
-
-  btorsim_bv_set_bit (res, 0, bit);
+bool
+btorsim_bv_redxor_p (const BtorSimBitVector *bv)
+{
+  assert (bv);
 
-  assert (rem_bits_zero_dbg (res));
-  return res;
+  uint32_t i;
+  BTORSIM_BV_TYPE x;
+  for (i = 0, x = 0; i < bv->len; i++) x ^= bv->bits[i];
+  return __builtin_parity (x);
 }
 
 BtorSimBitVector *
 btorsim_bv_redxor (const BtorSimBitVector *bv)
 {
   assert (bv);
-
-  uint32_t i;
-  uint32_t bit;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (1);
-  assert (rem_bits_zero_dbg (res));
-  bit = btorsim_bv_get_bit (bv, 0);
-  for (i = 1; i < bv->width; i++)
-  {
-    bit = bit ^ btorsim_bv_get_bit (bv, i);
-  }
-  btorsim_bv_set_bit (res, 0, bit);
-
-  assert (rem_bits_zero_dbg (res));
-  return res;
+  return new_bool (btorsim_bv_redxor_p (bv));
 }
 
 /*------------------------------------------------------------------------*/
@@ -1453,58 +1463,49 @@ btorsim_bv_xor (const BtorSimBitVector *a, const BtorSimBitVector *b)
   return res;
 }
 
-BtorSimBitVector *
-btorsim_bv_eq (const BtorSimBitVector *a, const BtorSimBitVector *b)
+bool
+btorsim_bv_eq_p (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
   assert (a);
   assert (b);
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i, bit;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (1);
-  bit = 1;
+  uint32_t i;
   for (i = 0; i < a->len; i++)
-  {
-    if (a->bits[i] != b->bits[i])
-    {
-      bit = 0;
-      break;
-    }
-  }
-  btorsim_bv_set_bit (res, 0, bit);
-
-  assert (rem_bits_zero_dbg (res));
-  return res;
+    if (a->bits[i] != b->bits[i]) return false;
+  return true;
 }
 
 BtorSimBitVector *
-btorsim_bv_neq (const BtorSimBitVector *a, const BtorSimBitVector *b)
+btorsim_bv_eq (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
   assert (a);
   assert (b);
   assert (a->len == b->len);
   assert (a->width == b->width);
+  return new_bool (btorsim_bv_eq_p (a, b));
+}
 
-  uint32_t i, bit;
-  BtorSimBitVector *res;
+bool
+btorsim_bv_neq_p (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
 
-  res = btorsim_bv_new (1);
-  bit = 1;
-  for (i = 0; i < a->len; i++)
-  {
-    if (a->bits[i] != b->bits[i])
-    {
-      bit = 0;
-      break;
-    }
-  }
-  btorsim_bv_set_bit (res, 0, !bit);
+  return !btorsim_bv_eq_p (a, b);
+}
 
-  assert (rem_bits_zero_dbg (res));
-  return res;
+BtorSimBitVector *
+btorsim_bv_neq (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
+  return new_bool (btorsim_bv_neq_p (a, b));
 }
 
 static uint32_t
@@ -1519,124 +1520,124 @@ find_diff_index (const BtorSimBitVector *a, const BtorSimBitVector *b)
   return i;
 }
 
-BtorSimBitVector *
-btorsim_bv_ult (const BtorSimBitVector *a, const BtorSimBitVector *b)
+bool
+btorsim_bv_ult_p (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
   assert (a);
   assert (b);
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i, bit;
-  BtorSimBitVector *res;
-
-  res = btorsim_bv_new (1);
-  bit = 1;
+  uint32_t i;
 
   i = find_diff_index (a, b);
-
   /* a == b */
-  if (i == a->len || a->bits[i] >= b->bits[i]) bit = 0;
-
-  btorsim_bv_set_bit (res, 0, bit);
-
-  assert (rem_bits_zero_dbg (res));
-  return res;
+  if (i == a->len) return false;
+  return a->bits[i] < b->bits[i];
 }
 
 BtorSimBitVector *
-btorsim_bv_ulte (const BtorSimBitVector *a, const BtorSimBitVector *b)
+btorsim_bv_ult (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
   assert (a);
   assert (b);
   assert (a->len == b->len);
   assert (a->width == b->width);
+  return new_bool (btorsim_bv_ult_p (a, b));
+}
 
-  uint32_t i, bit;
-  BtorSimBitVector *res;
+bool
+btorsim_bv_ulte_p (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
 
-  res = btorsim_bv_new (1);
-  bit = 1;
+  uint32_t i;
 
   i = find_diff_index (a, b);
-
   /* a == b */
-  if (i < a->len && a->bits[i] > b->bits[i]) bit = 0;
-
-  btorsim_bv_set_bit (res, 0, bit);
-
-  assert (rem_bits_zero_dbg (res));
-  return res;
+  if (i == a->len) return true;
+  return a->bits[i] < b->bits[i];
 }
 
 BtorSimBitVector *
-btorsim_bv_slt (const BtorSimBitVector *a, const BtorSimBitVector *b)
+btorsim_bv_ulte (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
   assert (a);
   assert (b);
   assert (a->len == b->len);
   assert (a->width == b->width);
+  return new_bool (btorsim_bv_ulte_p (a, b));
+}
 
-  uint32_t i, bit, sign_a, sign_b;
-  BtorSimBitVector *res;
+bool
+btorsim_bv_slt_p (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
 
-  res = btorsim_bv_new (1);
-  bit = 1;
+  uint32_t sign_a, sign_b;
 
   sign_a = btorsim_bv_get_bit (a, a->width - 1);
   sign_b = btorsim_bv_get_bit (b, b->width - 1);
 
-  if (sign_a == sign_b)
-  {
-    i = find_diff_index (a, b);
-    if (i == a->len || a->bits[i] >= b->bits[i]) bit = 0;
-  }
-  else
-  {
-    bit = sign_a && !sign_b;
-  }
-
-  btorsim_bv_set_bit (res, 0, bit);
-
-  assert (rem_bits_zero_dbg (res));
-  return res;
+  if (sign_a != sign_b) return sign_a;
+  return btorsim_bv_ult_p (a, b);
 }
 
 BtorSimBitVector *
-btorsim_bv_slte (const BtorSimBitVector *a, const BtorSimBitVector *b)
+btorsim_bv_slt (const BtorSimBitVector *a, const BtorSimBitVector *b)
 {
   assert (a);
   assert (b);
   assert (a->len == b->len);
   assert (a->width == b->width);
+  return new_bool (btorsim_bv_slt_p (a, b));
+}
 
-  uint32_t i, bit, sign_a, sign_b;
-  BtorSimBitVector *res;
+bool
+btorsim_bv_slte_p (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
 
-  res = btorsim_bv_new (1);
-  bit = 1;
+  uint32_t sign_a, sign_b;
 
   sign_a = btorsim_bv_get_bit (a, a->width - 1);
   sign_b = btorsim_bv_get_bit (b, b->width - 1);
 
-  if (sign_a == sign_b)
-  {
-    i = find_diff_index (a, b);
-    if (i < a->len && a->bits[i] > b->bits[i]) bit = 0;
-  }
-  else
-  {
-    bit = sign_a && !sign_b;
-  }
+  if (sign_a != sign_b) return sign_a;
+  return btorsim_bv_ulte_p (a, b);
+}
 
-  btorsim_bv_set_bit (res, 0, bit);
+BtorSimBitVector *
+btorsim_bv_slte (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
+  return new_bool (btorsim_bv_slte_p (a, b));
+}
 
-  assert (rem_bits_zero_dbg (res));
-  return res;
+/* shift amount given by 'b', saturated to UINT64_MAX if it does not fit */
+static uint64_t
+get_shift_amount (const BtorSimBitVector *b)
+{
+  if (b->width <= 64) return btorsim_bv_to_uint64 (b);
+  if (btorsim_bv_get_num_leading_zeros (b) < b->width - 64) return UINT64_MAX;
+  return ((uint64_t) BTOR2_WORD (b, 1) << BTORSIM_BV_TYPE_BW)
+         | BTOR2_WORD (b, 0);
 }
 
 static BtorSimBitVector *
-sll_bv (const BtorSimBitVector *a, uint32_t shift)
+sll_bv (const BtorSimBitVector *a, uint64_t shift)
 {
   assert (a);
 
@@ -1672,20 +1673,7 @@ btorsim_bv_sll (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint64_t shift;
-  BtorSimBitVector *res;
-  if (b->width <= 64)
-    shift = btorsim_bv_to_uint64 (b);
-  else
-  {
-    if (btorsim_bv_get_num_leading_zeros (b) < (b->width - 64))
-      return btorsim_bv_new (a->width);
-    BtorSimBitVector *lower = btorsim_bv_slice (b, 63, 0);
-    shift                   = btorsim_bv_to_uint64 (lower);
-    btorsim_bv_free (lower);
-  }
-  res = sll_bv (a, shift);
-  return res;
+  return sll_bv (a, get_shift_amount (b));
 }
 
 BtorSimBitVector *
@@ -1701,16 +1689,8 @@ btorsim_bv_srl (const BtorSimBitVector *a, const BtorSimBitVector *b)
   BtorSimBitVector *res;
   BTORSIM_BV_TYPE v;
 
-  res = btorsim_bv_new (a->width);
-  if (b->width <= 64)
-    shift = btorsim_bv_to_uint64 (b);
-  else
-  {
-    if (btorsim_bv_get_num_leading_zeros (b) < (b->width - 64)) return res;
-    BtorSimBitVector *lower = btorsim_bv_slice (b, 63, 0);
-    shift                   = btorsim_bv_to_uint64 (lower);
-    btorsim_bv_free (lower);
-  }
+  res   = btorsim_bv_new (a->width);
+  shift = get_shift_amount (b);
   if (shift >= a->width) return res;
 
   k    = shift % BTORSIM_BV_TYPE_BW;
@@ -1736,53 +1716,77 @@ btorsim_bv_sra (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  BtorSimBitVector *res, *sign_a, *srl1, *srl2, *not_a;
-
-  sign_a = btorsim_bv_slice (a, a->width - 1, a->width - 1);
-  srl1   = btorsim_bv_srl (a, b);
-  not_a  = btorsim_bv_not (a);
-  srl2   = btorsim_bv_srl (not_a, b);
-  res    = btorsim_bv_is_true (sign_a) ? btorsim_bv_not (srl2)
-                                      : btorsim_bv_copy (srl1);
-  btorsim_bv_free (sign_a);
-  btorsim_bv_free (srl1);
-  btorsim_bv_free (srl2);
-  btorsim_bv_free (not_a);
+  BtorSimBitVector *res, *srl, *not_a;
+
+  if (btorsim_bv_get_bit (a, a->width - 1))
+  {
+    not_a = btorsim_bv_not (a);
+    srl   = btorsim_bv_srl (not_a, b);
+    res   = btorsim_bv_not (srl);
+    btorsim_bv_free (not_a);
+    btorsim_bv_free (srl);
+  }
+  else
+    res = btorsim_bv_srl (a, b);
   set_rem_bits_to_zero (res);
   assert (rem_bits_zero_dbg (res));
   return res;
 }
 
-BtorSimBitVector *
-btorsim_bv_rol (const BtorSimBitVector *a, const BtorSimBitVector *b) {
-  BtorSimBitVector *width = btorsim_bv_uint64_to_bv(a->width, a->width);
-  BtorSimBitVector *rev = btorsim_bv_sub(width, b);
-
-  BtorSimBitVector *sll_part = btorsim_bv_sll(a, b);
-  BtorSimBitVector *srl_part = btorsim_bv_srl(a, rev);
-  BtorSimBitVector *res = btorsim_bv_or(sll_part, srl_part);
-
-  btorsim_bv_free(width);
-  btorsim_bv_free(rev);
-  btorsim_bv_free(sll_part);
-  btorsim_bv_free(srl_part);
+/* Rotate 'a' left by 'shift' bits, computed as (a << shift) | (a >> (width -
+ * shift)) with the subtraction modulo 2^width.  Consequently, shift amounts
+ * greater than the bit-width rotate all bits out and yield zero. */
+static BtorSimBitVector *
+rol_bv (const BtorSimBitVector *a, uint64_t shift)
+{
+  assert (a);
+
+  uint32_t i;
+  int64_t pos;
+  BTORSIM_BV_TYPE word;
+  BtorSimBitVector *res;
+
+  res = btorsim_bv_new (a->width);
+  if (shift > a->width) return res;
+  if (shift == a->width) shift = 0;
+
+  for (i = 0; i < res->len; i++)
+  {
+    pos  = (int64_t) i * BTORSIM_BV_TYPE_BW;
+    word = get_word_at_signed (a, pos - (int64_t) shift);
+    if (shift) word |= get_word_at (a, pos + a->width - shift);
+    BTOR2_WORD (res, i) = word;
+  }
+  set_rem_bits_to_zero (res);
+  assert (rem_bits_zero_dbg (res));
   return res;
 }
 
 BtorSimBitVector *
-btorsim_bv_ror (const BtorSimBitVector *a, const BtorSimBitVector *b) {
-  BtorSimBitVector *width = btorsim_bv_uint64_to_bv(a->width, a->width);
-  BtorSimBitVector *rev = btorsim_bv_sub(width, b);
-
-  BtorSimBitVector *srl_part = btorsim_bv_srl(a, b);
-  BtorSimBitVector *sll_part = btorsim_bv_sll(a, rev);
-  BtorSimBitVector *res = btorsim_bv_or(srl_part, sll_part);
-
-  btorsim_bv_free(width);
-  btorsim_bv_free(rev);
-  btorsim_bv_free(srl_part);
-  btorsim_bv_free(sll_part);
-  return res;
+btorsim_bv_rol (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
+
+  return rol_bv (a, get_shift_amount (b));
+}
+
+BtorSimBitVector *
+btorsim_bv_ror (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->len == b->len);
+  assert (a->width == b->width);
+
+  uint64_t shift;
+
+  /* (a >> shift) | (a << (width - shift)), same as for rol_bv */
+  shift = get_shift_amount (b);
+  if (shift > a->width) return btorsim_bv_new (a->width);
+  return rol_bv (a, shift == 0 ? 0 : a->width - shift);
 }
 
 BtorSimBitVector *
@@ -1793,9 +1797,9 @@ btorsim_bv_mul (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  uint32_t i;
-  uint64_t x, y;
-  BtorSimBitVector *res, *and, *shift, *add;
+  uint32_t i, j;
+  uint64_t x, y, carry;
+  BtorSimBitVector *res;
 
   if (a->width <= 64)
   {
@@ -1805,20 +1809,20 @@ btorsim_bv_mul (const BtorSimBitVector *a, const BtorSimBitVector *b)
   }
   else
   {
+    /* schoolbook multiplication on words, truncated to 'len' words */
     res = btorsim_bv_new (a->width);
-    for (i = 0; i < a->width; i++)
+    for (i = 0; i < a->len; i++)
     {
-      if (btorsim_bv_get_bit (b, i))
-        and = btorsim_bv_copy (a);
-      else
-        and = btorsim_bv_new (a->width);
-      shift = sll_bv (and, i);
-      add   = btorsim_bv_add (res, shift);
-      free (and);
-      free (shift);
-      free (res);
-      res = add;
+      x = BTOR2_WORD (a, i);
+      if (!x) continue;
+      for (j = 0, carry = 0; i + j < res->len; j++)
+      {
+        y = x * BTOR2_WORD (b, j) + BTOR2_WORD (res, i + j) + carry;
+        BTOR2_WORD (res, i + j) = (BTORSIM_BV_TYPE) y;
+        carry                   = y >> BTORSIM_BV_TYPE_BW;
+      }
     }
+    set_rem_bits_to_zero (res);
   }
   assert (rem_bits_zero_dbg (res));
   return res;
@@ -1836,10 +1840,9 @@ udiv_urem_bv (const BtorSimBitVector *a,
   assert (a->width == b->width);
 
   int64_t i;
-  bool is_true;
   uint64_t x, y, z;
 
-  BtorSimBitVector *neg_b, *quot, *rem, *ult, *eq, *tmp;
+  BtorSimBitVector *neg_b, *quot, *rem, *tmp;
 
   if (a->width <= 64)
   {
@@ -1872,19 +1875,8 @@ udiv_urem_bv (const BtorSimBitVector *a,
       rem = tmp;
       btorsim_bv_set_bit (rem, 0, btorsim_bv_get_bit (a, i));
 
-      ult     = btorsim_bv_ult (b, rem);
-      is_true = btorsim_bv_is_true (ult);
-      free (ult);
-
-      if (is_true) goto UDIV_UREM_SUBTRACT;
-
-      eq      = btorsim_bv_eq (b, rem);
-      is_true = btorsim_bv_is_true (eq);
-      free (eq);
-
-      if (is_true)
+      if (btorsim_bv_ulte_p (b, rem))
       {
-      UDIV_UREM_SUBTRACT:
         tmp = btorsim_bv_add (rem, neg_b);
         free (rem);
         rem = tmp;
@@ -1928,8 +1920,8 @@ btorsim_bv_sdiv (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  BtorSimBitVector *res = 0, *not_a, *not_a_and_b, *sign_a, *sign_b, *xor;
-  BtorSimBitVector *neg_a, *neg_b, *cond_a, *cond_b, *udiv, *neg_udiv;
+  BtorSimBitVector *res = 0, *not_a, *not_a_and_b, *neg_a, *neg_b, *udiv;
+  uint32_t sign_a, sign_b;
 
   if (a->width == 1)
   {
@@ -1941,28 +1933,20 @@ btorsim_bv_sdiv (const BtorSimBitVector *a, const BtorSimBitVector *b)
   }
   else
   {
-    sign_a   = btorsim_bv_slice (a, a->width - 1, a->width - 1);
-    sign_b   = btorsim_bv_slice (b, b->width - 1, b->width - 1);
-    xor      = btorsim_bv_xor (sign_a, sign_b);
-    neg_a    = btorsim_bv_neg (a);
-    neg_b    = btorsim_bv_neg (b);
-    cond_a   = btorsim_bv_is_true (sign_a) ? btorsim_bv_copy (neg_a)
-                                           : btorsim_bv_copy (a);
-    cond_b   = btorsim_bv_is_true (sign_b) ? btorsim_bv_copy (neg_b)
-                                           : btorsim_bv_copy (b);
-    udiv     = btorsim_bv_udiv (cond_a, cond_b);
-    neg_udiv = btorsim_bv_neg (udiv);
-    res      = btorsim_bv_is_true (xor) ? btorsim_bv_copy (neg_udiv)
-                                        : btorsim_bv_copy (udiv);
-    btorsim_bv_free (sign_a);
-    btorsim_bv_free (sign_b);
-    btorsim_bv_free (xor);
-    btorsim_bv_free (neg_a);
-    btorsim_bv_free (neg_b);
-    btorsim_bv_free (cond_a);
-    btorsim_bv_free (cond_b);
-    btorsim_bv_free (udiv);
-    btorsim_bv_free (neg_udiv);
+    sign_a = btorsim_bv_get_bit (a, a->width - 1);
+    sign_b = btorsim_bv_get_bit (b, b->width - 1);
+    neg_a  = sign_a ? btorsim_bv_neg (a) : 0;
+    neg_b  = sign_b ? btorsim_bv_neg (b) : 0;
+    udiv   = btorsim_bv_udiv (sign_a ? neg_a : a, sign_b ? neg_b : b);
+    if (sign_a != sign_b)
+    {
+      res = btorsim_bv_neg (udiv);
+      btorsim_bv_free (udiv);
+    }
+    else
+      res = udiv;
+    if (neg_a) btorsim_bv_free (neg_a);
+    if (neg_b) btorsim_bv_free (neg_b);
   }
 
   assert (res);
@@ -1994,8 +1978,8 @@ btorsim_bv_srem (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  BtorSimBitVector *res = 0, *not_b, *sign_a, *sign_b, *neg_a, *neg_b;
-  BtorSimBitVector *cond_a, *cond_b, *urem, *neg_urem;
+  BtorSimBitVector *res = 0, *not_b, *neg_a, *neg_b, *urem;
+  uint32_t sign_a, sign_b;
 
   if (a->width == 1)
   {
@@ -2005,27 +1989,21 @@ btorsim_bv_srem (const BtorSimBitVector *a, const BtorSimBitVector *b)
   }
   else
   {
-    sign_a = btorsim_bv_slice (a, a->width - 1, a->width - 1);
-    sign_b = btorsim_bv_slice (b, b->width - 1, b->width - 1);
-    neg_a  = btorsim_bv_neg (a);
-    neg_b  = btorsim_bv_neg (b);
+    sign_a = btorsim_bv_get_bit (a, a->width - 1);
+    sign_b = btorsim_bv_get_bit (b, b->width - 1);
     /* normalize a and b if necessary */
-    cond_a   = btorsim_bv_is_true (sign_a) ? btorsim_bv_copy (neg_a)
-                                           : btorsim_bv_copy (a);
-    cond_b   = btorsim_bv_is_true (sign_b) ? btorsim_bv_copy (neg_b)
-                                           : btorsim_bv_copy (b);
-    urem     = btorsim_bv_urem (cond_a, cond_b);
-    neg_urem = btorsim_bv_neg (urem);
-    res      = btorsim_bv_is_true (sign_a) ? btorsim_bv_copy (neg_urem)
-                                           : btorsim_bv_copy (urem);
-    btorsim_bv_free (sign_a);
-    btorsim_bv_free (sign_b);
-    btorsim_bv_free (neg_a);
-    btorsim_bv_free (neg_b);
-    btorsim_bv_free (cond_a);
-    btorsim_bv_free (cond_b);
-    btorsim_bv_free (urem);
-    btorsim_bv_free (neg_urem);
+    neg_a = sign_a ? btorsim_bv_neg (a) : 0;
+    neg_b = sign_b ? btorsim_bv_neg (b) : 0;
+    urem  = btorsim_bv_urem (sign_a ? neg_a : a, sign_b ? neg_b : b);
+    if (sign_a)
+    {
+      res = btorsim_bv_neg (urem);
+      btorsim_bv_free (urem);
+    }
+    else
+      res = urem;
+    if (neg_a) btorsim_bv_free (neg_a);
+    if (neg_b) btorsim_bv_free (neg_b);
   }
 
   assert (res);
@@ -2041,7 +2019,7 @@ btorsim_bv_smod (const BtorSimBitVector *a, const BtorSimBitVector *b)
   assert (a->len == b->len);
   assert (a->width == b->width);
 
-  BtorSimBitVector *res = 0, *not_b, *sign_a, *sign_b, *neg_a, *neg_b, *add;
+  BtorSimBitVector *res = 0, *not_b, *neg_a, *neg_b, *add;
   BtorSimBitVector *cond_a, *cond_b, *urem, *neg_urem;
   bool a_positive, b_positive;
 
@@ -2053,10 +2031,8 @@ btorsim_bv_smod (const BtorSimBitVector *a, const BtorSimBitVector *b)
   }
   else
   {
-    sign_a = btorsim_bv_slice (a, a->width - 1, a->width - 1);
-    sign_b = btorsim_bv_slice (b, b->width - 1, b->width - 1);
-    a_positive = !btorsim_bv_is_true (sign_a);
-    b_positive = !btorsim_bv_is_true (sign_b);
+    a_positive = !btorsim_bv_get_bit (a, a->width - 1);
+    b_positive = !btorsim_bv_get_bit (b, b->width - 1);
 
     neg_a  = btorsim_bv_neg (a);
     neg_b  = btorsim_bv_neg (b);
@@ -2077,8 +2053,6 @@ btorsim_bv_smod (const BtorSimBitVector *a, const BtorSimBitVector *b)
         :  a_positive && !b_positive ? btorsim_bv_add(urem, add)
                                      : btorsim_bv_copy(neg_urem);
 
-    btorsim_bv_free (sign_a);
-    btorsim_bv_free (sign_b);
     btorsim_bv_free (neg_a);
     btorsim_bv_free (neg_b);
     btorsim_bv_free (cond_a);
@@ -2143,12 +2117,14 @@ btorsim_bv_slice (const BtorSimBitVector *bv, uint32_t upper, uint32_t lower)
 {
   assert (bv);
 
-  uint32_t i, j;
+  uint32_t i;
   BtorSimBitVector *res;
 
   res = btorsim_bv_new (upper - lower + 1);
-  for (i = lower, j = 0; i <= upper; i++)
-    btorsim_bv_set_bit (res, j++, btorsim_bv_get_bit (bv, i));
+  for (i = 0; i < res->len; i++)
+    BTOR2_WORD (res, i) =
+        get_word_at (bv, lower + (uint64_t) i * BTORSIM_BV_TYPE_BW);
+  set_rem_bits_to_zero (res);
 
   assert (rem_bits_zero_dbg (res));
   return res;
@@ -2244,8 +2220,8 @@ btorsim_bv_flipped_bit_range (const BtorSimBitVector *bv,
   BtorSimBitVector *res;
 
   res = btorsim_bv_copy (bv);
-  for (i = lower; i <= upper; i++)
-    btorsim_bv_set_bit (res, i, btorsim_bv_get_bit (res, i) ? 0 : 1);
+  for (i = 0; i < res->len; i++)
+    BTOR2_WORD (res, i) ^= bit_range_mask (i, upper, lower);
   set_rem_bits_to_zero (res);
   assert (rem_bits_zero_dbg (res));
   return res;
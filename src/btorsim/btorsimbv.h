@@ -16,6 +16,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #if __cplusplus
 extern "C" {
@@ -57,6 +58,14 @@ BtorSimBitVector *btorsim_bv_new_random_bit_range (BtorSimRNG *rng,
                                                    uint32_t up,
                                                    uint32_t lo);
 
+/* same as above but drawing from the 64-bit generator */
+BtorSimBitVector *btorsim_bv_new_random64 (BtorSimRNG64 *rng, uint32_t bw);
+
+BtorSimBitVector *btorsim_bv_new_random64_bit_range (BtorSimRNG64 *rng,
+                                                     uint32_t bw,
+                                                     uint32_t up,
+                                                     uint32_t lo);
+
 BtorSimBitVector *btorsim_bv_char_to_bv (const char *assignment);
 
 BtorSimBitVector *btorsim_bv_dec_to_bv (const char *decimal_string,
@@ -85,11 +94,18 @@ uint32_t btorsim_bv_hash (const BtorSimBitVector *bv);
 void btorsim_bv_print (const BtorSimBitVector *bv);
 void btorsim_bv_print_all (const BtorSimBitVector *bv);
 void btorsim_bv_print_without_new_line (const BtorSimBitVector *bv);
+void btorsim_bv_fprint_without_new_line (FILE *file,
+                                         const BtorSimBitVector *bv);
 
 char *btorsim_bv_to_char (const BtorSimBitVector *bv);
 char *btorsim_bv_to_hex_char (const BtorSimBitVector *bv);
 char *btorsim_bv_to_dec_char (const BtorSimBitVector *bv);
 
+/* write the binary ('width' + 1 bytes) and hexadecimal ('(width + 3) / 4' + 1
+ * bytes) representation of 'bv' including the terminating '\0' to 'buf' */
+void btorsim_bv_to_char_buf (const BtorSimBitVector *bv, char *buf);
+void btorsim_bv_to_hex_char_buf (const BtorSimBitVector *bv, char *buf);
+
 uint64_t btorsim_bv_to_uint64 (const BtorSimBitVector *bv);
 
 /*------------------------------------------------------------------------*/
@@ -123,6 +139,22 @@ uint32_t btorsim_bv_get_num_leading_ones (const BtorSimBitVector *bv);
 
 /*------------------------------------------------------------------------*/
 
+/* predicates, return the value of the 1-bit result of the corresponding
+ * operation below without allocating it */
+
+bool btorsim_bv_redor_p (const BtorSimBitVector *bv);
+bool btorsim_bv_redand_p (const BtorSimBitVector *bv);
+bool btorsim_bv_redxor_p (const BtorSimBitVector *bv);
+
+bool btorsim_bv_eq_p (const BtorSimBitVector *a, const BtorSimBitVector *b);
+bool btorsim_bv_neq_p (const BtorSimBitVector *a, const BtorSimBitVector *b);
+bool btorsim_bv_ult_p (const BtorSimBitVector *a, const BtorSimBitVector *b);
+bool btorsim_bv_ulte_p (const BtorSimBitVector *a, const BtorSimBitVector *b);
+bool btorsim_bv_slt_p (const BtorSimBitVector *a, const BtorSimBitVector *b);
+bool btorsim_bv_slte_p (const BtorSimBitVector *a, const BtorSimBitVector *b);
+
+/*------------------------------------------------------------------------*/
+
 #define btorsim_bv_zero(BW) btorsim_bv_new (BW)
 
 BtorSimBitVector *btorsim_bv_one (uint32_t bw);
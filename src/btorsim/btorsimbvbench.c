@@ -0,0 +1,718 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "btorsimbatch.h"
+#include "btorsimbv.h"
+#include "btorsimrng.h"
+
+/*------------------------------------------------------------------------*/
+
+static const char *usage =
+    "usage: btorsimbv-bench [ <option> ... ]\n"
+    "\n"
+    "where <option> is one of the following\n"
+    "\n"
+    "  -h        print this command line option summary\n"
+    "  -s <s>    random seed for operands (default '0')\n"
+    "  -t <ms>   time budget per operation and width (default 20)\n"
+    "  -o <op>   only run operation <op> (may be given multiple times)\n"
+    "  -w <w>    only run bit-width <w> (may be given multiple times)\n"
+    "\n"
+    "Results are printed in JSON format.  Allocations are only counted on\n"
+    "Linux and reported as 'null' otherwise.\n";
+
+static const uint32_t default_widths[] = {
+    1, 8, 32, 64, 65, 128, 256, 1024, 8192, 65536};
+
+#define NDEFAULT_WIDTHS (sizeof default_widths / sizeof *default_widths)
+
+/* number of random operands per width, cycled through while timing, and
+ * number of values in the operand batches */
+#define NOPERANDS 64
+
+static BtorSimRNG rng;
+static BtorSimRNG64 rng64;
+
+static BtorSimBitVector *opa[NOPERANDS]; /* random */
+static BtorSimBitVector *opb[NOPERANDS]; /* random */
+static BtorSimBitVector *opc[NOPERANDS]; /* random 1-bit condition */
+static BtorSimBitVector *opn[NOPERANDS]; /* shift amount < width */
+static BtorSimBitVector *opx[NOPERANDS]; /* scratch for in-place updates */
+static char *opstr[NOPERANDS], *opdec[NOPERANDS], *ophex[NOPERANDS];
+static uint32_t oppos[NOPERANDS]; /* bit index < width */
+static uint64_t opu64[NOPERANDS];
+static char *strbuf;
+
+static uint64_t *batcha, *batchb, *batchc, *batchout;
+
+/*------------------------------------------------------------------------*/
+
+#ifdef BTORSIMBV_BENCH_COUNT_ALLOCS
+/* the bench is linked with '--wrap' for these functions */
+void *__real_malloc (size_t);
+void *__real_calloc (size_t, size_t);
+void *__real_realloc (void *, size_t);
+
+static uint64_t num_allocs;
+
+void *
+__wrap_malloc (size_t size)
+{
+  num_allocs++;
+  return __real_malloc (size);
+}
+
+void *
+__wrap_calloc (size_t nobj, size_t size)
+{
+  num_allocs++;
+  return __real_calloc (nobj, size);
+}
+
+void *
+__wrap_realloc (void *p, size_t size)
+{
+  num_allocs++;
+  return __real_realloc (p, size);
+}
+#endif
+
+/*------------------------------------------------------------------------*/
+
+/* each benchmark performs one operation on operand set 'i' and releases its
+ * result */
+
+#define BENCH_UNARY(op)                         \
+  static void bench_##op (uint32_t i)           \
+  {                                             \
+    btorsim_bv_free (btorsim_bv_##op (opa[i])); \
+  }
+
+#define BENCH_BINARY(op)                                \
+  static void bench_##op (uint32_t i)                   \
+  {                                                     \
+    btorsim_bv_free (btorsim_bv_##op (opa[i], opb[i])); \
+  }
+
+#define BENCH_SHIFT(op)                                 \
+  static void bench_##op (uint32_t i)                   \
+  {                                                     \
+    btorsim_bv_free (btorsim_bv_##op (opa[i], opn[i])); \
+  }
+
+#define BENCH_QUERY(op)               \
+  static void bench_##op (uint32_t i) \
+  {                                   \
+    (void) btorsim_bv_##op (opa[i]);  \
+  }
+
+#define BENCH_PREDICATE(op)                  \
+  static void bench_##op (uint32_t i)        \
+  {                                          \
+    (void) btorsim_bv_##op (opa[i], opb[i]); \
+  }
+
+/* batched operations process all NOPERANDS values at once */
+
+#define BENCH_BATCH_UNARY(op)                                           \
+  static void bench_batch_##op (uint32_t i)                             \
+  {                                                                     \
+    (void) i;                                                           \
+    btorsim_bv_batch_##op (opa[0]->width, NOPERANDS, batcha, batchout); \
+  }
+
+#define BENCH_BATCH_BINARY(op)                               \
+  static void bench_batch_##op (uint32_t i)                  \
+  {                                                          \
+    (void) i;                                                \
+    btorsim_bv_batch_##op (                                  \
+        opa[0]->width, NOPERANDS, batcha, batchb, batchout); \
+  }
+
+BENCH_UNARY (copy)
+BENCH_UNARY (neg)
+BENCH_UNARY (not)
+BENCH_UNARY (inc)
+BENCH_UNARY (dec)
+BENCH_UNARY (redor)
+BENCH_UNARY (redand)
+BENCH_UNARY (redxor)
+
+BENCH_BINARY (add)
+BENCH_BINARY (sub)
+BENCH_BINARY (and)
+BENCH_BINARY (implies)
+BENCH_BINARY (nand)
+BENCH_BINARY (nor)
+BENCH_BINARY (or)
+BENCH_BINARY (xnor)
+BENCH_BINARY (xor)
+BENCH_BINARY (eq)
+BENCH_BINARY (neq)
+BENCH_BINARY (ult)
+BENCH_BINARY (ulte)
+BENCH_BINARY (slt)
+BENCH_BINARY (slte)
+BENCH_BINARY (mul)
+BENCH_BINARY (udiv)
+BENCH_BINARY (sdiv)
+BENCH_BINARY (urem)
+BENCH_BINARY (srem)
+BENCH_BINARY (smod)
+BENCH_BINARY (concat)
+
+BENCH_SHIFT (sll)
+BENCH_SHIFT (srl)
+BENCH_SHIFT (sra)
+BENCH_SHIFT (rol)
+BENCH_SHIFT (ror)
+
+BENCH_QUERY (size)
+BENCH_QUERY (hash)
+BENCH_QUERY (is_true)
+BENCH_QUERY (is_false)
+BENCH_QUERY (is_zero)
+BENCH_QUERY (is_ones)
+BENCH_QUERY (is_one)
+BENCH_QUERY (power_of_two)
+BENCH_QUERY (small_positive_int)
+BENCH_QUERY (get_num_trailing_zeros)
+BENCH_QUERY (get_num_leading_zeros)
+BENCH_QUERY (get_num_leading_ones)
+BENCH_QUERY (redor_p)
+BENCH_QUERY (redand_p)
+BENCH_QUERY (redxor_p)
+BENCH_QUERY (to_uint64)
+
+BENCH_PREDICATE (compare)
+BENCH_PREDICATE (eq_p)
+BENCH_PREDICATE (neq_p)
+BENCH_PREDICATE (ult_p)
+BENCH_PREDICATE (ulte_p)
+BENCH_PREDICATE (slt_p)
+BENCH_PREDICATE (slte_p)
+BENCH_PREDICATE (is_umulo)
+
+BENCH_BATCH_UNARY (not)
+BENCH_BATCH_UNARY (neg)
+BENCH_BATCH_BINARY (and)
+BENCH_BATCH_BINARY (or)
+BENCH_BATCH_BINARY (xor)
+BENCH_BATCH_BINARY (add)
+BENCH_BATCH_BINARY (sub)
+BENCH_BATCH_BINARY (mul)
+BENCH_BATCH_BINARY (eq)
+BENCH_BATCH_BINARY (ult)
+
+static void
+bench_new (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_new (opa[i]->width));
+}
+
+static void
+bench_new_random (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_new_random (&rng, opa[i]->width));
+}
+
+static void
+bench_new_random_bit_range (uint32_t i)
+{
+  uint32_t w = opa[i]->width;
+  btorsim_bv_free (btorsim_bv_new_random_bit_range (&rng, w, w - 1, w / 3));
+}
+
+static void
+bench_new_random64 (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_new_random64 (&rng64, opa[i]->width));
+}
+
+static void
+bench_new_random64_bit_range (uint32_t i)
+{
+  uint32_t w = opa[i]->width;
+  btorsim_bv_free (
+      btorsim_bv_new_random64_bit_range (&rng64, w, w - 1, w / 3));
+}
+
+static void
+bench_one (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_one (opa[i]->width));
+}
+
+static void
+bench_ones (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_ones (opa[i]->width));
+}
+
+static void
+bench_uint64_to_bv (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_uint64_to_bv (opu64[i], opa[i]->width));
+}
+
+static void
+bench_int64_to_bv (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_int64_to_bv ((int64_t) opu64[i], opa[i]->width));
+}
+
+static void
+bench_char_to_bv (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_char_to_bv (opstr[i]));
+}
+
+static void
+bench_const (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_const (opstr[i], opa[i]->width));
+}
+
+static void
+bench_constd (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_constd (opdec[i], opa[i]->width));
+}
+
+static void
+bench_consth (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_consth (ophex[i], opa[i]->width));
+}
+
+static void
+bench_to_char (uint32_t i)
+{
+  free (btorsim_bv_to_char (opa[i]));
+}
+
+static void
+bench_to_hex_char (uint32_t i)
+{
+  free (btorsim_bv_to_hex_char (opa[i]));
+}
+
+static void
+bench_to_dec_char (uint32_t i)
+{
+  free (btorsim_bv_to_dec_char (opa[i]));
+}
+
+static void
+bench_to_char_buf (uint32_t i)
+{
+  btorsim_bv_to_char_buf (opa[i], strbuf);
+}
+
+static void
+bench_to_hex_char_buf (uint32_t i)
+{
+  btorsim_bv_to_hex_char_buf (opa[i], strbuf);
+}
+
+static void
+bench_get_bit (uint32_t i)
+{
+  (void) btorsim_bv_get_bit (opa[i], oppos[i]);
+}
+
+static void
+bench_set_bit (uint32_t i)
+{
+  btorsim_bv_set_bit (opx[i], oppos[i], 1);
+}
+
+static void
+bench_flip_bit (uint32_t i)
+{
+  btorsim_bv_flip_bit (opx[i], oppos[i]);
+}
+
+static void
+bench_flipped_bit (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_flipped_bit (opa[i], oppos[i]));
+}
+
+static void
+bench_flipped_bit_range (uint32_t i)
+{
+  uint32_t w = opa[i]->width;
+  btorsim_bv_free (btorsim_bv_flipped_bit_range (opa[i], w - 1, w / 3));
+}
+
+static void
+bench_ite (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_ite (opc[i], opa[i], opb[i]));
+}
+
+static void
+bench_slice (uint32_t i)
+{
+  uint32_t w = opa[i]->width;
+  btorsim_bv_free (btorsim_bv_slice (opa[i], w - 1, w / 3));
+}
+
+static void
+bench_uext (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_uext (opa[i], opa[i]->width));
+}
+
+static void
+bench_sext (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_sext (opa[i], opa[i]->width));
+}
+
+static void
+bench_batch_set (uint32_t i)
+{
+  btorsim_bv_batch_set (opa[i]->width, NOPERANDS, batchout, i, opa[i]);
+}
+
+static void
+bench_batch_get (uint32_t i)
+{
+  btorsim_bv_free (btorsim_bv_batch_get (opa[i]->width, NOPERANDS, batcha, i));
+}
+
+static void
+bench_batch_random (uint32_t i)
+{
+  (void) i;
+  btorsim_bv_batch_random (&rng64, opa[0]->width, NOPERANDS, batchout);
+}
+
+static void
+bench_batch_ite (uint32_t i)
+{
+  (void) i;
+  btorsim_bv_batch_ite (
+      opa[0]->width, NOPERANDS, batchc, batcha, batchb, batchout);
+}
+
+struct Benchmark
+{
+  const char *name;
+  void (*run) (uint32_t);
+  uint32_t num_values; /* number of values processed per call */
+};
+
+#define SCALAR(op) {#op, bench_##op, 1}
+#define BATCH(op) {"batch_" #op, bench_batch_##op, NOPERANDS}
+
+static const struct Benchmark benchmarks[] = {
+    SCALAR (new),
+    SCALAR (new_random),
+    SCALAR (new_random_bit_range),
+    SCALAR (new_random64),
+    SCALAR (new_random64_bit_range),
+    SCALAR (one),
+    SCALAR (ones),
+    SCALAR (copy),
+    SCALAR (uint64_to_bv),
+    SCALAR (int64_to_bv),
+    SCALAR (char_to_bv),
+    SCALAR (const),
+    SCALAR (constd),
+    SCALAR (consth),
+    SCALAR (to_char),
+    SCALAR (to_hex_char),
+    SCALAR (to_dec_char),
+    SCALAR (to_char_buf),
+    SCALAR (to_hex_char_buf),
+    SCALAR (to_uint64),
+    SCALAR (size),
+    SCALAR (hash),
+    SCALAR (compare),
+    SCALAR (get_bit),
+    SCALAR (set_bit),
+    SCALAR (flip_bit),
+    SCALAR (is_true),
+    SCALAR (is_false),
+    SCALAR (is_zero),
+    SCALAR (is_ones),
+    SCALAR (is_one),
+    SCALAR (power_of_two),
+    SCALAR (small_positive_int),
+    SCALAR (get_num_trailing_zeros),
+    SCALAR (get_num_leading_zeros),
+    SCALAR (get_num_leading_ones),
+    SCALAR (redor_p),
+    SCALAR (redand_p),
+    SCALAR (redxor_p),
+    SCALAR (eq_p),
+    SCALAR (neq_p),
+    SCALAR (ult_p),
+    SCALAR (ulte_p),
+    SCALAR (slt_p),
+    SCALAR (slte_p),
+    SCALAR (neg),
+    SCALAR (not),
+    SCALAR (inc),
+    SCALAR (dec),
+    SCALAR (redor),
+    SCALAR (redand),
+    SCALAR (redxor),
+    SCALAR (add),
+    SCALAR (sub),
+    SCALAR (and),
+    SCALAR (implies),
+    SCALAR (nand),
+    SCALAR (nor),
+    SCALAR (or),
+    SCALAR (xnor),
+    SCALAR (xor),
+    SCALAR (eq),
+    SCALAR (neq),
+    SCALAR (ult),
+    SCALAR (ulte),
+    SCALAR (slt),
+    SCALAR (slte),
+    SCALAR (sll),
+    SCALAR (srl),
+    SCALAR (sra),
+    SCALAR (rol),
+    SCALAR (ror),
+    SCALAR (mul),
+    SCALAR (udiv),
+    SCALAR (sdiv),
+    SCALAR (urem),
+    SCALAR (srem),
+    SCALAR (smod),
+    SCALAR (ite),
+    SCALAR (concat),
+    SCALAR (slice),
+    SCALAR (uext),
+    SCALAR (sext),
+    SCALAR (flipped_bit),
+    SCALAR (flipped_bit_range),
+    SCALAR (is_umulo),
+    SCALAR (batch_set),
+    SCALAR (batch_get),
+    BATCH (random),
+    BATCH (not),
+    BATCH (neg),
+    BATCH (and),
+    BATCH (or),
+    BATCH (xor),
+    BATCH (add),
+    BATCH (sub),
+    BATCH (mul),
+    BATCH (eq),
+    BATCH (ult),
+    BATCH (ite),
+};
+
+#define NBENCHMARKS (sizeof benchmarks / sizeof *benchmarks)
+
+/*------------------------------------------------------------------------*/
+
+static double
+get_time (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+static void
+setup_operands (uint32_t width)
+{
+  uint32_t i, nlimbs;
+  for (i = 0; i < NOPERANDS; i++)
+  {
+    opa[i]   = btorsim_bv_new_random (&rng, width);
+    opb[i]   = btorsim_bv_new_random (&rng, width);
+    opc[i]   = btorsim_bv_new_random (&rng, 1);
+    opn[i]   = btorsim_bv_uint64_to_bv (btorsim_rng_rand (&rng) % width, width);
+    opx[i]   = btorsim_bv_copy (opa[i]);
+    opstr[i] = btorsim_bv_to_char (opa[i]);
+    opdec[i] = btorsim_bv_to_dec_char (opa[i]);
+    ophex[i] = btorsim_bv_to_hex_char (opa[i]);
+    oppos[i] = btorsim_rng_rand (&rng) % width;
+    opu64[i] = (uint64_t) btorsim_rng_rand (&rng) << 32;
+    opu64[i] |= btorsim_rng_rand (&rng);
+  }
+  strbuf   = malloc (width + 1);
+  nlimbs   = BTORSIM_BV_BATCH_LIMBS (width);
+  batcha   = malloc (nlimbs * NOPERANDS * sizeof *batcha);
+  batchb   = malloc (nlimbs * NOPERANDS * sizeof *batchb);
+  batchc   = malloc (NOPERANDS * sizeof *batchc);
+  batchout = malloc (nlimbs * NOPERANDS * sizeof *batchout);
+  for (i = 0; i < NOPERANDS; i++)
+  {
+    btorsim_bv_batch_set (width, NOPERANDS, batcha, i, opa[i]);
+    btorsim_bv_batch_set (width, NOPERANDS, batchb, i, opb[i]);
+    btorsim_bv_batch_set (1, NOPERANDS, batchc, i, opc[i]);
+  }
+}
+
+static void
+release_operands (void)
+{
+  uint32_t i;
+  for (i = 0; i < NOPERANDS; i++)
+  {
+    btorsim_bv_free (opa[i]);
+    btorsim_bv_free (opb[i]);
+    btorsim_bv_free (opc[i]);
+    btorsim_bv_free (opn[i]);
+    btorsim_bv_free (opx[i]);
+    free (opstr[i]);
+    free (opdec[i]);
+    free (ophex[i]);
+  }
+  free (strbuf);
+  free (batcha);
+  free (batchb);
+  free (batchc);
+  free (batchout);
+}
+
+/* run 'b' for at least 'budget' seconds, return the number of calls and set
+ * '*elapsed' and '*allocs' to the time taken and the allocations made */
+static uint64_t
+run_benchmark (const struct Benchmark *b,
+               double budget,
+               double *elapsed,
+               uint64_t *allocs)
+{
+  uint64_t n, i, batch;
+  double start;
+
+#ifdef BTORSIMBV_BENCH_COUNT_ALLOCS
+  uint64_t allocs_start = num_allocs;
+#endif
+
+  /* double the batch size between clock readings to keep timing overhead
+   * low for cheap operations without overshooting for expensive ones */
+  n     = 0;
+  batch = 1;
+  start = get_time ();
+  do
+  {
+    for (i = 0; i < batch; i++) b->run ((n + i) % NOPERANDS);
+    n += batch;
+    if (batch < 1024) batch *= 2;
+    *elapsed = get_time () - start;
+  } while (*elapsed < budget);
+
+#ifdef BTORSIMBV_BENCH_COUNT_ALLOCS
+  *allocs = num_allocs - allocs_start;
+#else
+  *allocs = 0;
+#endif
+  return n;
+}
+
+static bool
+is_selected (const char *name, char **only, uint32_t num_only)
+{
+  uint32_t i;
+  if (!num_only) return true;
+  for (i = 0; i < num_only; i++)
+    if (!strcmp (only[i], name)) return true;
+  return false;
+}
+
+int32_t
+main (int32_t argc, char *argv[])
+{
+  char **only;
+  uint32_t *widths, num_only = 0, num_widths = 0;
+  uint32_t seed = 0, budget_ms = 20, i, j;
+  uint64_t calls, allocs;
+  double elapsed, values;
+  bool first = true;
+
+  only   = malloc (argc * sizeof *only);
+  widths = malloc ((argc + NDEFAULT_WIDTHS) * sizeof *widths);
+  for (i = 1; i < (uint32_t) argc; i++)
+  {
+    if (!strcmp (argv[i], "-h"))
+    {
+      fputs (usage, stdout);
+      return 0;
+    }
+    else if (!strcmp (argv[i], "-s") && i + 1 < (uint32_t) argc)
+      seed = (uint32_t) atol (argv[++i]);
+    else if (!strcmp (argv[i], "-t") && i + 1 < (uint32_t) argc)
+      budget_ms = (uint32_t) atol (argv[++i]);
+    else if (!strcmp (argv[i], "-o") && i + 1 < (uint32_t) argc)
+      only[num_only++] = argv[++i];
+    else if (!strcmp (argv[i], "-w") && i + 1 < (uint32_t) argc)
+    {
+      widths[num_widths] = (uint32_t) atol (argv[++i]);
+      if (!widths[num_widths])
+      {
+        fprintf (stderr, "*** btorsimbv-bench: invalid width '%s'\n", argv[i]);
+        return 1;
+      }
+      num_widths++;
+    }
+    else
+    {
+      fprintf (stderr, "*** btorsimbv-bench: invalid option '%s'\n", argv[i]);
+      return 1;
+    }
+  }
+  if (!num_widths)
+  {
+    for (j = 0; j < NDEFAULT_WIDTHS; j++) widths[j] = default_widths[j];
+    num_widths = NDEFAULT_WIDTHS;
+  }
+
+  btorsim_rng_init (&rng, seed);
+  btorsim_rng64_init (&rng64, seed);
+  printf ("{\n  \"seed\": %u,\n  \"results\": [", seed);
+  for (j = 0; j < num_widths; j++)
+  {
+    setup_operands (widths[j]);
+    for (i = 0; i < NBENCHMARKS; i++)
+    {
+      const struct Benchmark *b = benchmarks + i;
+      if (!is_selected (b->name, only, num_only)) continue;
+      calls  = run_benchmark (b, budget_ms / 1000.0, &elapsed, &allocs);
+      values = (double) calls * b->num_values;
+      printf (
+          "%s\n    {\"operation\": \"%s\", \"width\": %u, \"ns_per_op\": %.2f",
+          first ? "" : ",",
+          b->name,
+          widths[j],
+          1e9 * elapsed / values);
+#ifdef BTORSIMBV_BENCH_COUNT_ALLOCS
+      printf (", \"allocs_per_op\": %.2f}", allocs / values);
+#else
+      (void) allocs;
+      printf (", \"allocs_per_op\": null}");
+#endif
+      fflush (stdout);
+      first = false;
+    }
+    release_operands ();
+  }
+  printf ("\n  ]\n}\n");
+  free (only);
+  free (widths);
+  return 0;
+}
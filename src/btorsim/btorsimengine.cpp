@@ -0,0 +1,768 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#include "btorsimengine.h"
+
+#include <cinttypes>
+#include <cstring>
+
+#include "btorsimhelpers.h"
+
+/*------------------------------------------------------------------------*/
+
+BtorSimModel::~BtorSimModel ()
+{
+  if (parser) btor2parser_delete (parser);
+}
+
+bool
+BtorSimModel::parse_line (Btor2Line *l, const char *path)
+{
+  char buf[256];
+  switch (l->tag)
+  {
+    case BTOR2_TAG_bad: {
+      int64_t i = (int64_t) bads.size ();
+      msg (2, "bad %" PRId64 " at line %" PRId64, i, l->lineno);
+      bads.push_back (l);
+      num_simulated_bads++;
+    }
+    break;
+
+    case BTOR2_TAG_constraint: {
+      int64_t i = (int64_t) constraints.size ();
+      msg (2, "constraint %" PRId64 " at line %" PRId64, i, l->lineno);
+      constraints.push_back (l);
+    }
+    break;
+
+    case BTOR2_TAG_init: inits[l->args[0]] = l; break;
+
+    case BTOR2_TAG_input: {
+      int64_t i = (int64_t) inputs.size ();
+      if (l->symbol)
+        msg (2,
+             "input %" PRId64 " '%s' at line %" PRId64,
+             i,
+             l->symbol,
+             l->lineno);
+      else
+        msg (2, "input %" PRId64 " at line %" PRId64, i, l->lineno);
+      inputs.push_back (l);
+    }
+    break;
+
+    case BTOR2_TAG_next: nexts[l->args[0]] = l; break;
+
+    case BTOR2_TAG_sort: {
+      switch (l->sort.tag)
+      {
+        case BTOR2_TAG_SORT_bitvec:
+          msg (2,
+               "sort bitvec %u at line %" PRId64,
+               l->sort.bitvec.width,
+               l->lineno);
+          break;
+        case BTOR2_TAG_SORT_array:
+          msg (2,
+               "sort array %u %u at line %" PRId64,
+               l->sort.array.index,
+               l->sort.array.element,
+               l->lineno);
+          break;
+        default:
+          snprintf (buf,
+                    sizeof buf,
+                    "parse error in '%s' at line %" PRId64
+                    ": unsupported sort '%s'",
+                    path,
+                    l->lineno,
+                    l->sort.name);
+          error = buf;
+          return false;
+      }
+    }
+    break;
+
+    case BTOR2_TAG_state: {
+      int64_t i = (int64_t) states.size ();
+      if (l->symbol)
+      {
+        msg (2,
+             "state %" PRId64 " '%s' at line %" PRId64,
+             i,
+             l->symbol,
+             l->lineno);
+      }
+      else
+      {
+        msg (2, "state %" PRId64 " at line %" PRId64, i, l->lineno);
+      }
+      states.push_back (l);
+    }
+    break;
+
+    case BTOR2_TAG_add:
+    case BTOR2_TAG_and:
+    case BTOR2_TAG_concat:
+    case BTOR2_TAG_const:
+    case BTOR2_TAG_constd:
+    case BTOR2_TAG_consth:
+    case BTOR2_TAG_dec:
+    case BTOR2_TAG_eq:
+    case BTOR2_TAG_implies:
+    case BTOR2_TAG_inc:
+    case BTOR2_TAG_ite:
+    case BTOR2_TAG_iff:
+    case BTOR2_TAG_mul:
+    case BTOR2_TAG_nand:
+    case BTOR2_TAG_neg:
+    case BTOR2_TAG_neq:
+    case BTOR2_TAG_nor:
+    case BTOR2_TAG_not:
+    case BTOR2_TAG_one:
+    case BTOR2_TAG_ones:
+    case BTOR2_TAG_or:
+    case BTOR2_TAG_output:
+    case BTOR2_TAG_redand:
+    case BTOR2_TAG_redor:
+    case BTOR2_TAG_redxor:
+    case BTOR2_TAG_rol:
+    case BTOR2_TAG_ror:
+    case BTOR2_TAG_sdiv:
+    case BTOR2_TAG_sext:
+    case BTOR2_TAG_sgt:
+    case BTOR2_TAG_sgte:
+    case BTOR2_TAG_slice:
+    case BTOR2_TAG_sll:
+    case BTOR2_TAG_slt:
+    case BTOR2_TAG_slte:
+    case BTOR2_TAG_smod:
+    case BTOR2_TAG_sra:
+    case BTOR2_TAG_srem:
+    case BTOR2_TAG_srl:
+    case BTOR2_TAG_sub:
+    case BTOR2_TAG_udiv:
+    case BTOR2_TAG_uext:
+    case BTOR2_TAG_ugt:
+    case BTOR2_TAG_ugte:
+    case BTOR2_TAG_ult:
+    case BTOR2_TAG_ulte:
+    case BTOR2_TAG_urem:
+    case BTOR2_TAG_xnor:
+    case BTOR2_TAG_xor:
+    case BTOR2_TAG_zero:
+    case BTOR2_TAG_read:
+    case BTOR2_TAG_write: break;
+
+    case BTOR2_TAG_fair:
+    case BTOR2_TAG_justice:
+    case BTOR2_TAG_saddo:
+    case BTOR2_TAG_sdivo:
+    case BTOR2_TAG_smulo:
+    case BTOR2_TAG_ssubo:
+    case BTOR2_TAG_uaddo:
+    case BTOR2_TAG_umulo:
+    case BTOR2_TAG_usubo:
+    default:
+      snprintf (buf,
+                sizeof buf,
+                "parse error in '%s' at line %" PRId64
+                ": unsupported '%" PRId64 " %s%s'",
+                path,
+                l->lineno,
+                l->id,
+                l->name,
+                l->nargs ? " ..." : "");
+      error = buf;
+      return false;
+  }
+  return true;
+}
+
+bool
+BtorSimModel::parse (FILE *file, const char *path)
+{
+  assert (!parser);
+  parser = btor2parser_new ();
+  if (!btor2parser_read_lines (parser, file))
+  {
+    error = std::string ("parse error in '") + path + "' at "
+            + btor2parser_error (parser);
+    return false;
+  }
+  num_format_lines = btor2parser_max_id (parser);
+  inits.resize (num_format_lines, nullptr);
+  nexts.resize (num_format_lines, nullptr);
+  Btor2LineIterator it = btor2parser_iter_init (parser);
+  Btor2Line *line;
+  while ((line = btor2parser_iter_next (&it)))
+    if (!parse_line (line, path)) return false;
+
+  for (size_t i = 0; i < states.size (); i++)
+  {
+    Btor2Line *state = states[i];
+    if (!nexts[state->id])
+    {
+      msg (1, "state %d without next function", state->id);
+    }
+  }
+
+  tape.compile (parser);
+  return true;
+}
+
+void
+BtorSimModel::prune (const std::vector<int64_t> &roots)
+{
+  tape.prune (roots);
+  num_simulated_bads = 0;
+  for (auto bad : bads)
+    if (tape.in_coi (bad->id)) num_simulated_bads++;
+}
+
+BtorSimBitVector *
+BtorSimModel::parse_bits (const Btor2Line *l,
+                          const char *bits,
+                          std::string &error) const
+{
+  if (l->sort.tag != BTOR2_TAG_SORT_bitvec)
+  {
+    error = "can not set array '" + std::to_string (l->id) + "'";
+    return nullptr;
+  }
+  size_t n = strlen (bits);
+  if (n != l->sort.bitvec.width || strspn (bits, "01") != n)
+  {
+    error = "expected " + std::to_string (l->sort.bitvec.width)
+            + " bits '0' or '1' for '" + std::to_string (l->id) + "'";
+    return nullptr;
+  }
+  return btorsim_bv_char_to_bv (bits);
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSim::BtorSim (BtorSimModel &model) : model (model)
+{
+  const int64_t num_format_lines = model.num_format_lines;
+  const BtorSimTape &tape        = model.tape;
+  current_state.resize (tape.num_slots ());
+  next_state.resize (num_format_lines);
+  btorsim_rng_init (&rng, 0);
+
+  for (int64_t i = 0; i < num_format_lines; i++)
+  {
+    Btor2Line *l = btor2parser_get_line_by_id (model.parser, i);
+    if (l)
+    {
+      Btor2Sort *sort = get_sort (l, model.parser);
+      switch (sort->tag)
+      {
+        case BTOR2_TAG_SORT_bitvec:
+          current_state[i].type  = BtorSimState::Type::BITVEC;
+          current_state[i].width = sort->bitvec.width;
+          next_state[i].type     = BtorSimState::Type::BITVEC;
+          next_state[i].width    = sort->bitvec.width;
+          break;
+        case BTOR2_TAG_SORT_array:
+          current_state[i].type = BtorSimState::Type::ARRAY;
+          next_state[i].type    = BtorSimState::Type::ARRAY;
+          break;
+        default: die ("Unknown sort");
+      }
+    }
+  }
+
+  /* negated operands */
+  for (int64_t i = num_format_lines; i < tape.num_slots (); i++)
+  {
+    current_state[i].type  = BtorSimState::Type::BITVEC;
+    current_state[i].width = tape.slot_width (i);
+  }
+
+  tape.execute_constants (current_state);
+
+  for (auto state : model.states)
+  {
+    assert (current_state[state->id].type != BtorSimState::Type::INVALID);
+    assert (next_state[state->id].type != BtorSimState::Type::INVALID);
+    (void) state;
+  }
+
+  reached_bads.assign (model.bads.size (), -1);
+  num_unreached_bads = model.num_simulated_bads;
+}
+
+BtorSim::~BtorSim ()
+{
+  for (BtorSimState &s : current_state)
+    if (s.type) s.remove ();
+  for (BtorSimState &s : next_state)
+    if (s.type) s.remove ();
+}
+
+void
+BtorSim::update_current_state (int64_t id, BtorSimBitVector *bv)
+{
+  assert (0 <= id), assert (id < model.num_format_lines);
+  msg (5, "updating state %" PRId64, id);
+  current_state[id].update (bv);
+}
+
+void
+BtorSim::update_current_state (int64_t id, BtorSimArrayModel *am)
+{
+  assert (0 <= id), assert (id < model.num_format_lines);
+  msg (5, "updating state %" PRId64, id);
+  current_state[id].update (am);
+}
+
+void
+BtorSim::update_current_state (int64_t id, BtorSimState &s)
+{
+  assert (0 <= id), assert (id < model.num_format_lines);
+  msg (5, "updating state %" PRId64, id);
+  current_state[id].update (s);
+}
+
+void
+BtorSim::delete_current_state (int64_t id)
+{
+  assert (0 <= id), assert (id < model.num_format_lines);
+  if (current_state[id].type) current_state[id].remove ();
+}
+
+BtorSimState
+BtorSim::get_value (int64_t id) const
+{
+  const BtorSimState &s = current_state[model.tape.slot (id)];
+  assert (s.is_set ());
+  return s.copy ();
+}
+
+void
+BtorSim::initialize_input (size_t pos, bool randomize)
+{
+  Btor2Line *input = model.inputs[pos];
+  if (current_state[input->id].is_set ()) return;
+  if (input->sort.tag == BTOR2_TAG_SORT_bitvec)
+  {
+    uint32_t width = input->sort.bitvec.width;
+    BtorSimBitVector *update;
+    if (randomize)
+      update = btorsim_bv_new_random (&rng, width);
+    else
+      update = btorsim_bv_new (width);
+    update_current_state (input->id, update);
+  }
+  else
+  {
+    assert (input->sort.tag == BTOR2_TAG_SORT_array);
+    Btor2Line *li =
+        btor2parser_get_line_by_id (model.parser, input->sort.array.index);
+    Btor2Line *le =
+        btor2parser_get_line_by_id (model.parser, input->sort.array.element);
+    assert (li->sort.tag == BTOR2_TAG_SORT_bitvec);
+    assert (le->sort.tag == BTOR2_TAG_SORT_bitvec);
+    BtorSimArrayModel *am =
+        new BtorSimArrayModel (li->sort.bitvec.width, le->sort.bitvec.width);
+    if (randomize)
+    {
+      am->random_seed = btorsim_rng_rand (&rng);
+    }
+    update_current_state (input->id, am);
+  }
+}
+
+void
+BtorSim::initialize_state (size_t pos, bool randomly)
+{
+  Btor2Line *state = model.states[pos];
+  assert (0 <= state->id), assert (state->id < model.num_format_lines);
+  Btor2Line *init = model.inits[state->id];
+  if (current_state[state->id].is_set ()) return;
+  switch (current_state[state->id].type)
+  {
+    case BtorSimState::Type::BITVEC: {
+      assert (state->sort.tag == BTOR2_TAG_SORT_bitvec);
+      if (init)
+      {
+        assert (init->nargs == 2);
+        assert (init->args[0] == state->id);
+        model.tape.execute_init (state->id, current_state);
+        BtorSimState update = get_value (init->args[1]);
+        assert (update.type == BtorSimState::Type::BITVEC);
+        update_current_state (state->id, update);
+      }
+      else
+      {
+        BtorSimBitVector *bv;
+        if (randomly)
+          bv = btorsim_bv_new_random (&rng, state->sort.bitvec.width);
+        else
+          bv = btorsim_bv_new (state->sort.bitvec.width);
+        update_current_state (state->id, bv);
+      }
+    }
+    break;
+    case BtorSimState::Type::ARRAY:
+      assert (state->sort.tag == BTOR2_TAG_SORT_array);
+      if (init)
+      {
+        assert (init->nargs == 2);
+        assert (init->args[0] == state->id);
+        model.tape.execute_init (state->id, current_state);
+        BtorSimState update = get_value (init->args[1]);
+        switch (update.type)
+        {
+          case BtorSimState::Type::ARRAY:
+            update_current_state (state->id, update);
+            break;
+          case BtorSimState::Type::BITVEC: {
+            Btor2Line *li = btor2parser_get_line_by_id (
+                model.parser, state->sort.array.index);
+            Btor2Line *le = btor2parser_get_line_by_id (
+                model.parser, state->sort.array.element);
+            assert (li->sort.tag == BTOR2_TAG_SORT_bitvec);
+            assert (le->sort.tag == BTOR2_TAG_SORT_bitvec);
+            BtorSimArrayModel *am = new BtorSimArrayModel (
+                li->sort.bitvec.width, le->sort.bitvec.width);
+            am->const_init = update.copy_bv ();
+            update.remove ();
+            update_current_state (state->id, am);
+          }
+          break;
+          default: die ("bad result simulating %" PRId64, init->args[1]);
+        }
+      }
+      else
+      {
+        Btor2Line *li =
+            btor2parser_get_line_by_id (model.parser, state->sort.array.index);
+        Btor2Line *le = btor2parser_get_line_by_id (model.parser,
+                                                    state->sort.array.element);
+        assert (li->sort.tag == BTOR2_TAG_SORT_bitvec);
+        assert (le->sort.tag == BTOR2_TAG_SORT_bitvec);
+        BtorSimArrayModel *am = new BtorSimArrayModel (li->sort.bitvec.width,
+                                                       le->sort.bitvec.width);
+        if (randomly)
+        {
+          am->random_seed = btorsim_rng_rand (&rng);
+        }
+        update_current_state (state->id, am);
+      }
+      break;
+    default: die ("uninitialized current_state %" PRId64, state->id);
+  }
+}
+
+void
+BtorSim::update_next_states (bool randomize_states_that_are_inputs)
+{
+  const BtorSimTape &tape = model.tape;
+  for (size_t i = 0; i < model.states.size (); i++)
+  {
+    Btor2Line *state = model.states[i];
+    assert (0 <= state->id), assert (state->id < model.num_format_lines);
+    Btor2Line *next = model.nexts[state->id];
+    if (next && !tape.in_coi (state->id)) continue;
+    BtorSimState update;
+    if (next)
+    {
+      assert (next->nargs == 2);
+      assert (next->args[0] == state->id);
+      update = get_value (next->args[1]);
+    }
+    else
+    {
+      if (state->sort.tag == BTOR2_TAG_SORT_bitvec)
+      {
+        update.type    = BtorSimState::Type::BITVEC;
+        uint32_t width = state->sort.bitvec.width;
+        update.width   = width;
+        if (randomize_states_that_are_inputs)
+          update.update (btorsim_bv_new_random (&rng, width));
+        else
+          update.update (btorsim_bv_new (width));
+      }
+      else
+      {
+        assert (state->sort.tag == BTOR2_TAG_SORT_array);
+        update.type = BtorSimState::Type::ARRAY;
+        Btor2Line *li =
+            btor2parser_get_line_by_id (model.parser, state->sort.array.index);
+        Btor2Line *le = btor2parser_get_line_by_id (model.parser,
+                                                    state->sort.array.element);
+        assert (li->sort.tag == BTOR2_TAG_SORT_bitvec);
+        assert (le->sort.tag == BTOR2_TAG_SORT_bitvec);
+        update.array_state = new BtorSimArrayModel (li->sort.bitvec.width,
+                                                    le->sort.bitvec.width);
+        if (randomize_states_that_are_inputs)
+          update.array_state->random_seed = btorsim_rng_rand (&rng);
+      }
+    }
+    assert (!next_state[state->id].is_set ());
+    assert (next_state[state->id].type == update.type);
+    next_state[state->id] = update;
+  }
+}
+
+void
+BtorSim::check_properties (int64_t k)
+{
+  const BtorSimTape &tape = model.tape;
+  if (constraints_violated < 0)
+  {
+    for (size_t i = 0; i < model.constraints.size (); i++)
+    {
+      Btor2Line *constraint = model.constraints[i];
+      const BtorSimState &s = current_state[tape.slot (constraint->args[0])];
+      assert (s.type == BtorSimState::Type::BITVEC);
+      if (!s.is_zero ()) continue;
+      msg (1,
+           "constraint(%" PRId64 ") '%" PRId64 " constraint %" PRId64
+           "' violated at time %" PRId64,
+           i,
+           constraint->id,
+           constraint->args[0],
+           k);
+      constraints_violated = k;
+    }
+  }
+
+  if (constraints_violated < 0)
+  {
+    for (size_t i = 0; i < model.bads.size (); i++)
+    {
+      if (reached_bads[i] >= 0) continue;
+      Btor2Line *bad = model.bads[i];
+      if (!tape.in_coi (bad->id)) continue;
+      const BtorSimState &s = current_state[tape.slot (bad->args[0])];
+      assert (s.type == BtorSimState::Type::BITVEC);
+      if (s.is_zero ()) continue;
+      reached_bads[i] = k;
+      assert (num_unreached_bads > 0);
+      if (!--num_unreached_bads)
+        msg (1,
+             "all %" PRId64 " bad state properties reached",
+             model.num_simulated_bads);
+    }
+  }
+}
+
+void
+BtorSim::delete_inputs ()
+{
+  for (auto input : model.inputs) delete_current_state (input->id);
+}
+
+void
+BtorSim::commit_next_state (size_t pos)
+{
+  Btor2Line *state = model.states[pos];
+  assert (0 <= state->id), assert (state->id < model.num_format_lines);
+  if (model.nexts[state->id] && !model.tape.in_coi (state->id)) return;
+  BtorSimState update = next_state[state->id];
+  assert (update.is_set ());
+  update_current_state (state->id, update);
+  next_state[state->id].release ();
+}
+
+void
+BtorSim::commit_next_states (BtorSimThreadPool *pool)
+{
+  if (!pool)
+  {
+    for (size_t i = 0; i < model.states.size (); i++) commit_next_state (i);
+    return;
+  }
+  /* interleaved states per thread, without messages */
+  pool->run ([this, pool] (uint32_t t) {
+    for (size_t i = t; i < model.states.size (); i += pool->size ())
+    {
+      Btor2Line *state = model.states[i];
+      if (model.nexts[state->id] && !model.tape.in_coi (state->id)) continue;
+      BtorSimState &update = next_state[state->id];
+      assert (update.is_set ());
+      current_state[state->id].update (update);
+      update.release ();
+    }
+  });
+}
+
+void
+BtorSim::simulate (int64_t k, bool randomize)
+{
+  if (!k)
+    for (size_t i = 0; i < model.states.size (); i++)
+      initialize_state (i, randomize);
+  for (size_t i = 0; i < model.inputs.size (); i++)
+    initialize_input (i, randomize);
+  execute ();
+  update_next_states (randomize);
+  check_properties (k);
+}
+
+void
+BtorSim::transition ()
+{
+  delete_inputs ();
+  commit_next_states ();
+}
+
+void
+BtorSim::reset ()
+{
+  for (auto state : model.states)
+  {
+    delete_current_state (state->id);
+    if (next_state[state->id].is_set ()) next_state[state->id].remove ();
+  }
+  delete_inputs ();
+  reached_bads.assign (model.bads.size (), -1);
+  num_unreached_bads   = model.num_simulated_bads;
+  constraints_violated = -1;
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSim::Snapshot::~Snapshot ()
+{
+  for (BtorSimState &s : inputs)
+    if (s.type) s.remove ();
+  for (BtorSimState &s : states)
+    if (s.type) s.remove ();
+  for (BtorSimState &s : next_states)
+    if (s.type) s.remove ();
+}
+
+/* Only inputs, states and next states are stored, all other slots are
+ * functions of them and are computed again by the next execution of the
+ * tape.  Arrays are shared with the simulator instead of copied. */
+static void
+save_values (const std::vector<BtorSimState> &values,
+             const std::vector<int64_t> &indices,
+             std::vector<BtorSimState> &snapshot)
+{
+  for (BtorSimState &s : snapshot)
+    if (s.type) s.remove ();
+  snapshot.resize (indices.size ());
+  for (size_t i = 0; i < indices.size (); i++)
+    snapshot[i] = values[indices[i]].share ();
+}
+
+static void
+restore_values (const std::vector<BtorSimState> &snapshot,
+                const std::vector<int64_t> &indices,
+                std::vector<BtorSimState> &values)
+{
+  assert (snapshot.size () == indices.size ());
+  for (size_t i = 0; i < indices.size (); i++)
+  {
+    BtorSimState &s = values[indices[i]];
+    if (s.type) s.remove ();
+    s = snapshot[i].share ();
+  }
+}
+
+void
+BtorSim::save (Snapshot &snapshot) const
+{
+  std::vector<int64_t> input_slots, state_slots, state_ids;
+  leaf_indices (input_slots, state_slots, state_ids);
+  save_values (current_state, input_slots, snapshot.inputs);
+  save_values (current_state, state_slots, snapshot.states);
+  save_values (next_state, state_ids, snapshot.next_states);
+  snapshot.rng                  = rng;
+  snapshot.reached_bads         = reached_bads;
+  snapshot.constraints_violated = constraints_violated;
+  snapshot.num_unreached_bads   = num_unreached_bads;
+}
+
+void
+BtorSim::restore (const Snapshot &snapshot)
+{
+  std::vector<int64_t> input_slots, state_slots, state_ids;
+  leaf_indices (input_slots, state_slots, state_ids);
+  restore_values (snapshot.inputs, input_slots, current_state);
+  restore_values (snapshot.states, state_slots, current_state);
+  restore_values (snapshot.next_states, state_ids, next_state);
+  rng                  = snapshot.rng;
+  reached_bads         = snapshot.reached_bads;
+  constraints_violated = snapshot.constraints_violated;
+  num_unreached_bads   = snapshot.num_unreached_bads;
+}
+
+void
+BtorSim::leaf_indices (std::vector<int64_t> &input_slots,
+                       std::vector<int64_t> &state_slots,
+                       std::vector<int64_t> &state_ids) const
+{
+  for (Btor2Line *input : model.inputs)
+    input_slots.push_back (model.tape.slot (input->id));
+  for (Btor2Line *state : model.states)
+  {
+    state_slots.push_back (model.tape.slot (state->id));
+    state_ids.push_back (state->id);
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+void
+BtorSimSession::advance ()
+{
+  if (!simulated) return;
+  sim.transition ();
+  step++;
+  simulated = false;
+}
+
+void
+BtorSimSession::set (int64_t id, BtorSimBitVector *val)
+{
+  advance ();
+  sim.update_current_state (id, val);
+}
+
+int64_t
+BtorSimSession::simulate_step ()
+{
+  advance ();
+  sim.simulate (step, randomize);
+  simulated = true;
+  return step;
+}
+
+void
+BtorSimSession::reset ()
+{
+  sim.reset ();
+  step      = 0;
+  simulated = false;
+}
+
+void
+BtorSimSession::save (Snapshot &snapshot) const
+{
+  snapshot.step      = step;
+  snapshot.simulated = simulated;
+  sim.save (snapshot.state);
+}
+
+void
+BtorSimSession::restore (const Snapshot &snapshot)
+{
+  sim.restore (snapshot.state);
+  step      = snapshot.step;
+  simulated = snapshot.simulated;
+  /* snapshots only store inputs and states */
+  if (simulated) sim.execute ();
+}
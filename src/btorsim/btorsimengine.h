@@ -0,0 +1,215 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#ifndef BTOR2ENGINE_H_INCLUDED
+#define BTOR2ENGINE_H_INCLUDED
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "btor2parser/btor2parser.h"
+#include "btorsimrng.h"
+#include "btorsimstate.h"
+#include "btorsimtape.h"
+#include "btorsimthreads.h"
+
+/* A parsed model with its inputs, states and properties, compiled into a
+ * tape.  Several simulators ('BtorSim') can simulate the same model at once,
+ * as long as none of them uses the event-driven, lazy, native or parallel
+ * execution of the tape, which keep bookkeeping in the tape. */
+struct BtorSimModel
+{
+  BtorSimModel () = default;
+  ~BtorSimModel ();
+
+  /* avoid accidental copies */
+  BtorSimModel (const BtorSimModel &) = delete;
+  BtorSimModel &operator= (const BtorSimModel &) = delete;
+
+  /* Parse the model in 'file' ('path' is only used in messages) and compile
+   * it.  Returns false and sets 'error' if the model can not be parsed or
+   * uses unsupported operators. */
+  bool parse (FILE *file, const char *path);
+
+  /* restrict simulation to the cone of influence of the lines 'roots' (see
+   * 'BtorSimTape::prune'), states outside of it are not updated anymore */
+  void prune (const std::vector<int64_t> &roots);
+
+  /* Return the bit-vector value of line 'l' given as string of '0' and '1'
+   * (most significant bit first), or 'nullptr' and set 'error' if 'bits' is
+   * not a value of its sort. */
+  BtorSimBitVector *parse_bits (const Btor2Line *l,
+                                const char *bits,
+                                std::string &error) const;
+
+  Btor2Parser *parser      = nullptr;
+  int64_t num_format_lines = 0;
+
+  std::vector<Btor2Line *> inputs;
+  std::vector<Btor2Line *> states;
+  std::vector<Btor2Line *> bads;
+  std::vector<Btor2Line *> constraints;
+  std::vector<Btor2Line *> justices;
+  /* init and next lines indexed by state id */
+  std::vector<Btor2Line *> inits;
+  std::vector<Btor2Line *> nexts;
+
+  /* bad state properties in the cone of influence */
+  int64_t num_simulated_bads = 0;
+
+  BtorSimTape tape;
+  std::string error;
+
+ private:
+  bool parse_line (Btor2Line *l, const char *path);
+};
+
+/* The state of one simulation of a model: the values of all slots of its
+ * tape, the next states, the random number generator and the properties
+ * checked so far.  Simulators do not share any mutable state, except for
+ * the tape of their model (see 'BtorSimModel'). */
+class BtorSim
+{
+ public:
+  /* set up the slots of 'model' and compute its constants */
+  explicit BtorSim (BtorSimModel &model);
+  ~BtorSim ();
+
+  /* avoid accidental copies, see 'save' and 'restore' instead */
+  BtorSim (const BtorSim &) = delete;
+  BtorSim &operator= (const BtorSim &) = delete;
+
+  BtorSimModel &model;
+
+  /* values indexed by slot (see 'BtorSimTape::slot') and next states
+   * indexed by id */
+  std::vector<BtorSimState> current_state;
+  std::vector<BtorSimState> next_state;
+
+  BtorSimRNG rng;
+
+  /* step at which bad state property 'i' was reached first (-1 if not), and
+   * at which constraints were violated first (-1 if not) */
+  std::vector<int64_t> reached_bads;
+  int64_t constraints_violated = -1;
+  int64_t num_unreached_bads   = 0;
+
+  /* set the value of input or state 'id' (takes ownership of the value) */
+  void update_current_state (int64_t id, BtorSimBitVector *bv);
+  void update_current_state (int64_t id, BtorSimArrayModel *am);
+  void update_current_state (int64_t id, BtorSimState &s);
+  void delete_current_state (int64_t id);
+
+  /* Return a copy of the value of 'id' (or of its negation if 'id' is
+   * negative), which has to be computed by the tape already. */
+  BtorSimState get_value (int64_t id) const;
+
+  /* Set input 'pos' (in the order of declaration) to a random or zero value
+   * unless it is set already. */
+  void initialize_input (size_t pos, bool randomize);
+  /* Set state 'pos' (in the order of declaration) to the value of its init,
+   * or to a random or zero value without init, unless it is set already. */
+  void initialize_state (size_t pos, bool randomly);
+
+  /* compute all nodes of the current step */
+  void execute () { model.tape.execute (current_state); }
+  /* compute the next states after executing the tape, states without next
+   * function become random or zero */
+  void update_next_states (bool randomize_states_that_are_inputs);
+  /* record constraints violated and bad state properties reached at step
+   * 'k' after executing the tape */
+  void check_properties (int64_t k);
+  /* forget the values of all inputs */
+  void delete_inputs ();
+  /* Simulate step 'k' after inputs and, at step 0, states were set as
+   * needed: initialize all others, execute the tape, compute the next states
+   * and check properties. */
+  void simulate (int64_t k, bool randomize);
+  /* start the next step, i.e., forget the inputs and commit all states */
+  void transition ();
+  /* make the next state of state 'pos' its current state */
+  void commit_next_state (size_t pos);
+  /* the same for all states, with the threads of 'pool' if not 'nullptr' */
+  void commit_next_states (BtorSimThreadPool *pool = nullptr);
+
+  /* forget the trace simulated so far, such that a new one can be started */
+  void reset ();
+
+  /* A copy of the simulation state, i.e., of the values of all inputs and
+   * states, the next states, the random number generator and the checked
+   * properties, which can be restored on any simulator of the same model in
+   * the same thread.  Values of other nodes are computed again by the next
+   * execution of the tape ('execute').  Arrays are shared copy-on-write with
+   * the simulator, which makes snapshots of models with large arrays cheap. */
+  struct Snapshot
+  {
+    Snapshot () = default;
+    ~Snapshot ();
+    Snapshot (const Snapshot &) = delete;
+    Snapshot &operator= (const Snapshot &) = delete;
+
+    /* in the order of declaration */
+    std::vector<BtorSimState> inputs;
+    std::vector<BtorSimState> states;
+    std::vector<BtorSimState> next_states;
+    BtorSimRNG rng;
+    std::vector<int64_t> reached_bads;
+    int64_t constraints_violated;
+    int64_t num_unreached_bads;
+  };
+  void save (Snapshot &snapshot) const;
+  void restore (const Snapshot &snapshot);
+
+ private:
+  void leaf_indices (std::vector<int64_t> &input_slots,
+                     std::vector<int64_t> &state_slots,
+                     std::vector<int64_t> &state_ids) const;
+};
+
+/* A trace simulated step by step, as by the step-level library
+ * ('btorsimlib.h') and the simulation server ('btorsimserver.h').  Inputs
+ * and states set before a step are used by it, all others are initialized
+ * as in 'BtorSim::simulate'.  Values are those of the last simulated step
+ * until inputs or states of the next one are set or it is simulated. */
+struct BtorSimSession
+{
+  explicit BtorSimSession (BtorSimModel &model) : sim (model) {}
+
+  BtorSim sim;
+  bool randomize = false;
+  /* the next step to be simulated, or the last one if 'simulated' */
+  int64_t step   = 0;
+  bool simulated = false;
+
+  /* set input or state 'id' of the next step (takes ownership of 'val') */
+  void set (int64_t id, BtorSimBitVector *val);
+  /* simulate the next step and return its number */
+  int64_t simulate_step ();
+  /* forget the trace simulated so far and start again at step 0 */
+  void reset ();
+
+  /* the simulation state of 'sim' together with the step */
+  struct Snapshot
+  {
+    int64_t step;
+    bool simulated;
+    BtorSim::Snapshot state;
+  };
+  void save (Snapshot &snapshot) const;
+  void restore (const Snapshot &snapshot);
+
+ private:
+  /* start the next step, in which inputs are unset and states hold the
+   * values of their next functions */
+  void advance ();
+};
+
+#endif
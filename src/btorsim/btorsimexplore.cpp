@@ -0,0 +1,204 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#include "btorsimexplore.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cinttypes>
+
+#include "btorsimhelpers.h"
+
+/*------------------------------------------------------------------------*/
+
+static uint64_t
+mix (uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdull;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ull;
+  h ^= h >> 33;
+  return h;
+}
+
+BtorSimExplorer::BtorSimExplorer (BtorSimModel &model, const Options &options)
+    : model (model), options (options), sim (new BtorSim (model))
+{
+  assert (options.depth >= 0), assert (options.segment > 0);
+  assert (options.archive_size > 0), assert (options.candidates > 0);
+  btorsim_rng64_init (&rng, options.seed);
+}
+
+BtorSimExplorer::~BtorSimExplorer () {}
+
+uint64_t
+BtorSimExplorer::hash () const
+{
+  uint64_t res = 0;
+  for (auto state : model.states)
+  {
+    const BtorSimState &s = sim->current_state[state->id];
+    if (s.type != BtorSimState::Type::BITVEC) continue;
+    uint64_t h = s.is_word () ? s.bv_word : btorsim_bv_hash (s.bv_state);
+    res        = mix (res ^ h);
+  }
+  return res;
+}
+
+/* Archive the current state of the simulator (reached after 'offset' steps
+ * of 'segment' at 'depth') if it was not seen before. */
+void
+BtorSimExplorer::add (int64_t segment, int64_t offset, int64_t depth)
+{
+  uint64_t h = hash ();
+  if (!seen.insert (h).second) return;
+  if (archive.size () == options.archive_size) evict ();
+  Cell cell;
+  cell.hash    = h;
+  cell.segment = segment;
+  cell.offset  = offset;
+  cell.depth   = depth;
+  cell.visits  = 0;
+  cell.snapshot.reset (new BtorSim::Snapshot);
+  sim->save (*cell.snapshot);
+  index[h] = archive.size ();
+  archive.push_back (std::move (cell));
+}
+
+/* the least visited of some random cells, the deepest one on ties */
+size_t
+BtorSimExplorer::select ()
+{
+  size_t res = btorsim_rng64_rand (&rng) % archive.size ();
+  for (uint32_t i = 1; i < options.candidates; i++)
+  {
+    size_t c = btorsim_rng64_rand (&rng) % archive.size ();
+    if (archive[c].visits < archive[res].visits
+        || (archive[c].visits == archive[res].visits
+            && archive[c].depth > archive[res].depth))
+      res = c;
+  }
+  return res;
+}
+
+/* remove the most visited of some random cells */
+void
+BtorSimExplorer::evict ()
+{
+  size_t res = btorsim_rng64_rand (&rng) % archive.size ();
+  for (uint32_t i = 1; i < options.candidates; i++)
+  {
+    size_t c = btorsim_rng64_rand (&rng) % archive.size ();
+    if (archive[c].visits > archive[res].visits) res = c;
+  }
+  index.erase (archive[res].hash);
+  if (res + 1 < archive.size ())
+  {
+    archive[res]             = std::move (archive.back ());
+    index[archive[res].hash] = res;
+  }
+  archive.pop_back ();
+}
+
+/* the parts of the witness ending after 'steps' steps of 'segment' */
+void
+BtorSimExplorer::make_witness (int64_t segment, int64_t steps)
+{
+  witness.clear ();
+  for (int64_t s = segment; s >= 0; s = segments[s].parent)
+  {
+    witness.push_back ({segments[s].seed, steps});
+    steps = segments[s].offset;
+  }
+  std::reverse (witness.begin (), witness.end ());
+}
+
+bool
+BtorSimExplorer::explore ()
+{
+  using clock = std::chrono::steady_clock;
+  const BtorSimTape &tape = model.tape;
+  BtorSim &s              = *sim;
+  auto start              = clock::now ();
+  double reported         = 0;
+
+  segments.push_back ({-1, 0, options.seed});
+  s.reset ();
+  btorsim_rng_init (&s.rng, options.seed);
+  for (size_t j = 0; j < model.states.size (); j++)
+    s.initialize_state (j, true);
+  add (0, 0, 0);
+
+  for (num_iterations = 0; num_iterations < options.iterations;
+       num_iterations++)
+  {
+    if (!(num_iterations % 256))
+    {
+      double seconds =
+          std::chrono::duration<double> (clock::now () - start).count ();
+      if (seconds >= reported + 1)
+      {
+        reported = seconds;
+        msg (1,
+             "explored %" PRIu64 " times in %.1f seconds: %zu distinct "
+             "states (%.0f per second), %zu archived",
+             num_iterations,
+             seconds,
+             seen.size (),
+             seen.size () / seconds,
+             archive.size ());
+      }
+    }
+
+    Cell &cell = archive[select ()];
+    cell.visits++;
+    int64_t segment = segments.size (), depth = cell.depth;
+    uint32_t seed   = btorsim_rng64_rand (&rng);
+    segments.push_back ({cell.segment, cell.offset, seed});
+    s.restore (*cell.snapshot);
+    btorsim_rng_init (&s.rng, seed);
+
+    /* 'cell' may be evicted from now on */
+    for (int64_t i = 1; i <= options.segment && depth <= options.depth; i++)
+    {
+      for (size_t j = 0; j < model.inputs.size (); j++)
+        s.initialize_input (j, true);
+      s.execute ();
+      s.update_next_states (true);
+      num_steps++;
+
+      bool violated = false;
+      for (auto constraint : model.constraints)
+        if (s.current_state[tape.slot (constraint->args[0])].is_zero ())
+          violated = true;
+      if (violated) break;
+
+      for (size_t j = 0; j < model.bads.size (); j++)
+      {
+        Btor2Line *bad = model.bads[j];
+        if (!tape.in_coi (bad->id)) continue;
+        if (s.current_state[tape.slot (bad->args[0])].is_zero ()) continue;
+        reached_bads.push_back (j);
+      }
+      if (!reached_bads.empty ())
+      {
+        reached_at = depth;
+        make_witness (segment, i);
+        num_iterations++;
+        return true;
+      }
+
+      s.transition ();
+      if (++depth <= options.depth) add (segment, i, depth);
+    }
+  }
+  return false;
+}
@@ -0,0 +1,112 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#ifndef BTOR2EXPLORE_H_INCLUDED
+#define BTOR2EXPLORE_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "btorsimengine.h"
+
+/* Random exploration from an archive of states ('btorsim --explore') in the
+ * style of Go-Explore.
+ *
+ * States are identified by a hash of the values of all bit-vector states
+ * (arrays are not distinguished).  Every state reached for the first time
+ * is put into the archive with a snapshot of the simulation (see
+ * 'BtorSim::save').  Each iteration selects a rarely visited archived state
+ * (the least visited one of 'candidates' random ones, preferring deeper ones
+ * on ties), restores it and continues random simulation from there for up
+ * to 'segment' steps with a new random seed, as long as constraints hold
+ * and the bound 'depth' is not exceeded.  If the archive is full, the most
+ * visited of 'candidates' random states is evicted (and never archived
+ * again).
+ *
+ * The segments simulated form a tree, which is kept for witnesses: every
+ * segment starts in a state reached by its parent segment after some steps,
+ * and all segments are simulated with their own seed.  The root segment only
+ * initializes the states with seed 'seed'. */
+class BtorSimExplorer
+{
+ public:
+  struct Options
+  {
+    int64_t depth       = 20;
+    uint64_t iterations = 100000;
+    int64_t segment     = 100;
+    size_t archive_size = 10000;
+    uint32_t candidates = 8;
+    uint32_t seed       = 0;
+  };
+
+  BtorSimExplorer (BtorSimModel &model, const Options &options);
+  ~BtorSimExplorer ();
+
+  /* explore until a bad state property is reached, returns whether one was */
+  bool explore ();
+
+  /* The bad state properties reached (at the same step) by the first
+   * segment reaching any, and that step.  Its witness is simulated by
+   * initializing states with the seed of the first element of 'witness', and
+   * then simulating the number of steps of each following element with
+   * random inputs, after seeding with its seed. */
+  std::vector<int64_t> reached_bads;
+  int64_t reached_at = -1;
+  struct Part
+  {
+    uint32_t seed;
+    int64_t steps;
+  };
+  std::vector<Part> witness;
+
+  /* the number of iterations, simulated steps and distinct states so far */
+  uint64_t num_iterations = 0;
+  uint64_t num_steps      = 0;
+  size_t num_unique () const { return seen.size (); }
+  size_t archived () const { return archive.size (); }
+
+ private:
+  struct Segment
+  {
+    int64_t parent; /* -1 for the root */
+    int64_t offset; /* steps of the parent before this segment */
+    uint32_t seed;
+  };
+  struct Cell
+  {
+    uint64_t hash;
+    int64_t segment, offset, depth;
+    uint64_t visits;
+    std::unique_ptr<BtorSim::Snapshot> snapshot;
+  };
+
+  BtorSimModel &model;
+  Options options;
+  std::unique_ptr<BtorSim> sim;
+  BtorSimRNG64 rng;
+
+  std::vector<Segment> segments;
+  std::vector<Cell> archive;
+  /* archived cells by hash, and the hashes of all states seen */
+  std::unordered_map<uint64_t, size_t> index;
+  std::unordered_set<uint64_t> seen;
+
+  uint64_t hash () const;
+  void add (int64_t segment, int64_t offset, int64_t depth);
+  size_t select ();
+  void evict ();
+  void make_witness (int64_t segment, int64_t steps);
+};
+
+#endif
@@ -0,0 +1,464 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#include "btorsimfuzz.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cinttypes>
+
+#include "btorsimhelpers.h"
+
+/*------------------------------------------------------------------------*/
+
+/* Values of 'width' bits are stored in 'words (width)' words, least
+ * significant word first, with all bits beyond 'width' 0. */
+static uint32_t
+words (uint32_t width)
+{
+  return (width + 63) / 64;
+}
+
+static void
+mask (uint64_t *w, uint32_t width)
+{
+  if (width % 64) w[words (width) - 1] &= ((uint64_t) 1 << (width % 64)) - 1;
+}
+
+/* the lower 'width' bits of 'bv' (zero-extended if it has less bits) */
+static void
+bv_to_words (const BtorSimBitVector *bv, uint32_t width, uint64_t *w)
+{
+  std::fill (w, w + words (width), 0);
+  for (uint32_t i = 0; i < width && i < bv->width; i++)
+    if (btorsim_bv_get_bit (bv, i)) w[i / 64] |= (uint64_t) 1 << (i % 64);
+}
+
+static BtorSimBitVector *
+words_to_bv (const uint64_t *w, uint32_t width)
+{
+  if (width <= 64) return btorsim_bv_uint64_to_bv (w[0], width);
+  BtorSimBitVector *res = btorsim_bv_new (width);
+  for (uint32_t i = 0; i < width; i++)
+    if (w[i / 64] >> (i % 64) & 1) btorsim_bv_set_bit (res, i, 1);
+  return res;
+}
+
+/* add 1 or subtract 1 (if 'dec') modulo 2^'width' */
+static void
+increment (uint64_t *w, uint32_t width, bool dec)
+{
+  for (uint32_t i = 0; i < words (width); i++)
+    if (dec ? w[i]-- : ++w[i]) break;
+  mask (w, width);
+}
+
+/* AFL's buckets of hit counts */
+static uint8_t
+classify (uint8_t hits)
+{
+  if (hits <= 2) return hits;
+  if (hits == 3) return 4;
+  if (hits < 8) return 8;
+  if (hits < 16) return 16;
+  if (hits < 32) return 32;
+  if (hits < 128) return 64;
+  return 128;
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSimFuzzer::BtorSimFuzzer (BtorSimModel &model, const Options &options)
+    : model (model), options (options), sim (new BtorSim (model))
+{
+  assert (options.depth >= 0), assert (options.energy > 0);
+  btorsim_rng64_init (&rng, options.seed);
+
+  for (auto state : model.states)
+  {
+    if (model.inits[state->id]) continue;
+    if (state->sort.tag != BTOR2_TAG_SORT_bitvec) continue;
+    states.push_back (state);
+    state_offset.push_back (state_words);
+    state_words += words (state->sort.bitvec.width);
+  }
+  for (auto input : model.inputs)
+  {
+    if (input->sort.tag != BTOR2_TAG_SORT_bitvec) continue;
+    inputs.push_back (input);
+    input_offset.push_back (input_words);
+    input_words += words (input->sort.bitvec.width);
+  }
+
+  std::vector<BtorSimBitVector *> constants;
+  for (int64_t id = 1; id < model.num_format_lines; id++)
+  {
+    Btor2Line *l = btor2parser_get_line_by_id (model.parser, id);
+    if (!l) continue;
+    uint32_t width = l->sort.bitvec.width;
+    if (l->tag == BTOR2_TAG_const)
+      constants.push_back (btorsim_bv_const (l->constant, width));
+    else if (l->tag == BTOR2_TAG_constd)
+      constants.push_back (btorsim_bv_constd (l->constant, width));
+    else if (l->tag == BTOR2_TAG_consth)
+      constants.push_back (btorsim_bv_consth (l->constant, width));
+  }
+  for (auto lines : {&states, &inputs})
+    for (auto l : *lines) add_dictionary (l->sort.bitvec.width, constants);
+  for (auto bv : constants) btorsim_bv_free (bv);
+
+  const BtorSimTape &tape = model.tape;
+  for (int64_t id = 1; id < model.num_format_lines; id++)
+  {
+    Btor2Line *l = btor2parser_get_line_by_id (model.parser, id);
+    if (!l || !tape.in_coi (id)) continue;
+    switch (l->tag)
+    {
+      case BTOR2_TAG_bad:
+      case BTOR2_TAG_const:
+      case BTOR2_TAG_constd:
+      case BTOR2_TAG_consth:
+      case BTOR2_TAG_constraint:
+      case BTOR2_TAG_fair:
+      case BTOR2_TAG_init:
+      case BTOR2_TAG_input:
+      case BTOR2_TAG_justice:
+      case BTOR2_TAG_next:
+      case BTOR2_TAG_one:
+      case BTOR2_TAG_ones:
+      case BTOR2_TAG_output:
+      case BTOR2_TAG_sort:
+      case BTOR2_TAG_zero: continue;
+      default: break;
+    }
+    if (l->tag == BTOR2_TAG_ite)
+    {
+      ite_slots.push_back (tape.slot (l->args[0]));
+      ite_point.push_back (num_points);
+      num_points += 2;
+    }
+    if (l->sort.tag == BTOR2_TAG_SORT_bitvec && l->sort.bitvec.width == 1)
+    {
+      toggle_slots.push_back (tape.slot (id));
+      toggle_point.push_back (num_points);
+      num_points += 2;
+    }
+  }
+  for (auto state : model.states)
+  {
+    if (state->sort.tag != BTOR2_TAG_SORT_bitvec) continue;
+    if (!tape.in_coi (state->id)) continue;
+    uint32_t width = state->sort.bitvec.width;
+    bucket_states.push_back (state->id);
+    bucket_point.push_back (num_points);
+    num_points += width <= 4 ? (size_t) 1 << width : width + 1;
+  }
+  hits.assign (num_points, 0);
+  virgin.assign (num_points, 0);
+  previous.assign (toggle_slots.size (), 0);
+}
+
+BtorSimFuzzer::~BtorSimFuzzer () {}
+
+/* Add the lower 'width' bits of 'constants' and their neighbors (plus and
+ * minus 1) to the dictionary of 'width', without duplicates. */
+void
+BtorSimFuzzer::add_dictionary (uint32_t width,
+                               const std::vector<BtorSimBitVector *> &constants)
+{
+  if (dictionary.size () <= width) dictionary.resize (width + 1);
+  if (!dictionary[width].empty ()) return;
+  std::vector<std::vector<uint64_t>> values;
+  std::vector<uint64_t> w (words (width));
+  for (auto bv : constants)
+  {
+    bv_to_words (bv, width, w.data ());
+    values.push_back (w);
+    increment (w.data (), width, false);
+    values.push_back (w);
+    increment (w.data (), width, true);
+    increment (w.data (), width, true);
+    values.push_back (w);
+  }
+  std::sort (values.begin (), values.end ());
+  values.erase (std::unique (values.begin (), values.end ()), values.end ());
+  for (auto &v : values)
+    dictionary[width].insert (dictionary[width].end (), v.begin (), v.end ());
+}
+
+void
+BtorSimFuzzer::set_value (BtorSim &sim,
+                          const Btor2Line *l,
+                          const uint64_t *w) const
+{
+  uint32_t width = l->sort.bitvec.width;
+  if (width <= 64)
+    sim.current_state[l->id].update_word (w[0]);
+  else
+    sim.update_current_state (l->id, words_to_bv (w, width));
+}
+
+void
+BtorSimFuzzer::random_value (const Btor2Line *l, uint64_t *w)
+{
+  uint32_t width = l->sort.bitvec.width;
+  for (uint32_t i = 0; i < words (width); i++)
+    w[i] = btorsim_rng64_rand (&rng);
+  mask (w, width);
+}
+
+void
+BtorSimFuzzer::load_states (BtorSim &sim) const
+{
+  assert (reached_at >= 0);
+  for (size_t j = 0; j < states.size (); j++)
+    set_value (sim, states[j], &witness.values[state_offset[j]]);
+}
+
+void
+BtorSimFuzzer::load_inputs (BtorSim &sim, int64_t step) const
+{
+  assert (0 <= step), assert (step <= reached_at);
+  const uint64_t *values =
+      &witness.values[state_words + step * (size_t) input_words];
+  for (size_t j = 0; j < inputs.size (); j++)
+    set_value (sim, inputs[j], values + input_offset[j]);
+}
+
+/*------------------------------------------------------------------------*/
+
+/* Count the coverage points hit by the current step. */
+void
+BtorSimFuzzer::cover (bool first)
+{
+  const std::vector<BtorSimState> &values = sim->current_state;
+  auto hit = [this] (size_t p) {
+    if (hits[p] < UINT8_MAX) hits[p]++;
+  };
+  for (size_t i = 0; i < toggle_slots.size (); i++)
+  {
+    uint8_t v = values[toggle_slots[i]].bv_word;
+    if (!first && v != previous[i]) hit (toggle_point[i] + !v);
+    previous[i] = v;
+  }
+  for (size_t i = 0; i < ite_slots.size (); i++)
+    hit (ite_point[i] + !values[ite_slots[i]].bv_word);
+  for (size_t i = 0; i < bucket_states.size (); i++)
+  {
+    const BtorSimState &v = values[bucket_states[i]];
+    uint32_t width        = v.width;
+    size_t bucket;
+    if (width <= 4)
+      bucket = v.bv_word;
+    else if (v.is_word ())
+      bucket = v.bv_word ? 64 - __builtin_clzll (v.bv_word) : 0;
+    else
+      bucket = width - btorsim_bv_get_num_leading_zeros (v.bv_state);
+    hit (bucket_point[i] + bucket);
+  }
+}
+
+/* Merge the hit counts of the last run into the buckets seen so far and
+ * clear them, returns whether a point was hit in a new bucket. */
+bool
+BtorSimFuzzer::add_coverage ()
+{
+  bool res = false;
+  for (size_t p = 0; p < num_points; p++)
+  {
+    if (!hits[p]) continue;
+    uint8_t bucket = classify (hits[p]);
+    hits[p]        = 0;
+    if (virgin[p] & bucket) continue;
+    if (!virgin[p]) num_covered++;
+    virgin[p] |= bucket;
+    res = true;
+  }
+  return res;
+}
+
+/* Simulate 'entry' and set its length, returns whether it reached a bad
+ * state property. */
+bool
+BtorSimFuzzer::run (Entry &entry)
+{
+  const BtorSimTape &tape = model.tape;
+  BtorSim &s              = *sim;
+  s.reset ();
+  btorsim_rng_init (&s.rng, options.seed);
+  num_runs++;
+
+  const uint64_t *values = entry.values.data ();
+  for (size_t j = 0; j < states.size (); j++)
+    set_value (s, states[j], values + state_offset[j]);
+  for (size_t j = 0; j < model.states.size (); j++)
+    s.initialize_state (j, true);
+
+  std::vector<int64_t> reached;
+  for (int64_t k = 0; k <= options.depth; k++)
+  {
+    if (k) s.transition ();
+    const uint64_t *step = values + state_words + k * (size_t) input_words;
+    for (size_t j = 0; j < inputs.size (); j++)
+      set_value (s, inputs[j], step + input_offset[j]);
+    for (size_t j = 0; j < model.inputs.size (); j++)
+      s.initialize_input (j, true);
+    s.execute ();
+    s.update_next_states (true);
+    num_steps++;
+    entry.length = k + 1;
+    cover (!k);
+
+    bool violated = false;
+    for (auto constraint : model.constraints)
+      if (s.current_state[tape.slot (constraint->args[0])].is_zero ())
+        violated = true;
+    if (violated) break;
+
+    for (size_t j = 0; j < model.bads.size (); j++)
+    {
+      Btor2Line *bad = model.bads[j];
+      if (!tape.in_coi (bad->id)) continue;
+      if (s.current_state[tape.slot (bad->args[0])].is_zero ()) continue;
+      reached.push_back (j);
+    }
+    if (reached.empty ()) continue;
+    reached_bads = reached;
+    reached_at   = k;
+    witness      = entry;
+    return true;
+  }
+  return false;
+}
+
+/* Apply 1 to 8 stacked mutations to values of the states or of the inputs
+ * of the steps simulated by 'entry'. */
+void
+BtorSimFuzzer::mutate (Entry &entry)
+{
+  size_t num_values = states.size () + entry.length * inputs.size ();
+  if (!num_values) return;
+  uint32_t n = 1 + btorsim_rng64_rand (&rng) % 8;
+  for (uint32_t i = 0; i < n; i++)
+  {
+    uint64_t r = btorsim_rng64_rand (&rng);
+    size_t v   = r % num_values, k = 0, j = 0;
+    const Btor2Line *l;
+    uint64_t *w;
+    bool is_input = v >= states.size ();
+    if (!is_input)
+    {
+      l = states[v];
+      w = &entry.values[state_offset[v]];
+    }
+    else
+    {
+      v -= states.size ();
+      k = v / inputs.size (), j = v % inputs.size ();
+      l = inputs[j];
+      w = &entry.values[state_words + k * input_words + input_offset[j]];
+    }
+    uint32_t width                    = l->sort.bitvec.width;
+    const std::vector<uint64_t> &dict = dictionary[width];
+    r                                 = btorsim_rng64_rand (&rng);
+    switch (r % 5)
+    {
+      case 0:
+      {
+        uint32_t b = (r >> 3) % width;
+        w[b / 64] ^= (uint64_t) 1 << (b % 64);
+      }
+      break;
+      case 1: random_value (l, w); break;
+      case 2:
+        if (dict.empty ())
+          random_value (l, w);
+        else
+        {
+          size_t m = words (width), c = (r >> 3) % (dict.size () / m);
+          std::copy (&dict[c * m], &dict[c * m] + m, w);
+        }
+        break;
+      case 3:
+      {
+        /* take the inputs from a random step on from another entry */
+        const Entry &other = corpus[(r >> 3) % corpus.size ()];
+        size_t first = btorsim_rng64_rand (&rng) % (options.depth + 1);
+        size_t begin = state_words + first * input_words;
+        std::copy (other.values.begin () + begin,
+                   other.values.end (),
+                   entry.values.begin () + begin);
+      }
+      break;
+      default:
+        /* repeat the value of an input in up to 64 following steps */
+        if (!is_input) break;
+        for (size_t n = 1 + (r >> 3) % 64; n && k < (size_t) options.depth;
+             n--)
+        {
+          k++;
+          std::copy (
+              w,
+              w + words (width),
+              &entry.values[state_words + k * input_words + input_offset[j]]);
+        }
+        break;
+    }
+  }
+}
+
+bool
+BtorSimFuzzer::fuzz ()
+{
+  msg (1,
+       "fuzzing %zu states and %zu inputs with %zu coverage points",
+       states.size (),
+       inputs.size (),
+       num_points);
+
+  size_t size = state_words + (options.depth + 1) * (size_t) input_words;
+  for (uint32_t i = 0; i < 2; i++)
+  {
+    Entry entry;
+    entry.values.assign (size, 0);
+    if (i)
+    {
+      for (size_t j = 0; j < states.size (); j++)
+        random_value (states[j], &entry.values[state_offset[j]]);
+      for (int64_t k = 0; k <= options.depth; k++)
+        for (size_t j = 0; j < inputs.size (); j++)
+          random_value (inputs[j],
+                        &entry.values[state_words + k * input_words
+                                      + input_offset[j]]);
+    }
+    if (run (entry)) return true;
+    if (add_coverage () || corpus.empty ()) corpus.push_back (entry);
+  }
+  if (states.empty () && inputs.empty ()) return false;
+
+  for (size_t i = 0; num_runs < options.runs; i = (i + 1) % corpus.size ())
+  {
+    for (uint32_t e = 0; e < options.energy && num_runs < options.runs; e++)
+    {
+      Entry entry = corpus[i];
+      mutate (entry);
+      if (run (entry)) return true;
+      if (!add_coverage ()) continue;
+      corpus.push_back (entry);
+      msg (2,
+           "run %" PRIu64 ": %zu of %zu coverage points covered, %zu "
+           "entries in corpus",
+           num_runs,
+           num_covered,
+           num_points,
+           corpus.size ());
+    }
+  }
+  return false;
+}
@@ -0,0 +1,125 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#ifndef BTOR2FUZZ_H_INCLUDED
+#define BTOR2FUZZ_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "btorsimengine.h"
+
+/* Coverage-guided fuzzing of input sequences ('btorsim --fuzz') in the style
+ * of AFL.
+ *
+ * A test case holds the values of all bit-vector inputs at steps 0 to
+ * 'depth' and of all bit-vector states without init, packed into words.  A
+ * run simulates it until a bad state property is reached, a constraint is
+ * violated or 'depth' is simulated, and counts how often coverage points
+ * are hit: a 1-bit node (other than an input) rising or falling, the then or
+ * else branch of an 'ite' taken, and a state taking a value in a bucket (its
+ * value if it has at most 4 bits, otherwise the position of its most
+ * significant 1 bit).  As in AFL, hit counts are classified into buckets of
+ * 1, 2, 3, 4-7, 8-15, 16-31, 32-127 and 128 or more hits, and test cases
+ * hitting a point in a new bucket are added to the corpus.
+ *
+ * Starting from a zero and a random test case, the corpus is cycled through
+ * and every entry is mutated 'energy' times by stacked bit flips, random
+ * values, values from a dictionary (the values of 'const', 'constd' and
+ * 'consth' lines and their neighbors, resized to the width of the mutated
+ * value), splices with other entries and repetitions of the value of an
+ * input in following steps.  Mutations only change values of steps the
+ * entry actually simulated (and the steps following them).
+ *
+ * Arrays and states without next function get random values as in random
+ * simulation, drawn from a random number generator seeded with 'seed' at
+ * the start of every run, which therefore also reproduces them. */
+class BtorSimFuzzer
+{
+ public:
+  struct Options
+  {
+    int64_t depth   = 20;
+    uint64_t runs   = 100000;
+    uint32_t energy = 32;
+    uint32_t seed   = 0;
+  };
+
+  BtorSimFuzzer (BtorSimModel &model, const Options &options);
+  ~BtorSimFuzzer ();
+
+  /* fuzz until a bad state property is reached, returns whether one was */
+  bool fuzz ();
+
+  /* the bad state properties reached (at the same step) by the first run
+   * reaching any, and that step */
+  std::vector<int64_t> reached_bads;
+  int64_t reached_at = -1;
+
+  /* set the fuzzed states or the fuzzed inputs at 'step' of the run that
+   * reached 'reached_bads' on 'sim' (before initializing the others) */
+  void load_states (BtorSim &sim) const;
+  void load_inputs (BtorSim &sim, int64_t step) const;
+
+  /* the number of runs and simulated steps so far, and of the coverage
+   * points and those covered */
+  uint64_t num_runs  = 0;
+  uint64_t num_steps = 0;
+  size_t num_points  = 0;
+  size_t num_covered = 0;
+  size_t corpus_size () const { return corpus.size (); }
+
+ private:
+  struct Entry
+  {
+    std::vector<uint64_t> values;
+    int64_t length; /* number of simulated steps */
+  };
+
+  BtorSimModel &model;
+  Options options;
+  std::unique_ptr<BtorSim> sim;
+  BtorSimRNG64 rng;
+
+  /* fuzzed states and inputs with their word offsets in test cases (inputs
+   * relative to the inputs of a step) */
+  std::vector<Btor2Line *> states, inputs;
+  std::vector<uint32_t> state_offset, input_offset;
+  uint32_t state_words = 0, input_words = 0;
+
+  /* dictionary values by width, 'words (width)' words each */
+  std::vector<std::vector<uint64_t>> dictionary;
+
+  /* coverage points: the 1-bit slots with toggle points 'toggle_point[i]'
+   * (rise) and 'toggle_point[i] + 1' (fall), the conditions of 'ite' lines
+   * with points 'ite_point[i]' (then) and 'ite_point[i] + 1' (else), and
+   * the states with 'bucket_point[i]' as point of their first bucket */
+  std::vector<int64_t> toggle_slots, ite_slots, bucket_states;
+  std::vector<size_t> toggle_point, ite_point, bucket_point;
+
+  /* hit counts of the current run, the previous values of 1-bit slots, and
+   * the buckets of hit counts seen so far by point */
+  std::vector<uint8_t> hits, previous, virgin;
+
+  std::vector<Entry> corpus;
+  Entry witness;
+
+  void add_dictionary (uint32_t width,
+                       const std::vector<BtorSimBitVector *> &constants);
+  void set_value (BtorSim &sim, const Btor2Line *l, const uint64_t *w) const;
+  void random_value (const Btor2Line *l, uint64_t *w);
+  void mutate (Entry &entry);
+  bool run (Entry &entry);
+  void cover (bool first);
+  bool add_coverage ();
+};
+
+#endif
@@ -14,6 +14,8 @@
 
 #include "btorsimhelpers.h"
 
+thread_local int32_t verbosity;
+
 void
 die (const char *m, ...)
 {
@@ -45,12 +47,20 @@ msg (int32_t level, const char *m, ...)
 std::string
 btorsim_bv_to_string (const BtorSimBitVector *bv)
 {
-  std::string sval ("");
-  for (int j = bv->width - 1; j >= 0; j--)
-    sval += std::to_string (btorsim_bv_get_bit (bv, j));
+  std::string sval;
+  btorsim_bv_append_to_string (sval, bv);
   return sval;
 }
 
+void
+btorsim_bv_append_to_string (std::string &s, const BtorSimBitVector *bv)
+{
+  size_t n = s.size ();
+  s.resize (n + bv->width);
+  // overwrites the terminating '\0' of 's' with '\0'
+  btorsim_bv_to_char_buf (bv, &s[n]);
+}
+
 std::string
 btorsim_bv_to_hex_string (const BtorSimBitVector *bv)
 {
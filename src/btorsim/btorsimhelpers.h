@@ -23,7 +23,7 @@
 #include "btor2parser/btor2parser.h"
 #include "btorsimbv.h"
 
-extern int32_t verbosity;
+extern thread_local int32_t verbosity;
 
 void die (const char *m, ...);
 void msg (int32_t level, const char *m, ...);
@@ -35,5 +35,7 @@ Btor2Sort *get_sort (Btor2Line *l, Btor2Parser *model);
 // std::string
 std::string btorsim_bv_to_string (const BtorSimBitVector *bv);
 std::string btorsim_bv_to_hex_string (const BtorSimBitVector *bv);
+// append the binary representation of 'bv' to 's'
+void btorsim_bv_append_to_string (std::string &s, const BtorSimBitVector *bv);
 
 #endif
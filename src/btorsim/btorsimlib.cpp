@@ -0,0 +1,262 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#include "btorsimlib.h"
+
+#include <cassert>
+#include <memory>
+#include <string>
+
+#include "btorsimengine.h"
+
+/*------------------------------------------------------------------------*/
+
+struct BtorSimulator
+{
+  BtorSimModel model;
+  std::unique_ptr<BtorSimSession> session;
+  bool randomize = false;
+  uint32_t seed  = 0;
+  std::string value;
+  std::string error;
+};
+
+struct BtorSimSnapshot
+{
+  const BtorSimulator *owner;
+  BtorSimSession::Snapshot state;
+};
+
+/*------------------------------------------------------------------------*/
+
+static bool
+check_model (BtorSimulator *s)
+{
+  if (s->session) return true;
+  s->error = "no model read";
+  return false;
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSimulator *
+btorsim_new ()
+{
+  return new BtorSimulator;
+}
+
+void
+btorsim_delete (BtorSimulator *s)
+{
+  assert (s);
+  /* the simulator has to be deleted before its model */
+  s->session.reset ();
+  delete s;
+}
+
+int32_t
+btorsim_read_model (BtorSimulator *s, FILE *file, const char *name)
+{
+  assert (s), assert (file), assert (name);
+  if (s->model.parser)
+  {
+    s->error = "model already read";
+    return 0;
+  }
+  if (!s->model.parse (file, name))
+  {
+    s->error = s->model.error;
+    return 0;
+  }
+  s->session.reset (new BtorSimSession (s->model));
+  s->session->randomize = s->randomize;
+  btorsim_rng_init (&s->session->sim.rng, s->seed);
+  return 1;
+}
+
+const char *
+btorsim_error (BtorSimulator *s)
+{
+  assert (s);
+  return s->error.c_str ();
+}
+
+/*------------------------------------------------------------------------*/
+
+static int64_t
+line_id (const std::vector<Btor2Line *> &lines, int64_t pos)
+{
+  if (pos < 0 || pos >= (int64_t) lines.size ()) return -1;
+  return lines[pos]->id;
+}
+
+int64_t
+btorsim_num_inputs (BtorSimulator *s)
+{
+  assert (s);
+  return s->model.inputs.size ();
+}
+
+int64_t
+btorsim_num_states (BtorSimulator *s)
+{
+  assert (s);
+  return s->model.states.size ();
+}
+
+int64_t
+btorsim_num_bads (BtorSimulator *s)
+{
+  assert (s);
+  return s->model.bads.size ();
+}
+
+int64_t
+btorsim_input_id (BtorSimulator *s, int64_t pos)
+{
+  assert (s);
+  return line_id (s->model.inputs, pos);
+}
+
+int64_t
+btorsim_state_id (BtorSimulator *s, int64_t pos)
+{
+  assert (s);
+  return line_id (s->model.states, pos);
+}
+
+int64_t
+btorsim_bad_id (BtorSimulator *s, int64_t pos)
+{
+  assert (s);
+  return line_id (s->model.bads, pos);
+}
+
+/*------------------------------------------------------------------------*/
+
+void
+btorsim_set_seed (BtorSimulator *s, uint32_t seed)
+{
+  assert (s);
+  s->randomize = true;
+  s->seed      = seed;
+  if (!s->session) return;
+  s->session->randomize = true;
+  btorsim_rng_init (&s->session->sim.rng, seed);
+}
+
+int32_t
+btorsim_set_input (BtorSimulator *s, int64_t pos, const char *bits)
+{
+  assert (s), assert (bits);
+  if (!check_model (s)) return 0;
+  if (line_id (s->model.inputs, pos) < 0)
+  {
+    s->error = "invalid input " + std::to_string (pos);
+    return 0;
+  }
+  Btor2Line *input      = s->model.inputs[pos];
+  BtorSimBitVector *val = s->model.parse_bits (input, bits, s->error);
+  if (!val) return 0;
+  s->session->set (input->id, val);
+  return 1;
+}
+
+int32_t
+btorsim_set_state (BtorSimulator *s, int64_t pos, const char *bits)
+{
+  assert (s), assert (bits);
+  if (!check_model (s)) return 0;
+  if (line_id (s->model.states, pos) < 0)
+  {
+    s->error = "invalid state " + std::to_string (pos);
+    return 0;
+  }
+  Btor2Line *state      = s->model.states[pos];
+  BtorSimBitVector *val = s->model.parse_bits (state, bits, s->error);
+  if (!val) return 0;
+  s->session->set (state->id, val);
+  return 1;
+}
+
+int64_t
+btorsim_step (BtorSimulator *s)
+{
+  assert (s);
+  if (!check_model (s)) return -1;
+  return s->session->simulate_step ();
+}
+
+const char *
+btorsim_get_value (BtorSimulator *s, int64_t id)
+{
+  assert (s);
+  if (!s->session || id <= 0 || id >= s->model.num_format_lines)
+    return nullptr;
+  const BtorSimState &v = s->session->sim.current_state[id];
+  if (v.type != BtorSimState::Type::BITVEC || !v.is_set ()) return nullptr;
+  s->value.clear ();
+  v.append_to_string (s->value);
+  return s->value.c_str ();
+}
+
+int64_t
+btorsim_reached_bad (BtorSimulator *s, int64_t pos)
+{
+  assert (s);
+  if (!s->session || line_id (s->model.bads, pos) < 0) return -1;
+  return s->session->sim.reached_bads[pos];
+}
+
+int64_t
+btorsim_constraints_violated (BtorSimulator *s)
+{
+  assert (s);
+  if (!s->session) return -1;
+  return s->session->sim.constraints_violated;
+}
+
+void
+btorsim_reset (BtorSimulator *s)
+{
+  assert (s);
+  if (s->session) s->session->reset ();
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSimSnapshot *
+btorsim_snapshot (BtorSimulator *s)
+{
+  assert (s);
+  if (!check_model (s)) return nullptr;
+  BtorSimSnapshot *res = new BtorSimSnapshot;
+  res->owner           = s;
+  s->session->save (res->state);
+  return res;
+}
+
+int32_t
+btorsim_restore (BtorSimulator *s, const BtorSimSnapshot *snapshot)
+{
+  assert (s), assert (snapshot);
+  if (snapshot->owner != s)
+  {
+    s->error = "snapshot of another simulator";
+    return 0;
+  }
+  s->session->restore (snapshot->state);
+  return 1;
+}
+
+void
+btorsim_delete_snapshot (BtorSimSnapshot *snapshot)
+{
+  delete snapshot;
+}
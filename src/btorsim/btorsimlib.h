@@ -0,0 +1,109 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#ifndef btorsimlib_h_INCLUDED
+#define btorsimlib_h_INCLUDED
+
+/*------------------------------------------------------------------------*/
+/* Step-level interface of the BTOR2 simulator 'btorsim'.  Simulators are */
+/* independent of each other, i.e., several simulators can be used in     */
+/* the same process, also by different threads, as long as every single   */
+/* simulator is only used by one thread at a time.                        */
+/*------------------------------------------------------------------------*/
+
+#include <stdint.h>
+#include <stdio.h>
+
+#if __cplusplus
+extern "C" {
+#endif
+
+/*------------------------------------------------------------------------*/
+
+typedef struct BtorSimulator BtorSimulator;
+typedef struct BtorSimSnapshot BtorSimSnapshot;
+
+/*------------------------------------------------------------------------*/
+/* Constructor and destructor:
+ */
+BtorSimulator *btorsim_new (void);
+void btorsim_delete (BtorSimulator *);
+
+/*------------------------------------------------------------------------*/
+/* Functions returning an 'int32_t' return zero on failure.  In this case
+ * 'btorsim_error' describes the error.  The model is read only once, and
+ * 'name' is only used in error messages.
+ */
+int32_t btorsim_read_model (BtorSimulator *, FILE *, const char *name);
+const char *btorsim_error (BtorSimulator *);
+
+/*------------------------------------------------------------------------*/
+/* Inputs, states and bad state properties are numbered in the order of
+ * their declaration in the model (as in witnesses), and mapped to line ids
+ * by these functions.
+ */
+int64_t btorsim_num_inputs (BtorSimulator *);
+int64_t btorsim_num_states (BtorSimulator *);
+int64_t btorsim_num_bads (BtorSimulator *);
+int64_t btorsim_input_id (BtorSimulator *, int64_t pos);
+int64_t btorsim_state_id (BtorSimulator *, int64_t pos);
+int64_t btorsim_bad_id (BtorSimulator *, int64_t pos);
+
+/*------------------------------------------------------------------------*/
+/* Inputs and states without init that are not set explicitly are zero,
+ * unless a random seed is set, which makes them random as in 'btorsim -s'.
+ * With the same seed and no explicitly set values the simulator simulates
+ * the same trace as 'btorsim -s <seed>'.
+ */
+void btorsim_set_seed (BtorSimulator *, uint32_t seed);
+
+/*------------------------------------------------------------------------*/
+/* Simulation proceeds in steps, starting at step 0.  Values of bit-vector
+ * inputs and states of the next step to be simulated are set as strings of
+ * '0' and '1' (most significant bit first).  Setting states overrides the
+ * values of their init or next functions.  'btorsim_step' simulates the
+ * next step and returns its number.
+ */
+int32_t btorsim_set_input (BtorSimulator *, int64_t pos, const char *bits);
+int32_t btorsim_set_state (BtorSimulator *, int64_t pos, const char *bits);
+int64_t btorsim_step (BtorSimulator *);
+
+/* Return the value of the bit-vector line 'id' in the last simulated step
+ * (for inputs and states set since then their new value), and 0 if it has
+ * no value (e.g. is an array).  The string is valid until the next call.
+ */
+const char *btorsim_get_value (BtorSimulator *, int64_t id);
+
+/* Return the first step at which bad state property 'pos' was reached, or
+ * constraints were violated, and -1 otherwise.  Bad state properties are
+ * not checked anymore after constraints are violated.
+ */
+int64_t btorsim_reached_bad (BtorSimulator *, int64_t pos);
+int64_t btorsim_constraints_violated (BtorSimulator *);
+
+/* Start a new trace at step 0 (the random number generator continues). */
+void btorsim_reset (BtorSimulator *);
+
+/*------------------------------------------------------------------------*/
+/* A snapshot stores the current state of a simulator, including the
+ * random number generator and reached properties, and can be restored on
+ * the same simulator any number of times.  Arrays are shared with the
+ * simulator until they are changed, which keeps snapshots cheap.
+ */
+BtorSimSnapshot *btorsim_snapshot (BtorSimulator *);
+int32_t btorsim_restore (BtorSimulator *, const BtorSimSnapshot *);
+void btorsim_delete_snapshot (BtorSimSnapshot *);
+
+/*------------------------------------------------------------------------*/
+
+#if __cplusplus
+}
+#endif
+
+#endif
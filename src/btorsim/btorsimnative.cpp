@@ -0,0 +1,219 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#include "btorsimnative.h"
+
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "btorsimhelpers.h"
+
+/*------------------------------------------------------------------------*/
+
+/* 64-bit FNV-1a */
+static uint64_t
+hash_string (uint64_t h, const std::string &s)
+{
+  for (unsigned char c : s)
+  {
+    h ^= c;
+    h *= UINT64_C (0x100000001b3);
+  }
+  return h;
+}
+
+static std::string
+shell_quote (const std::string &s)
+{
+  std::string res = "'";
+  for (char c : s)
+    if (c == '\'')
+      res += "'\\''";
+    else
+      res += c;
+  return res + "'";
+}
+
+static bool
+read_file (const std::string &path, std::string &contents)
+{
+  FILE *file = fopen (path.c_str (), "r");
+  if (!file) return false;
+  char buf[4096];
+  size_t n;
+  contents.clear ();
+  while ((n = fread (buf, 1, sizeof buf, file))) contents.append (buf, n);
+  bool ok = !ferror (file);
+  fclose (file);
+  return ok;
+}
+
+/* Create a new file named 'path' followed by a unique part and 'suffix' with
+ * 'mkstemps', which never follows or reuses existing files, write 'contents'
+ * to it and append its name to 'path'. */
+static bool
+write_new_file (std::string &path,
+                const char *suffix,
+                const std::string &contents)
+{
+  std::string name = path + ".XXXXXX" + suffix;
+  int fd           = mkstemps (&name[0], strlen (suffix));
+  if (fd < 0) return false;
+  FILE *file = fdopen (fd, "w");
+  bool ok    = file != nullptr;
+  if (!ok)
+    close (fd);
+  else
+  {
+    ok = fwrite (contents.data (), 1, contents.size (), file)
+         == contents.size ();
+    if (fclose (file)) ok = false;
+  }
+  if (!ok)
+  {
+    unlink (name.c_str ());
+    return false;
+  }
+  path = name;
+  return true;
+}
+
+/* Code is only loaded from directories and files owned by the user and not
+ * writable by anyone else, since otherwise other users could plant code. */
+static bool
+is_private (const std::string &path, bool dir)
+{
+  struct stat st;
+  if (lstat (path.c_str (), &st))
+  {
+    if (dir)
+      msg (1, "can not access '%s': %s", path.c_str (), strerror (errno));
+    return false;
+  }
+  if (dir ? !S_ISDIR (st.st_mode) : !S_ISREG (st.st_mode))
+    msg (1, "'%s' is not a %s", path.c_str (), dir ? "directory" : "file");
+  else if (st.st_uid != getuid ())
+    msg (1, "'%s' is not owned by the user", path.c_str ());
+  else if (st.st_mode & (S_IWGRP | S_IWOTH))
+    msg (1, "'%s' is writable by group or others", path.c_str ());
+  else
+    return true;
+  return false;
+}
+
+static BtorSimNativeStep
+load (const std::string &path)
+{
+  void *handle = dlopen (path.c_str (), RTLD_NOW | RTLD_LOCAL);
+  if (!handle)
+  {
+    msg (1, "failed to load '%s': %s", path.c_str (), dlerror ());
+    return nullptr;
+  }
+  void *sym = dlsym (handle, "btorsim_native_step");
+  if (!sym)
+  {
+    msg (1, "no step function in '%s'", path.c_str ());
+    dlclose (handle);
+    return nullptr;
+  }
+  /* the handle stays open as long as the process runs */
+  return reinterpret_cast<BtorSimNativeStep> (sym);
+}
+
+BtorSimNativeStep
+btorsim_native_load (const std::string &src, const char *dir)
+{
+  const char *cc = getenv ("CC");
+  if (!cc || !*cc) cc = "cc";
+  std::string command = std::string (cc) + " -O2 -fPIC -shared";
+
+  uint64_t h = UINT64_C (0xcbf29ce484222325);
+  h          = hash_string (h, command);
+  h          = hash_string (h, src);
+  char name[32];
+  snprintf (name, sizeof name, "btorsim-%016" PRIx64, h);
+  std::string base = std::string (dir) + "/" + name;
+
+  if (mkdir (dir, 0700) && errno != EEXIST)
+  {
+    msg (1, "can not create directory '%s': %s", dir, strerror (errno));
+    return nullptr;
+  }
+  if (!is_private (dir, true))
+  {
+    msg (1, "refusing to use '%s' for compiled models", dir);
+    return nullptr;
+  }
+
+  /* the source is compared to rule out hash collisions, and renamed into
+   * place only after the shared object */
+  std::string cached;
+  if (read_file (base + ".c", cached) && cached == src
+      && is_private (base + ".so", false))
+  {
+    BtorSimNativeStep fn = load (base + ".so");
+    if (fn)
+    {
+      msg (1, "using cached native step function '%s.so'", base.c_str ());
+      return fn;
+    }
+  }
+
+  /* unique temporary names, since other processes may compile the same
+   * model, the shared object is created in advance for the same reason */
+  std::string tmp_c = base, tmp_so = base;
+  if (!write_new_file (tmp_c, ".c", src))
+  {
+    msg (1, "can not write '%s.*.c': %s", base.c_str (), strerror (errno));
+    return nullptr;
+  }
+  if (!write_new_file (tmp_so, ".so", ""))
+  {
+    msg (1, "can not write '%s.*.so': %s", base.c_str (), strerror (errno));
+    unlink (tmp_c.c_str ());
+    return nullptr;
+  }
+
+  msg (1, "compiling native step function '%s.so'", base.c_str ());
+  auto start = std::chrono::steady_clock::now ();
+  std::string cmd = command + " -o " + shell_quote (tmp_so) + " "
+                    + shell_quote (tmp_c);
+  int status = system (cmd.c_str ());
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now () - start;
+  if (status)
+  {
+    msg (1, "failed to compile '%s' with '%s'", tmp_c.c_str (), cmd.c_str ());
+    unlink (tmp_c.c_str ());
+    unlink (tmp_so.c_str ());
+    return nullptr;
+  }
+  msg (1, "compiled native step function in %.2f seconds", elapsed.count ());
+
+  /* the linker may create the shared object anew, subject to 'umask' */
+  if (chmod (tmp_so.c_str (), 0700)
+      || rename (tmp_so.c_str (), (base + ".so").c_str ())
+      || rename (tmp_c.c_str (), (base + ".c").c_str ()))
+  {
+    msg (1, "can not install '%s': %s", tmp_so.c_str (), strerror (errno));
+    unlink (tmp_c.c_str ());
+    unlink (tmp_so.c_str ());
+    return nullptr;
+  }
+  return load (base + ".so");
+}
@@ -0,0 +1,39 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#ifndef BTOR2NATIVE_H_INCLUDED
+#define BTOR2NATIVE_H_INCLUDED
+
+#include <cstdint>
+#include <string>
+
+/* Callback of a native step function that executes instruction 'instr' of
+ * the step program without native code. */
+typedef void (*BtorSimNativeGeneric) (void *ctx, uint32_t instr);
+
+/* Step function of a model compiled to native code (see
+ * 'BtorSimTape::emit_native'), which reads and writes the values of
+ * bit-vectors of at most 64 bits in 'words' (indexed by slot) and calls
+ * 'generic' (with 'ctx') for all other instructions. */
+typedef void (*BtorSimNativeStep) (uint64_t *words,
+                                   BtorSimNativeGeneric generic,
+                                   void *ctx);
+
+/* Compile the C source 'src', which defines 'btorsim_native_step', into a
+ * shared object with the system C compiler (environment variable 'CC',
+ * default 'cc') and load it.  Shared objects are cached in directory 'dir'
+ * under a hash of 'src' and the compiler command, so that simulating the
+ * same model again skips compilation.  The directory is created with mode
+ * 0700 if necessary, and neither it nor cached shared objects are used
+ * unless they are owned by the user and not writable by group or others.
+ * Returns 'nullptr' if compiling or loading fails. */
+BtorSimNativeStep btorsim_native_load (const std::string &src,
+                                       const char *dir);
+
+#endif
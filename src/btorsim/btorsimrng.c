@@ -53,3 +53,113 @@ btorsim_rng_pick_rand (BtorSimRNG* rng, uint32_t from, uint32_t to)
   res += from;
   return res;
 }
+
+/*------------------------------------------------------------------------*/
+
+static uint64_t
+rotl64 (uint64_t x, uint32_t k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+/* splitmix64, used to expand the seed into the generator state */
+static uint64_t
+splitmix64 (uint64_t* x)
+{
+  uint64_t z = (*x += 0x9e3779b97f4a7c15ull);
+  z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z          = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+void
+btorsim_rng64_init (BtorSimRNG64* rng, uint64_t seed)
+{
+  assert (rng);
+
+  uint32_t i;
+
+  for (i = 0; i < 4; i++) rng->s[i] = splitmix64 (&seed);
+}
+
+uint64_t
+btorsim_rng64_rand (BtorSimRNG64* rng)
+{
+  assert (rng);
+
+  uint64_t *s, res, t;
+
+  s   = rng->s;
+  res = rotl64 (s[1] * 5, 7) * 9;
+  t   = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl64 (s[3], 45);
+  return res;
+}
+
+void
+btorsim_rng64_fill (BtorSimRNG64* rng, uint64_t* buf, size_t n)
+{
+  assert (rng);
+  assert (!n || buf);
+
+  size_t i;
+  uint64_t s0, s1, s2, s3, t;
+
+  /* keep the state in registers for the whole loop */
+  s0 = rng->s[0];
+  s1 = rng->s[1];
+  s2 = rng->s[2];
+  s3 = rng->s[3];
+  for (i = 0; i < n; i++)
+  {
+    buf[i] = rotl64 (s1 * 5, 7) * 9;
+    t      = s1 << 17;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = rotl64 (s3, 45);
+  }
+  rng->s[0] = s0;
+  rng->s[1] = s1;
+  rng->s[2] = s2;
+  rng->s[3] = s3;
+}
+
+void
+btorsim_rng64_jump (BtorSimRNG64* rng)
+{
+  assert (rng);
+
+  static const uint64_t jump[] = {0x180ec6d33cfd0abaull,
+                                  0xd5a61266f0c9392cull,
+                                  0xa9582618e03fc9aaull,
+                                  0x39abdc4529b1661cull};
+  uint64_t s[4] = {0, 0, 0, 0};
+  uint32_t i, j, b;
+
+  for (i = 0; i < 4; i++)
+    for (b = 0; b < 64; b++)
+    {
+      if (jump[i] & ((uint64_t) 1 << b))
+        for (j = 0; j < 4; j++) s[j] ^= rng->s[j];
+      (void) btorsim_rng64_rand (rng);
+    }
+  for (j = 0; j < 4; j++) rng->s[j] = s[j];
+}
+
+void
+btorsim_rng64_split (BtorSimRNG64* rng, BtorSimRNG64* stream)
+{
+  assert (rng);
+  assert (stream);
+
+  *stream = *rng;
+  btorsim_rng64_jump (rng);
+}
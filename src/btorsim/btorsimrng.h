@@ -13,6 +13,7 @@
 #define BTOR2RNG_H_INCLUDED
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #if __cplusplus
@@ -30,6 +31,29 @@ void btorsim_rng_init (BtorSimRNG* rng, uint32_t seed);
 uint32_t btorsim_rng_rand (BtorSimRNG* rng);
 uint32_t btorsim_rng_pick_rand (BtorSimRNG* rng, uint32_t from, uint32_t to);
 
+/*------------------------------------------------------------------------*/
+
+/* 64-bit xoshiro256** generator, independent of BtorSimRNG, which is kept
+ * so that existing seeds reproduce the same traces. */
+
+struct BtorSimRNG64
+{
+  uint64_t s[4];
+};
+typedef struct BtorSimRNG64 BtorSimRNG64;
+
+void btorsim_rng64_init (BtorSimRNG64* rng, uint64_t seed);
+
+uint64_t btorsim_rng64_rand (BtorSimRNG64* rng);
+/* fill 'buf' with 'n' random 64-bit values */
+void btorsim_rng64_fill (BtorSimRNG64* rng, uint64_t* buf, size_t n);
+
+/* advance 'rng' by 2^128 steps, i.e., to the start of the next stream */
+void btorsim_rng64_jump (BtorSimRNG64* rng);
+/* set 'stream' to the current stream of 'rng' and advance 'rng' to the
+ * next one, streams obtained this way do not overlap for 2^128 steps */
+void btorsim_rng64_split (BtorSimRNG64* rng, BtorSimRNG64* stream);
+
 #if __cplusplus
 }
 #endif
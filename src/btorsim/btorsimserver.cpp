@@ -0,0 +1,342 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#include "btorsimserver.h"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cerrno>
+#include <cinttypes>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "btorsimhelpers.h"
+
+/*------------------------------------------------------------------------*/
+
+/* the simulation of one client */
+struct BtorSimServer::Session : BtorSimSession
+{
+  explicit Session (BtorSimModel &model) : BtorSimSession (model) {}
+
+  /* snapshots by number, deleted ones are 'nullptr' */
+  std::vector<std::unique_ptr<Snapshot>> snapshots;
+};
+
+BtorSimServer::BtorSimServer (BtorSimModel &model, WitnessChecker check)
+    : model (model), check (check)
+{
+  for (int64_t id = 1; id < model.num_format_lines; id++)
+  {
+    Btor2Line *l = btor2parser_get_line_by_id (model.parser, id);
+    if (l && l->symbol && l->tag != BTOR2_TAG_sort) symbols[l->symbol] = id;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+/* Requests take the thread of their client until they are answered, which
+ * for one request of many steps would keep the client (and the server when
+ * serving standard input) busy for a long time. */
+static const int64_t max_steps_per_request = 1 << 20;
+
+static bool
+parse_number (const std::string &s, int64_t &res)
+{
+  if (s.empty () || !isdigit ((unsigned char) s[0])) return false;
+  errno     = 0;
+  char *end = nullptr;
+  res       = strtoll (s.c_str (), &end, 10);
+  return !errno && !*end;
+}
+
+static std::string
+failed (const std::string &message)
+{
+  return "error " + message;
+}
+
+std::string
+BtorSimServer::handle (Session &session, const char *request, bool &quit)
+{
+  std::vector<std::string> args;
+  for (const char *p = request; *p;)
+  {
+    if (isspace ((unsigned char) *p))
+    {
+      p++;
+      continue;
+    }
+    const char *start = p;
+    while (*p && !isspace ((unsigned char) *p)) p++;
+    args.emplace_back (start, p - start);
+  }
+  if (args.empty ()) return failed ("empty request");
+
+  const std::string &cmd = args[0];
+  BtorSim &sim           = session.sim;
+  int64_t n              = 0;
+
+  if (cmd == "input" || cmd == "state")
+  {
+    if (args.size () != 3)
+      return failed ("expected '" + cmd + " <pos> <bits>'");
+    const std::vector<Btor2Line *> &lines =
+        cmd == "input" ? model.inputs : model.states;
+    if (!parse_number (args[1], n) || n >= (int64_t) lines.size ())
+      return failed ("invalid " + cmd + " '" + args[1] + "'");
+    std::string message;
+    BtorSimBitVector *val =
+        model.parse_bits (lines[n], args[2].c_str (), message);
+    if (!val) return failed (message);
+    session.set (lines[n]->id, val);
+    return "ok";
+  }
+  if (cmd == "step")
+  {
+    n = 1;
+    if (args.size () > 2 || (args.size () == 2 && !parse_number (args[1], n)))
+      return failed ("expected 'step [<n>]'");
+    if (n > max_steps_per_request)
+      return failed ("at most " + std::to_string (max_steps_per_request)
+                     + " steps per request");
+    /* later steps of traces violating constraints are meaningless */
+    for (int64_t i = 0; i < n; i++)
+    {
+      session.simulate_step ();
+      if (sim.constraints_violated >= 0) break;
+    }
+    return "ok " + std::to_string (session.step);
+  }
+  if (cmd == "value")
+  {
+    if (args.size () != 2) return failed ("expected 'value <id>|<symbol>'");
+    if (!parse_number (args[1], n))
+    {
+      auto it = symbols.find (args[1]);
+      n       = it == symbols.end () ? 0 : it->second;
+    }
+    if (n <= 0 || n >= model.num_format_lines)
+      return failed ("invalid line '" + args[1] + "'");
+    const BtorSimState &v = sim.current_state[n];
+    if (v.type != BtorSimState::Type::BITVEC || !v.is_set ())
+      return failed ("no bit-vector value of '" + args[1] + "'");
+    std::string res = "ok ";
+    v.append_to_string (res);
+    return res;
+  }
+  if (cmd == "bad")
+  {
+    if (args.size () != 2 || !parse_number (args[1], n)
+        || n >= (int64_t) model.bads.size ())
+      return failed ("expected 'bad <pos>'");
+    return "ok " + std::to_string (sim.reached_bads[n]);
+  }
+  if (cmd == "constraints")
+  {
+    if (args.size () != 1) return failed ("expected 'constraints'");
+    return "ok " + std::to_string (sim.constraints_violated);
+  }
+  if (cmd == "seed")
+  {
+    if (args.size () != 2 || !parse_number (args[1], n) || n > UINT32_MAX)
+      return failed ("expected 'seed <s>'");
+    session.randomize = true;
+    btorsim_rng_init (&sim.rng, (uint32_t) n);
+    return "ok";
+  }
+  if (cmd == "reset")
+  {
+    if (args.size () != 1) return failed ("expected 'reset'");
+    session.reset ();
+    return "ok";
+  }
+  if (cmd == "snapshot")
+  {
+    if (args.size () != 1) return failed ("expected 'snapshot'");
+    Session::Snapshot *snapshot = new Session::Snapshot;
+    session.save (*snapshot);
+    session.snapshots.emplace_back (snapshot);
+    return "ok " + std::to_string (session.snapshots.size () - 1);
+  }
+  if (cmd == "restore" || cmd == "drop")
+  {
+    if (args.size () != 2 || !parse_number (args[1], n)
+        || n >= (int64_t) session.snapshots.size () || !session.snapshots[n])
+      return failed ("invalid snapshot in '" + std::string (request) + "'");
+    if (cmd == "drop")
+    {
+      session.snapshots[n].reset ();
+      return "ok";
+    }
+    session.restore (*session.snapshots[n]);
+    return "ok";
+  }
+  if (cmd == "check")
+  {
+    if (args.size () != 2) return failed ("expected 'check <path>'");
+    std::string res;
+    if (!check (args[1].c_str (), res)) return failed (res);
+    return "ok" + res;
+  }
+  if (cmd == "quit")
+  {
+    quit = true;
+    return "ok";
+  }
+  return failed ("unknown request '" + cmd + "'");
+}
+
+/*------------------------------------------------------------------------*/
+
+static bool
+write_all (int fd, const std::string &s)
+{
+  for (size_t written = 0; written < s.size ();)
+  {
+    ssize_t n = write (fd, s.data () + written, s.size () - written);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    written += n;
+  }
+  return true;
+}
+
+/* longer requests are answered with an error and otherwise ignored, such
+ * that clients can not make the server buffer unbounded input */
+static const size_t max_request_length = 1 << 20;
+
+/* Requests are read in chunks and answered together, such that pipelined
+ * requests only take one read and one write. */
+void
+BtorSimServer::serve (int in, int out)
+{
+  Session session (model);
+  std::string requests, responses;
+  char buf[1 << 16];
+  bool quit = false, eof = false;
+  /* the rest of a too long request up to its new-line is skipped */
+  bool skip = false;
+  while (!quit && !eof)
+  {
+    ssize_t n = read (in, buf, sizeof buf);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0)
+    {
+      /* a last request without new-line */
+      if (requests.empty ()) break;
+      requests += '\n';
+      eof = true;
+    }
+    else
+      requests.append (buf, n);
+    size_t start = 0, end;
+    while (!quit && (end = requests.find ('\n', start)) != std::string::npos)
+    {
+      if (skip)
+        skip = false;
+      else
+      {
+        requests[end] = 0;
+        if (end - start > max_request_length)
+          responses += failed ("request too long");
+        else
+          responses += handle (session, requests.c_str () + start, quit);
+        responses += '\n';
+      }
+      start = end + 1;
+    }
+    requests.erase (0, start);
+    if (requests.size () > max_request_length)
+    {
+      if (!skip) responses += failed ("request too long") + '\n';
+      requests.clear ();
+      skip = true;
+    }
+    if (!write_all (out, responses)) break;
+    responses.clear ();
+  }
+}
+
+bool
+BtorSimServer::listen (const char *path, std::string &error)
+{
+  struct sockaddr_un addr;
+  memset (&addr, 0, sizeof addr);
+  addr.sun_family = AF_UNIX;
+  if (strlen (path) >= sizeof addr.sun_path)
+  {
+    error = std::string ("socket path '") + path + "' too long";
+    return false;
+  }
+  strcpy (addr.sun_path, path);
+
+  /* only stale sockets are removed, never other files */
+  struct stat st;
+  if (!lstat (path, &st))
+  {
+    if (!S_ISSOCK (st.st_mode))
+    {
+      error = std::string ("'") + path + "' exists and is not a socket";
+      return false;
+    }
+    if (unlink (path))
+    {
+      error = std::string ("can not remove '") + path
+              + "': " + strerror (errno);
+      return false;
+    }
+  }
+
+  int fd = socket (AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+  {
+    error = std::string ("can not create socket: ") + strerror (errno);
+    return false;
+  }
+  /* create the socket file with owner-only permissions, no other threads
+   * are running yet which could create files meanwhile */
+  mode_t umask_saved = umask (077);
+  int bound          = bind (fd, (struct sockaddr *) &addr, sizeof addr);
+  umask (umask_saved);
+  if (bound || ::listen (fd, SOMAXCONN))
+  {
+    error = std::string ("can not listen on '") + path
+            + "': " + strerror (errno);
+    close (fd);
+    return false;
+  }
+  /* clients closing their connection early must not stop the server */
+  signal (SIGPIPE, SIG_IGN);
+  msg (1, "serving clients on '%s'", path);
+
+  for (;;)
+  {
+    int client = accept (fd, nullptr, nullptr);
+    if (client < 0)
+    {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      error = std::string ("can not accept clients: ") + strerror (errno);
+      close (fd);
+      return false;
+    }
+    std::thread ([this, client] {
+      serve (client, client);
+      close (client);
+    }).detach ();
+  }
+}
@@ -0,0 +1,74 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#ifndef BTOR2SERVER_H_INCLUDED
+#define BTOR2SERVER_H_INCLUDED
+
+#include <string>
+#include <unordered_map>
+
+#include "btorsimengine.h"
+
+/* Simulation server ('btorsim --server'), which parses the model once and
+ * then answers requests of clients, one per line, with one line each:
+ *
+ *   input <pos> <bits>     set input <pos> of the next step
+ *   state <pos> <bits>     set state <pos> of the next step
+ *   step [<n>]             simulate the next <n> steps (default 1, at most
+ *                          2^20) but stop once constraints are violated,
+ *                          returns the last simulated step
+ *   value <id>|<symbol>    value of a bit-vector line in the last step
+ *   bad <pos>              step at which bad state property <pos> was
+ *                          reached first (-1 if not reached)
+ *   constraints            step at which constraints were violated first
+ *   seed <s>               randomize inputs and states that are not set
+ *   reset                  start a new trace at step 0
+ *   snapshot               snapshot the simulation, returns its number
+ *   restore <n>            restore snapshot <n>
+ *   drop <n>               delete snapshot <n>
+ *   check <path>           check the witness in the file <path>, which is
+ *                          opened by the server with its permissions
+ *   quit                   close the connection
+ *
+ * Responses are 'ok', followed by the result if any, or 'error <message>'.
+ * Requests longer than 1 MiB are answered with an error and ignored.
+ * Requests can be sent without waiting for responses, which are sent in
+ * order.  Every client has its own session ('BtorSimSession') of the shared
+ * model, with the semantics of the step-level library 'btorsimlib.h'. */
+class BtorSimServer
+{
+ public:
+  /* Check the witness in the file 'path' of the model and return true with
+   * the reached bad state properties (as ' b<pos>@<step>' each) in 'res',
+   * or false with the error in 'res'. */
+  typedef bool (*WitnessChecker) (const char *path, std::string &res);
+
+  BtorSimServer (BtorSimModel &model, WitnessChecker check);
+
+  /* Serve one client reading requests from the file descriptor 'in' and
+   * writing responses to 'out', until the end of its requests or 'quit'. */
+  void serve (int in, int out);
+
+  /* Serve clients connecting to the Unix domain socket 'path', each by its
+   * own thread.  The socket is only accessible by the user of the server,
+   * since clients can make it read any of its files with 'check'.  Only
+   * returns on errors, which are stored in 'error'. */
+  bool listen (const char *path, std::string &error);
+
+ private:
+  struct Session;
+  std::string handle (Session &session, const char *request, bool &quit);
+
+  BtorSimModel &model;
+  WitnessChecker check;
+  /* lines with symbols, which can be queried by their symbol */
+  std::unordered_map<std::string, int64_t> symbols;
+};
+
+#endif
@@ -19,6 +19,17 @@ void
 BtorSimState::update (BtorSimBitVector *bv)
 {
   assert (type == BtorSimState::Type::BITVEC);
+  if (is_word ())
+  {
+    assert (!bv || bv->width == width);
+    has_word = bv != nullptr;
+    if (bv)
+    {
+      bv_word = btorsim_bv_to_uint64 (bv);
+      btorsim_bv_free (bv);
+    }
+    return;
+  }
   if (bv_state) btorsim_bv_free (bv_state);
   bv_state = bv;
 }
@@ -27,7 +38,7 @@ void
 BtorSimState::update (BtorSimArrayModel *am)
 {
   assert (type == ARRAY);
-  if (array_state) delete array_state;
+  if (array_state) array_state->unshare ();
   array_state = am;
 }
 
@@ -42,7 +53,17 @@ BtorSimState::update (BtorSimState &s)
       break;
     case BtorSimState::Type::BITVEC:
       assert (s.type == BITVEC);
-      update (s.bv_state);
+      if (s.is_word ())
+      {
+        if (!s.has_word)
+          remove ();
+        else if (is_word ())
+          update_word (s.bv_word);
+        else
+          update (s.copy_bv ());
+      }
+      else
+        update (s.bv_state);
       break;
     default: die ("Updating invalid state!");
   }
@@ -54,27 +75,144 @@ BtorSimState::remove ()
   switch (type)
   {
     case ARRAY:
-      if (array_state) delete array_state;
+      if (array_state) array_state->unshare ();
       array_state = nullptr;
       break;
     case BtorSimState::Type::BITVEC:
-      if (bv_state) btorsim_bv_free (bv_state);
-      bv_state = nullptr;
+      if (is_word ())
+        has_word = false;
+      else
+      {
+        if (bv_state) btorsim_bv_free (bv_state);
+        bv_state = nullptr;
+      }
       break;
     default: die ("Removing invalid state!");
   }
 }
 
+void
+BtorSimState::release ()
+{
+  switch (type)
+  {
+    case ARRAY: array_state = nullptr; break;
+    case BtorSimState::Type::BITVEC:
+      if (is_word ())
+        has_word = false;
+      else
+        bv_state = nullptr;
+      break;
+    default: die ("Releasing invalid state!");
+  }
+}
+
 bool
-BtorSimState::is_set ()
+BtorSimState::is_set () const
 {
   switch (type)
   {
     case ARRAY: return array_state != nullptr;
-    case BtorSimState::Type::BITVEC: return bv_state != nullptr;
+    case BtorSimState::Type::BITVEC:
+      return is_word () ? has_word : bv_state != nullptr;
     default:
       die ("Checking invalid state!");
       return false;  // compiler can't tell that die contains exit, complains
                      // about lack of return value
   }
 }
+
+BtorSimState
+BtorSimState::copy () const
+{
+  BtorSimState res = *this;
+  if (type == ARRAY)
+  {
+    if (array_state) res.array_state = array_state->copy ();
+  }
+  else if (!is_word ())
+  {
+    assert (type == BITVEC);
+    if (bv_state) res.bv_state = btorsim_bv_copy (bv_state);
+  }
+  return res;
+}
+
+BtorSimState
+BtorSimState::share () const
+{
+  BtorSimState res = *this;
+  if (type == ARRAY)
+  {
+    if (array_state) res.array_state = array_state->share ();
+  }
+  else if (type == BITVEC && !is_word ())
+  {
+    if (bv_state) res.bv_state = btorsim_bv_copy (bv_state);
+  }
+  return res;
+}
+
+uint32_t
+BtorSimState::bv_width () const
+{
+  assert (type == BITVEC);
+  assert (is_set ());
+  return is_word () ? width : bv_state->width;
+}
+
+bool
+BtorSimState::is_zero () const
+{
+  assert (type == BITVEC);
+  assert (is_set ());
+  return is_word () ? !bv_word : btorsim_bv_is_zero (bv_state);
+}
+
+int32_t
+BtorSimState::compare (const BtorSimBitVector *bv) const
+{
+  assert (type == BITVEC);
+  assert (is_set ());
+  if (!is_word ()) return btorsim_bv_compare (bv_state, bv);
+  if (bv->width != width) return -1;
+  uint64_t word = btorsim_bv_to_uint64 (bv);
+  return bv_word == word ? 0 : (bv_word < word ? -1 : 1);
+}
+
+bool
+BtorSimState::equals (const BtorSimState &s) const
+{
+  assert (type == BITVEC), assert (s.type == BITVEC);
+  if (is_word () && s.is_word ()) return bv_word == s.bv_word;
+  if (!is_word () && !s.is_word ())
+    return !btorsim_bv_compare (bv_state, s.bv_state);
+  const BtorSimState &w = is_word () ? *this : s;
+  const BtorSimState &b = is_word () ? s : *this;
+  return !w.compare (b.bv_state);
+}
+
+BtorSimBitVector *
+BtorSimState::copy_bv () const
+{
+  assert (type == BITVEC);
+  assert (is_set ());
+  if (is_word ()) return btorsim_bv_uint64_to_bv (bv_word, width);
+  return btorsim_bv_copy (bv_state);
+}
+
+void
+BtorSimState::append_to_string (std::string &s) const
+{
+  assert (type == BITVEC);
+  assert (is_set ());
+  if (!is_word ())
+  {
+    btorsim_bv_append_to_string (s, bv_state);
+    return;
+  }
+  size_t n = s.size ();
+  s.resize (n + width);
+  for (uint32_t i = 0; i < width; i++)
+    s[n + i] = '0' + ((bv_word >> (width - 1 - i)) & 1);
+}
@@ -12,11 +12,19 @@
 #ifndef BTOR2STATE_H_INCLUDED
 #define BTOR2STATE_H_INCLUDED
 
+#include <cassert>
+#include <cstdint>
+#include <string>
+
 #include "btorsimam.h"
 #include "btorsimbv.h"
 
+/* Bit-vectors of at most this width are stored inline. */
+#define BTORSIM_STATE_WORD_WIDTH 64
+
 /* Typed union container class for state values, can point to either a BitVector
- * or an ArrayModel. */
+ * or an ArrayModel.  If 'width' is set, bit-vector values of at most
+ * BTORSIM_STATE_WORD_WIDTH bits are stored inline in 'bv_word' instead. */
 struct BtorSimState
 {
   enum Type
@@ -26,27 +34,65 @@ struct BtorSimState
     ARRAY
   };
   Type type;
+  uint32_t width;  // bit-width of bit-vector values, 0 if unknown
+  bool has_word;   // inline value is set
   union
   {
     BtorSimBitVector *bv_state;
     BtorSimArrayModel *array_state;
+    uint64_t bv_word;
   };
 
-  BtorSimState () : type (INVALID), bv_state (nullptr){};
+  BtorSimState ()
+      : type (INVALID), width (0), has_word (false), bv_state (nullptr){};
+
+  // value is stored inline
+  bool is_word () const
+  {
+    return type == BITVEC && width && width <= BTORSIM_STATE_WORD_WIDTH;
+  }
 
   /* change the pointed-to value, frees memory of old value
    * does not make a copy of the argument! the input pointer becomes owned by
-   * the state
+   * the state (and is freed right away if the value is stored inline)
    */
   void update (BtorSimBitVector *bv);
   void update (BtorSimArrayModel *am);
   void update (BtorSimState &s);
 
+  // change the inline value, 'word' must not have bits above 'width' set
+  void update_word (uint64_t word)
+  {
+    assert (is_word ());
+    assert (width == 64 || !(word >> width));
+    bv_word  = word;
+    has_word = true;
+  }
+
   // free memory of value, replace with nullptr
   void remove ();
 
+  // forget the value without freeing it, after its ownership was passed on
+  void release ();
+
   // state is not null
-  bool is_set ();
+  bool is_set () const;
+
+  // return a copy of the state with a copy of its value
+  BtorSimState copy () const;
+  // return a copy of the state sharing its array (see 'BtorSimArrayModel')
+  BtorSimState share () const;
+
+  /* bit-vector value queries */
+  uint32_t bv_width () const;
+  bool is_zero () const;
+  // return 0 if the value is equal to 'bv'
+  int32_t compare (const BtorSimBitVector *bv) const;
+  bool equals (const BtorSimState &s) const;
+  // return a new bit-vector holding the value
+  BtorSimBitVector *copy_bv () const;
+  // append the binary representation of the value to 's'
+  void append_to_string (std::string &s) const;
 };
 
 #endif
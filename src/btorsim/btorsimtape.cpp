@@ -0,0 +1,1726 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#include "btorsimtape.h"
+
+#include <cassert>
+#include <cinttypes>
+#include <cstdlib>
+#include <string>
+#include <utility>
+
+#include "btorsimbatch.h"
+#include "btorsimhelpers.h"
+
+/*------------------------------------------------------------------------*/
+
+static bool
+is_leaf (const Btor2Line *l)
+{
+  return l->tag == BTOR2_TAG_input || l->tag == BTOR2_TAG_state;
+}
+
+/* lines that are not computed, and can not be used as operands */
+static bool
+is_skipped (const Btor2Line *l)
+{
+  switch (l->tag)
+  {
+    case BTOR2_TAG_sort:
+    case BTOR2_TAG_init:
+    case BTOR2_TAG_next:
+    case BTOR2_TAG_bad:
+    case BTOR2_TAG_constraint:
+    case BTOR2_TAG_fair:
+    case BTOR2_TAG_justice:
+    case BTOR2_TAG_output: return true;
+    default: return false;
+  }
+}
+
+int64_t
+BtorSimTape::slot (int64_t arg) const
+{
+  if (arg >= 0)
+  {
+    assert (arg < num_format_lines);
+    return arg;
+  }
+  assert (-arg < num_format_lines);
+  assert (negated_slot[-arg] >= 0);
+  return negated_slot[-arg];
+}
+
+uint32_t
+BtorSimTape::slot_width (int64_t s) const
+{
+  assert (0 <= s), assert (s < num_slots ());
+  int64_t id      = s < num_format_lines ? s : negated[s - num_format_lines];
+  Btor2Line *l    = btor2parser_get_line_by_id (model, id);
+  Btor2Sort *sort = get_sort (l, model);
+  return sort->tag == BTOR2_TAG_SORT_bitvec ? sort->bitvec.width : 0;
+}
+
+BtorSimInstr
+BtorSimTape::make_instr (int64_t s, bool in_init) const
+{
+  BtorSimInstr in;
+  in.res    = s;
+  in.nargs  = 0;
+  in.imm[0] = in.imm[1] = 0;
+  /* unused operands refer to the result slot */
+  in.args[0] = in.args[1] = in.args[2] = s;
+
+  int64_t id = s < num_format_lines ? s : negated[s - num_format_lines];
+  Btor2Line *l = btor2parser_get_line_by_id (model, id);
+  assert (l);
+  in.line = l;
+
+  Btor2Sort *sort = get_sort (l, model);
+  if (sort->tag == BTOR2_TAG_SORT_array)
+  {
+    Btor2Line *le = btor2parser_get_line_by_id (model, sort->array.element);
+    assert (le->sort.tag == BTOR2_TAG_SORT_bitvec);
+    in.width       = le->sort.bitvec.width;
+    in.width_class = BTORSIM_WIDTH_ARRAY;
+  }
+  else
+  {
+    assert (sort->tag == BTOR2_TAG_SORT_bitvec);
+    in.width = sort->bitvec.width;
+    if (in.width == 1)
+      in.width_class = BTORSIM_WIDTH_BOOL;
+    else if (in.width <= 64)
+      in.width_class = BTORSIM_WIDTH_WORD;
+    else
+      in.width_class = BTORSIM_WIDTH_WIDE;
+  }
+
+  in.is_word   = in.width_class == BTORSIM_WIDTH_BOOL
+               || in.width_class == BTORSIM_WIDTH_WORD;
+  in.arg_width = 0;
+
+  if (s >= num_format_lines)
+  {
+    assert (in.width_class != BTORSIM_WIDTH_ARRAY);
+    in.op        = BTORSIM_OP_NOT;
+    in.nargs     = 1;
+    in.args[0]   = id;
+    in.arg_width = in.width;
+    return in;
+  }
+
+  if (!is_leaf (l))
+  {
+    in.nargs = l->nargs;
+    for (uint32_t i = 0; i < l->nargs; i++)
+    {
+      in.args[i] = slot (l->args[i]);
+      uint32_t w = slot_width (in.args[i]);
+      if (!i) in.arg_width = w;
+      if (!w || w > BTORSIM_STATE_WORD_WIDTH) in.is_word = false;
+    }
+  }
+
+  bool swap = false;
+  switch (l->tag)
+  {
+    case BTOR2_TAG_add: in.op = BTORSIM_OP_ADD; break;
+    case BTOR2_TAG_and: in.op = BTORSIM_OP_AND; break;
+    case BTOR2_TAG_concat: in.op = BTORSIM_OP_CONCAT; break;
+    case BTOR2_TAG_const: in.op = BTORSIM_OP_CONST; break;
+    case BTOR2_TAG_constd: in.op = BTORSIM_OP_CONSTD; break;
+    case BTOR2_TAG_consth: in.op = BTORSIM_OP_CONSTH; break;
+    case BTOR2_TAG_dec: in.op = BTORSIM_OP_DEC; break;
+    case BTOR2_TAG_eq:
+    case BTOR2_TAG_neq: {
+      Btor2Line *a  = btor2parser_get_line_by_id (model, std::abs (l->args[0]));
+      bool is_array = get_sort (a, model)->tag == BTOR2_TAG_SORT_array;
+      bool is_eq    = l->tag == BTOR2_TAG_eq;
+      if (is_array)
+        in.op = is_eq ? BTORSIM_OP_AM_EQ : BTORSIM_OP_AM_NEQ;
+      else
+        in.op = is_eq ? BTORSIM_OP_EQ : BTORSIM_OP_NEQ;
+    }
+    break;
+    case BTOR2_TAG_implies: in.op = BTORSIM_OP_IMPLIES; break;
+    case BTOR2_TAG_inc: in.op = BTORSIM_OP_INC; break;
+    case BTOR2_TAG_ite:
+      in.op = in.width_class == BTORSIM_WIDTH_ARRAY ? BTORSIM_OP_AM_ITE
+                                                    : BTORSIM_OP_ITE;
+      break;
+    case BTOR2_TAG_mul: in.op = BTORSIM_OP_MUL; break;
+    case BTOR2_TAG_nand: in.op = BTORSIM_OP_NAND; break;
+    case BTOR2_TAG_neg: in.op = BTORSIM_OP_NEG; break;
+    case BTOR2_TAG_nor: in.op = BTORSIM_OP_NOR; break;
+    case BTOR2_TAG_not: in.op = BTORSIM_OP_NOT; break;
+    case BTOR2_TAG_one: in.op = BTORSIM_OP_ONE; break;
+    case BTOR2_TAG_ones: in.op = BTORSIM_OP_ONES; break;
+    case BTOR2_TAG_or: in.op = BTORSIM_OP_OR; break;
+    case BTOR2_TAG_redand: in.op = BTORSIM_OP_REDAND; break;
+    case BTOR2_TAG_redor: in.op = BTORSIM_OP_REDOR; break;
+    case BTOR2_TAG_redxor: in.op = BTORSIM_OP_REDXOR; break;
+    case BTOR2_TAG_rol: in.op = BTORSIM_OP_ROL; break;
+    case BTOR2_TAG_ror: in.op = BTORSIM_OP_ROR; break;
+    case BTOR2_TAG_sdiv: in.op = BTORSIM_OP_SDIV; break;
+    case BTOR2_TAG_slice:
+      in.op     = BTORSIM_OP_SLICE;
+      in.nargs  = 1;
+      in.imm[0] = l->args[1];
+      in.imm[1] = l->args[2];
+      break;
+    case BTOR2_TAG_sll: in.op = BTORSIM_OP_SLL; break;
+    case BTOR2_TAG_smod: in.op = BTORSIM_OP_SMOD; break;
+    case BTOR2_TAG_sra: in.op = BTORSIM_OP_SRA; break;
+    case BTOR2_TAG_srem: in.op = BTORSIM_OP_SREM; break;
+    case BTOR2_TAG_srl: in.op = BTORSIM_OP_SRL; break;
+    case BTOR2_TAG_sub: in.op = BTORSIM_OP_SUB; break;
+    case BTOR2_TAG_udiv: in.op = BTORSIM_OP_UDIV; break;
+    case BTOR2_TAG_sext:
+    case BTOR2_TAG_uext: {
+      Btor2Line *a = btor2parser_get_line_by_id (model, std::abs (l->args[0]));
+      uint32_t width = a->sort.bitvec.width;
+      assert (width <= in.width);
+      in.imm[0] = in.width - width;
+      if (!in.imm[0])
+        in.op = BTORSIM_OP_COPY;
+      else if (l->tag == BTOR2_TAG_sext)
+        in.op = BTORSIM_OP_SEXT;
+      else
+        in.op = BTORSIM_OP_UEXT;
+    }
+    break;
+    case BTOR2_TAG_ugt: swap = true; /* fall through */
+    case BTOR2_TAG_ult: in.op = BTORSIM_OP_ULT; break;
+    case BTOR2_TAG_ugte: swap = true; /* fall through */
+    case BTOR2_TAG_ulte: in.op = BTORSIM_OP_ULTE; break;
+    case BTOR2_TAG_sgt: swap = true; /* fall through */
+    case BTOR2_TAG_slt: in.op = BTORSIM_OP_SLT; break;
+    case BTOR2_TAG_sgte: swap = true; /* fall through */
+    case BTOR2_TAG_slte: in.op = BTORSIM_OP_SLTE; break;
+    case BTOR2_TAG_urem: in.op = BTORSIM_OP_UREM; break;
+    case BTOR2_TAG_iff:
+    case BTOR2_TAG_xnor: in.op = BTORSIM_OP_XNOR; break;
+    case BTOR2_TAG_xor: in.op = BTORSIM_OP_XOR; break;
+    case BTOR2_TAG_zero: in.op = BTORSIM_OP_ZERO; break;
+    case BTOR2_TAG_read: in.op = BTORSIM_OP_READ; break;
+    case BTOR2_TAG_write: in.op = BTORSIM_OP_WRITE; break;
+    case BTOR2_TAG_input:
+    case BTOR2_TAG_state:
+      if (in_init)
+      {
+        in.op      = BTORSIM_OP_LEAF;
+        in.is_word = false;
+        break;
+      }
+      /* fall through */
+    default:
+      die ("can not randomly simulate operator '%s' at line %" PRId64,
+           l->name,
+           l->lineno);
+      break;
+  }
+  if (swap) std::swap (in.args[0], in.args[1]);
+  return in;
+}
+
+/* Append the instructions of all not yet emitted nodes in the cone of slot
+ * 'root' to 'prog' in topological order.  Inputs and states end the cone and
+ * are only emitted into init programs.  Constant nodes also end the cone,
+ * their cones are emitted into the constant program (once). */
+void
+BtorSimTape::emit_cone (int64_t root,
+                        std::vector<BtorSimInstr> &prog,
+                        std::vector<bool> &emitted,
+                        bool in_init)
+{
+  /* slots with a flag whether their operands were already pushed */
+  std::vector<std::pair<int64_t, bool>> stack;
+  stack.emplace_back (root, false);
+  while (!stack.empty ())
+  {
+    int64_t s = stack.back ().first;
+    if (emitted[s])
+    {
+      stack.pop_back ();
+      continue;
+    }
+    if (is_constant[s] && &prog != &constants)
+    {
+      stack.pop_back ();
+      emitted[s] = true;
+      emit_cone (s, constants, emitted_constant, false);
+      continue;
+    }
+    Btor2Line *l = s < num_format_lines
+                       ? btor2parser_get_line_by_id (model, s)
+                       : nullptr;
+    if (!stack.back ().second)
+    {
+      stack.back ().second = true;
+      if (!l)
+        stack.emplace_back (negated[s - num_format_lines], false);
+      else if (!is_leaf (l))
+      {
+        /* push in reverse, such that the first operand is emitted first */
+        for (uint32_t i = l->nargs; i > 0; i--)
+          stack.emplace_back (slot (l->args[i - 1]), false);
+      }
+      continue;
+    }
+    stack.pop_back ();
+    emitted[s] = true;
+    if (l && is_leaf (l) && !in_init) continue;
+    prog.push_back (make_instr (s, in_init));
+  }
+}
+
+void
+BtorSimTape::compile (Btor2Parser *m)
+{
+  model            = m;
+  num_format_lines = btor2parser_max_id (model);
+
+  negated.clear ();
+  negated_slot.assign (num_format_lines, -1);
+  constants.clear ();
+  step.clear ();
+  init.clear ();
+  coi.clear ();
+  observed.clear ();
+  init_begin.assign (num_format_lines, 0);
+  init_end.assign (num_format_lines, 0);
+
+  Btor2LineIterator it = btor2parser_iter_init (model);
+  Btor2Line *l;
+  while ((l = btor2parser_iter_next (&it)))
+  {
+    if (l->tag == BTOR2_TAG_slice) assert (l->nargs == 1);
+    for (uint32_t i = 0; i < l->nargs; i++)
+    {
+      int64_t arg = l->args[i];
+      if (arg >= 0 || negated_slot[-arg] >= 0) continue;
+      negated_slot[-arg] = num_format_lines + negated.size ();
+      negated.push_back (-arg);
+    }
+  }
+
+  /* operands have smaller ids than the lines using them, and negations are
+   * constant if their operand is */
+  is_constant.assign (num_slots (), false);
+  for (int64_t i = 0; i < num_format_lines; i++)
+  {
+    l = btor2parser_get_line_by_id (model, i);
+    if (!l || is_leaf (l) || is_skipped (l)) continue;
+    uint32_t nargs = l->tag == BTOR2_TAG_slice ? 1 : l->nargs;
+    bool res       = true;
+    for (uint32_t j = 0; res && j < nargs; j++)
+      res = l->args[j] >= 0 ? is_constant[l->args[j]]
+                            : is_constant[-l->args[j]];
+    is_constant[i] = res;
+  }
+  for (size_t i = 0; i < negated.size (); i++)
+    is_constant[num_format_lines + i] = is_constant[negated[i]];
+  emitted_constant.assign (num_slots (), false);
+
+  /* the line with the largest id is not computed, unless it is used as an
+   * operand it does not need a slot */
+  std::vector<bool> emitted (num_slots (), false);
+  it = btor2parser_iter_init (model);
+  while ((l = btor2parser_iter_next (&it)))
+  {
+    if (!is_skipped (l))
+    {
+      if (l->id < num_format_lines) emit_cone (l->id, step, emitted, false);
+    }
+    else if (l->tag == BTOR2_TAG_next)
+      emit_cone (slot (l->args[1]), step, emitted, false);
+    else if (l->tag == BTOR2_TAG_bad || l->tag == BTOR2_TAG_constraint)
+      emit_cone (slot (l->args[0]), step, emitted, false);
+  }
+
+  /* every init program contains its whole cone, since in checking mode
+   * inits are evaluated in the order of the witness */
+  it = btor2parser_iter_init (model);
+  while ((l = btor2parser_iter_next (&it)))
+  {
+    if (l->tag != BTOR2_TAG_init) continue;
+    int64_t state = l->args[0];
+    std::vector<bool> emitted_init (num_slots (), false);
+    init_begin[state] = init.size ();
+    emit_cone (slot (l->args[1]), init, emitted_init, true);
+    init_end[state] = init.size ();
+  }
+
+  msg (1,
+       "compiled %zu instructions (%zu negations, %zu init instructions, "
+       "%zu constant instructions hoisted)",
+       step.size (),
+       negated.size (),
+       init.size (),
+       constants.size ());
+
+  index_step ();
+}
+
+void
+BtorSimTape::prune (const std::vector<int64_t> &roots)
+{
+  std::vector<Btor2Line *> nexts (num_format_lines, nullptr);
+  Btor2LineIterator it = btor2parser_iter_init (model);
+  Btor2Line *l;
+  while ((l = btor2parser_iter_next (&it)))
+    if (l->tag == BTOR2_TAG_next) nexts[l->args[0]] = l;
+
+  coi.assign (num_format_lines + 1, false);
+  std::vector<int64_t> stack;
+  for (int64_t root : roots) stack.push_back (root);
+  while (!stack.empty ())
+  {
+    int64_t id = stack.back ();
+    stack.pop_back ();
+    if (coi[id]) continue;
+    coi[id] = true;
+    l       = btor2parser_get_line_by_id (model, id);
+    assert (l);
+    if (l->tag == BTOR2_TAG_state)
+    {
+      if (nexts[id]) stack.push_back (std::abs (nexts[id]->args[1]));
+    }
+    else if (!is_leaf (l))
+    {
+      uint32_t nargs = l->tag == BTOR2_TAG_slice ? 1 : l->nargs;
+      for (uint32_t i = 0; i < nargs; i++)
+        stack.push_back (std::abs (l->args[i]));
+    }
+  }
+
+  size_t full_size = step.size ();
+  step.clear ();
+  std::vector<bool> emitted (num_slots (), false);
+  it = btor2parser_iter_init (model);
+  while ((l = btor2parser_iter_next (&it)))
+  {
+    if (l->tag == BTOR2_TAG_next && coi[l->args[0]])
+      emit_cone (slot (l->args[1]), step, emitted, false);
+    else if (!coi[l->id])
+      continue;
+    else if (!is_skipped (l))
+    {
+      if (l->id < num_format_lines) emit_cone (l->id, step, emitted, false);
+    }
+    else if (l->tag == BTOR2_TAG_bad || l->tag == BTOR2_TAG_constraint)
+      emit_cone (slot (l->args[0]), step, emitted, false);
+  }
+
+  msg (1,
+       "cone of influence contains %zu of %zu instructions (%.1f%% pruned)",
+       step.size (),
+       full_size,
+       full_size ? 100.0 * (full_size - step.size ()) / full_size : 0.0);
+
+  index_step ();
+}
+
+void
+BtorSimTape::index_step ()
+{
+  fanout.assign (num_slots (), std::vector<size_t> ());
+  leaves.clear ();
+  for (BtorSimState &v : leaf_values)
+    if (v.type && v.is_set ()) v.remove ();
+  leaf_values.clear ();
+  scheduled.assign (step.size (), false);
+  primed = false;
+
+  producer.assign (num_slots (), -1);
+  for (size_t i = 0; i < step.size (); i++) producer[step[i].res] = i;
+  epoch = 0;
+  reset_computed_at ();
+  native = nullptr;
+  native_outputs.clear ();
+  levelized_threads = 0;
+
+  demanded.clear ();
+  Btor2LineIterator it = btor2parser_iter_init (model);
+  Btor2Line *l;
+  while ((l = btor2parser_iter_next (&it)))
+  {
+    if (l->tag == BTOR2_TAG_next)
+    {
+      if (in_coi (l->args[0])) demanded.push_back (slot (l->args[1]));
+    }
+    else if (l->tag == BTOR2_TAG_bad || l->tag == BTOR2_TAG_constraint)
+    {
+      if (in_coi (l->id)) demanded.push_back (slot (l->args[0]));
+    }
+  }
+
+  std::vector<bool> is_read (num_slots (), false);
+  for (size_t i = 0; i < step.size (); i++)
+  {
+    const BtorSimInstr &in = step[i];
+    for (uint32_t j = 0; j < in.nargs; j++)
+    {
+      int64_t a = in.args[j];
+      if (!fanout[a].empty () && fanout[a].back () == i) continue;
+      fanout[a].push_back (i);
+      if (is_read[a]) continue;
+      is_read[a]   = true;
+      l = a < num_format_lines ? btor2parser_get_line_by_id (model, a)
+                               : nullptr;
+      if (l && is_leaf (l)) leaves.push_back (a);
+    }
+  }
+  leaf_values.resize (leaves.size ());
+}
+
+/*------------------------------------------------------------------------*/
+
+static inline uint64_t
+word_mask (uint32_t width)
+{
+  assert (0 < width), assert (width <= 64);
+  return width == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << width) - 1;
+}
+
+static inline int64_t
+word_signed (uint64_t a, uint32_t width)
+{
+  return (int64_t) (a << (64 - width)) >> (64 - width);
+}
+
+static inline bool
+word_sign (uint64_t a, uint32_t width)
+{
+  return (a >> (width - 1)) & 1;
+}
+
+static inline uint64_t
+word_udiv (uint64_t a, uint64_t b, uint64_t mask)
+{
+  return b ? a / b : mask;
+}
+
+static inline uint64_t
+word_urem (uint64_t a, uint64_t b)
+{
+  return b ? a % b : a;
+}
+
+/* Shift and rotate amounts beyond the bit-width behave as in btorsimbv.c. */
+
+static inline uint64_t
+word_srl (uint64_t a, uint64_t b, uint32_t width)
+{
+  return b >= width ? 0 : a >> b;
+}
+
+static inline uint64_t
+word_rol (uint64_t a, uint64_t b, uint32_t width)
+{
+  if (b > width) return 0;
+  if (b == width || !b) return a;
+  return ((a << b) | (a >> (width - b))) & word_mask (width);
+}
+
+/* Compute the result of instruction 'in' (other than a constant) whose
+ * result and operands are all stored inline from operand values 'a', 'b'
+ * and 'c'. */
+static inline uint64_t
+eval_word (const BtorSimInstr *in, uint64_t a, uint64_t b, uint64_t c)
+{
+  uint32_t width = in->width;
+  uint32_t aw    = in->arg_width;
+  uint64_t mask  = word_mask (width);
+  uint64_t res   = 0;
+  switch (in->op)
+  {
+    case BTORSIM_OP_ADD: res = (a + b) & mask; break;
+    case BTORSIM_OP_AND: res = a & b; break;
+    case BTORSIM_OP_CONCAT: res = (a << (width - aw)) | b; break;
+    case BTORSIM_OP_COPY: res = a; break;
+    case BTORSIM_OP_DEC: res = (a - 1) & mask; break;
+    case BTORSIM_OP_EQ: res = a == b; break;
+    case BTORSIM_OP_IMPLIES: res = (~a | b) & mask; break;
+    case BTORSIM_OP_INC: res = (a + 1) & mask; break;
+    case BTORSIM_OP_ITE: res = (a & 1) ? b : c; break;
+    case BTORSIM_OP_MUL: res = (a * b) & mask; break;
+    case BTORSIM_OP_NAND: res = ~(a & b) & mask; break;
+    case BTORSIM_OP_NEG: res = (~a + 1) & mask; break;
+    case BTORSIM_OP_NEQ: res = a != b; break;
+    case BTORSIM_OP_NOR: res = ~(a | b) & mask; break;
+    case BTORSIM_OP_NOT: res = ~a & mask; break;
+    case BTORSIM_OP_ONE: res = 1; break;
+    case BTORSIM_OP_ONES: res = mask; break;
+    case BTORSIM_OP_OR: res = a | b; break;
+    case BTORSIM_OP_REDAND: res = a == word_mask (aw); break;
+    case BTORSIM_OP_REDOR: res = a != 0; break;
+    case BTORSIM_OP_REDXOR: res = __builtin_parityll (a); break;
+    case BTORSIM_OP_ROL: res = word_rol (a, b, width); break;
+    case BTORSIM_OP_ROR:
+      res = b > width ? 0 : word_rol (a, b ? width - b : 0, width);
+      break;
+    case BTORSIM_OP_SDIV:
+      if (width == 1)
+        res = (a | ~b) & 1;
+      else
+      {
+        bool sa = word_sign (a, width), sb = word_sign (b, width);
+        uint64_t ua = sa ? (~a + 1) & mask : a;
+        uint64_t ub = sb ? (~b + 1) & mask : b;
+        res         = word_udiv (ua, ub, mask);
+        if (sa != sb) res = (~res + 1) & mask;
+      }
+      break;
+    case BTORSIM_OP_SEXT: res = word_signed (a, aw) & mask; break;
+    case BTORSIM_OP_SLICE: res = (a >> in->imm[1]) & mask; break;
+    case BTORSIM_OP_SLL: res = b >= width ? 0 : (a << b) & mask; break;
+    case BTORSIM_OP_SLT: res = word_signed (a, aw) < word_signed (b, aw); break;
+    case BTORSIM_OP_SLTE:
+      res = word_signed (a, aw) <= word_signed (b, aw);
+      break;
+    case BTORSIM_OP_SMOD:
+      if (width == 1)
+        res = a & ~b;
+      else
+      {
+        bool sa = word_sign (a, width), sb = word_sign (b, width);
+        uint64_t ua = sa ? (~a + 1) & mask : a;
+        uint64_t ub = sb ? (~b + 1) & mask : b;
+        uint64_t u  = word_urem (ua, ub);
+        uint64_t d  = u ? b : 0;
+        if (!sa && !sb)
+          res = u;
+        else if (sa && !sb)
+          res = (~u + 1 + d) & mask;
+        else if (!sa && sb)
+          res = (u + d) & mask;
+        else
+          res = (~u + 1) & mask;
+      }
+      break;
+    case BTORSIM_OP_SRA:
+      if (word_sign (a, width))
+        res = ~word_srl (~a & mask, b, width) & mask;
+      else
+        res = word_srl (a, b, width);
+      break;
+    case BTORSIM_OP_SREM:
+      if (width == 1)
+        res = a & ~b;
+      else
+      {
+        bool sa = word_sign (a, width), sb = word_sign (b, width);
+        uint64_t ua = sa ? (~a + 1) & mask : a;
+        uint64_t ub = sb ? (~b + 1) & mask : b;
+        res         = word_urem (ua, ub);
+        if (sa) res = (~res + 1) & mask;
+      }
+      break;
+    case BTORSIM_OP_SRL: res = word_srl (a, b, width); break;
+    case BTORSIM_OP_SUB: res = (a - b) & mask; break;
+    case BTORSIM_OP_UDIV: res = word_udiv (a, b, mask); break;
+    case BTORSIM_OP_UEXT: res = a; break;
+    case BTORSIM_OP_ULT: res = a < b; break;
+    case BTORSIM_OP_ULTE: res = a <= b; break;
+    case BTORSIM_OP_UREM: res = word_urem (a, b); break;
+    case BTORSIM_OP_XNOR: res = ~(a ^ b) & mask; break;
+    case BTORSIM_OP_XOR: res = a ^ b; break;
+    case BTORSIM_OP_ZERO: res = 0; break;
+    default:
+      die ("can not evaluate operator '%s' at line %" PRId64 " on words",
+           in->line->name,
+           in->line->lineno);
+  }
+  return res;
+}
+
+/* Evaluate instruction 'in' whose result and operands are all stored
+ * inline. */
+static inline void
+execute_word (const BtorSimInstr *in, std::vector<BtorSimState> &slots)
+{
+  BtorSimState &r = slots[in->res];
+  switch (in->op)
+  {
+    case BTORSIM_OP_CONST:
+      r.update (btorsim_bv_char_to_bv (in->line->constant));
+      break;
+    case BTORSIM_OP_CONSTD:
+      r.update (btorsim_bv_constd (in->line->constant, in->width));
+      break;
+    case BTORSIM_OP_CONSTH:
+      r.update (btorsim_bv_consth (in->line->constant, in->width));
+      break;
+    default:
+      r.update_word (eval_word (in,
+                                slots[in->args[0]].bv_word,
+                                slots[in->args[1]].bv_word,
+                                slots[in->args[2]].bv_word));
+  }
+}
+
+/* Array operands used to be copies of the operand values, which neither
+ * inherit 'random_seed' nor keep the elements added by 'read'.  Reads and
+ * comparisons behave as if the operands were still copied. */
+
+static BtorSimBitVector *
+read_element (const BtorSimArrayModel *am, const BtorSimBitVector *index)
+{
+  BtorSimBitVector *res = am->check (index);
+  if (res) return res;
+  if (am->const_init) return btorsim_bv_copy (am->const_init);
+  return btorsim_bv_new (am->element_width);
+}
+
+static bool
+equal_arrays (const BtorSimArrayModel *a, const BtorSimArrayModel *b)
+{
+  if (!a->random_seed && !b->random_seed) return *a == *b;
+  BtorSimArrayModel *ca = a->copy ();
+  BtorSimArrayModel *cb = b->copy ();
+  bool res              = *ca == *cb;
+  delete ca;
+  delete cb;
+  return res;
+}
+
+/* Evaluate instruction 'in' on bit-vectors and arrays.  Operands stored
+ * inline are converted to temporary bit-vectors, results are converted by
+ * 'BtorSimState::update'. */
+static void
+execute_generic (Btor2Parser *model,
+                 const BtorSimInstr *in,
+                 std::vector<BtorSimState> &slots)
+{
+  BtorSimState &r = slots[in->res];
+
+  if (in->op == BTORSIM_OP_LEAF)
+  {
+    if (!r.is_set ())
+      die ("can not randomly simulate operator '%s' at line %" PRId64,
+           in->line->name,
+           in->line->lineno);
+    return;
+  }
+
+  /* the condition of 'ite' is always inline */
+  if (in->op == BTORSIM_OP_ITE || in->op == BTORSIM_OP_AM_ITE)
+  {
+    const BtorSimState &c = slots[in->args[0]];
+    assert (c.is_word ());
+    const BtorSimState &t = slots[in->args[(c.bv_word & 1) ? 1 : 2]];
+    BtorSimState value    = t.copy ();
+    r.update (value);
+    return;
+  }
+
+  BtorSimBitVector *tmp[3]     = {nullptr, nullptr, nullptr};
+  const BtorSimBitVector *x[3] = {nullptr, nullptr, nullptr};
+  const BtorSimArrayModel *am  = nullptr;
+  for (uint32_t i = 0; i < in->nargs; i++)
+  {
+    const BtorSimState &s = slots[in->args[i]];
+    if (s.type == BtorSimState::Type::ARRAY)
+      am = s.array_state;
+    else if (s.is_word ())
+      x[i] = tmp[i] = s.copy_bv ();
+    else
+      x[i] = s.bv_state;
+  }
+
+  switch (in->op)
+  {
+    case BTORSIM_OP_ADD: r.update (btorsim_bv_add (x[0], x[1])); break;
+    case BTORSIM_OP_AND: r.update (btorsim_bv_and (x[0], x[1])); break;
+    case BTORSIM_OP_CONCAT: r.update (btorsim_bv_concat (x[0], x[1])); break;
+    case BTORSIM_OP_CONST:
+      r.update (btorsim_bv_char_to_bv (in->line->constant));
+      break;
+    case BTORSIM_OP_CONSTD:
+      r.update (btorsim_bv_constd (in->line->constant, in->width));
+      break;
+    case BTORSIM_OP_CONSTH:
+      r.update (btorsim_bv_consth (in->line->constant, in->width));
+      break;
+    case BTORSIM_OP_COPY: r.update (btorsim_bv_copy (x[0])); break;
+    case BTORSIM_OP_DEC: r.update (btorsim_bv_dec (x[0])); break;
+    case BTORSIM_OP_EQ: r.update_word (btorsim_bv_eq_p (x[0], x[1])); break;
+    case BTORSIM_OP_IMPLIES:
+      r.update (btorsim_bv_implies (x[0], x[1]));
+      break;
+    case BTORSIM_OP_INC: r.update (btorsim_bv_inc (x[0])); break;
+    case BTORSIM_OP_MUL: r.update (btorsim_bv_mul (x[0], x[1])); break;
+    case BTORSIM_OP_NAND: r.update (btorsim_bv_nand (x[0], x[1])); break;
+    case BTORSIM_OP_NEG: r.update (btorsim_bv_neg (x[0])); break;
+    case BTORSIM_OP_NEQ: r.update_word (btorsim_bv_neq_p (x[0], x[1])); break;
+    case BTORSIM_OP_NOR: r.update (btorsim_bv_nor (x[0], x[1])); break;
+    case BTORSIM_OP_NOT: r.update (btorsim_bv_not (x[0])); break;
+    case BTORSIM_OP_ONE: r.update (btorsim_bv_one (in->width)); break;
+    case BTORSIM_OP_ONES: r.update (btorsim_bv_ones (in->width)); break;
+    case BTORSIM_OP_OR: r.update (btorsim_bv_or (x[0], x[1])); break;
+    case BTORSIM_OP_REDAND: r.update_word (btorsim_bv_redand_p (x[0])); break;
+    case BTORSIM_OP_REDOR: r.update_word (btorsim_bv_redor_p (x[0])); break;
+    case BTORSIM_OP_REDXOR: r.update_word (btorsim_bv_redxor_p (x[0])); break;
+    case BTORSIM_OP_ROL: r.update (btorsim_bv_rol (x[0], x[1])); break;
+    case BTORSIM_OP_ROR: r.update (btorsim_bv_ror (x[0], x[1])); break;
+    case BTORSIM_OP_SDIV: r.update (btorsim_bv_sdiv (x[0], x[1])); break;
+    case BTORSIM_OP_SEXT:
+      r.update (btorsim_bv_sext (x[0], in->imm[0]));
+      break;
+    case BTORSIM_OP_SLICE:
+      r.update (btorsim_bv_slice (x[0], in->imm[0], in->imm[1]));
+      break;
+    case BTORSIM_OP_SLL: r.update (btorsim_bv_sll (x[0], x[1])); break;
+    case BTORSIM_OP_SLT: r.update_word (btorsim_bv_slt_p (x[0], x[1])); break;
+    case BTORSIM_OP_SLTE:
+      r.update_word (btorsim_bv_slte_p (x[0], x[1]));
+      break;
+    case BTORSIM_OP_SMOD: r.update (btorsim_bv_smod (x[0], x[1])); break;
+    case BTORSIM_OP_SRA: r.update (btorsim_bv_sra (x[0], x[1])); break;
+    case BTORSIM_OP_SREM: r.update (btorsim_bv_srem (x[0], x[1])); break;
+    case BTORSIM_OP_SRL: r.update (btorsim_bv_srl (x[0], x[1])); break;
+    case BTORSIM_OP_SUB: r.update (btorsim_bv_sub (x[0], x[1])); break;
+    case BTORSIM_OP_UDIV: r.update (btorsim_bv_udiv (x[0], x[1])); break;
+    case BTORSIM_OP_UEXT:
+      r.update (btorsim_bv_uext (x[0], in->imm[0]));
+      break;
+    case BTORSIM_OP_ULT: r.update_word (btorsim_bv_ult_p (x[0], x[1])); break;
+    case BTORSIM_OP_ULTE:
+      r.update_word (btorsim_bv_ulte_p (x[0], x[1]));
+      break;
+    case BTORSIM_OP_UREM: r.update (btorsim_bv_urem (x[0], x[1])); break;
+    case BTORSIM_OP_XNOR: r.update (btorsim_bv_xnor (x[0], x[1])); break;
+    case BTORSIM_OP_XOR: r.update (btorsim_bv_xor (x[0], x[1])); break;
+    case BTORSIM_OP_ZERO: r.update (btorsim_bv_zero (in->width)); break;
+    case BTORSIM_OP_AM_EQ:
+      r.update_word (equal_arrays (slots[in->args[0]].array_state,
+                                   slots[in->args[1]].array_state));
+      break;
+    case BTORSIM_OP_AM_NEQ:
+      r.update_word (!equal_arrays (slots[in->args[0]].array_state,
+                                    slots[in->args[1]].array_state));
+      break;
+    case BTORSIM_OP_READ: {
+      BtorSimBitVector *element = read_element (am, x[1]);
+      if (verbosity >= 4)
+      {
+        Btor2Line *mem = btor2parser_get_line_by_id (model, in->line->args[0]);
+        msg (4,
+             "read %s[%s] -> %s",
+             mem->symbol ? mem->symbol : std::to_string (mem->id).c_str (),
+             btorsim_bv_to_string (x[1]).c_str (),
+             btorsim_bv_to_string (element).c_str ());
+      }
+      r.update (element);
+    }
+    break;
+    case BTORSIM_OP_WRITE:
+      r.update (slots[in->args[0]].array_state->write (x[1], x[2]));
+      if (verbosity >= 4)
+      {
+        Btor2Line *mem = btor2parser_get_line_by_id (model, in->line->args[0]);
+        msg (4,
+             "write %s[%s] <- %s",
+             mem->symbol ? mem->symbol : std::to_string (mem->id).c_str (),
+             btorsim_bv_to_string (x[1]).c_str (),
+             btorsim_bv_to_string (x[2]).c_str ());
+      }
+      break;
+    default:
+      die ("can not randomly simulate operator '%s' at line %" PRId64,
+           in->line->name,
+           in->line->lineno);
+  }
+
+  for (uint32_t i = 0; i < in->nargs; i++)
+    if (tmp[i]) btorsim_bv_free (tmp[i]);
+}
+
+static void
+execute_instrs (Btor2Parser *model,
+                const BtorSimInstr *begin,
+                const BtorSimInstr *end,
+                std::vector<BtorSimState> &slots)
+{
+  for (const BtorSimInstr *in = begin; in < end; in++)
+  {
+    if (in->is_word)
+      execute_word (in, slots);
+    else
+      execute_generic (model, in, slots);
+  }
+}
+
+void
+BtorSimTape::execute_constants (std::vector<BtorSimState> &slots) const
+{
+  assert ((int64_t) slots.size () >= num_slots ());
+  execute_instrs (
+      model, constants.data (), constants.data () + constants.size (), slots);
+}
+
+void
+BtorSimTape::execute (std::vector<BtorSimState> &slots) const
+{
+  assert ((int64_t) slots.size () >= num_slots ());
+  execute_instrs (model, step.data (), step.data () + step.size (), slots);
+}
+
+void
+BtorSimTape::execute_init (int64_t id, std::vector<BtorSimState> &slots) const
+{
+  assert (0 <= id), assert (id < num_format_lines);
+  assert ((int64_t) slots.size () >= num_slots ());
+  execute_instrs (model,
+                  init.data () + init_begin[id],
+                  init.data () + init_end[id],
+                  slots);
+}
+
+size_t
+BtorSimTape::execute_incremental (std::vector<BtorSimState> &slots)
+{
+  assert ((int64_t) slots.size () >= num_slots ());
+
+  /* the first execution computes everything */
+  if (!primed)
+  {
+    execute (slots);
+    for (size_t k = 0; k < leaves.size (); k++)
+    {
+      BtorSimState &old = leaf_values[k];
+      if (old.type && old.is_set ()) old.remove ();
+      old = slots[leaves[k]].copy ();
+    }
+    primed = true;
+    return step.size ();
+  }
+
+  /* instructions are scheduled by index, since fan-outs have larger indices
+   * than their operands a single sweep computes them in topological order */
+  size_t first = step.size ();
+  auto schedule = [&] (int64_t s) {
+    for (size_t i : fanout[s])
+    {
+      scheduled[i] = true;
+      if (i < first) first = i;
+    }
+  };
+
+  for (size_t k = 0; k < leaves.size (); k++)
+  {
+    const BtorSimState &cur = slots[leaves[k]];
+    BtorSimState &old       = leaf_values[k];
+    assert (cur.is_set ());
+    /* arrays are not compared and always considered changed */
+    if (cur.type == BtorSimState::Type::BITVEC && old.equals (cur)) continue;
+    schedule (leaves[k]);
+    old.remove ();
+    old = cur.copy ();
+  }
+
+  size_t count = 0;
+  for (size_t i = first; i < step.size (); i++)
+  {
+    if (!scheduled[i]) continue;
+    scheduled[i]           = false;
+    const BtorSimInstr *in = &step[i];
+    count++;
+
+    BtorSimState &r = slots[in->res];
+    bool changed;
+    if (in->is_word)
+    {
+      uint64_t prev = r.bv_word;
+      bool was_set  = r.has_word;
+      execute_word (in, slots);
+      changed = !was_set || r.bv_word != prev;
+    }
+    else if (in->width_class == BTORSIM_WIDTH_ARRAY)
+    {
+      execute_generic (model, in, slots);
+      changed = true;
+    }
+    else
+    {
+      BtorSimState prev = r.copy ();
+      execute_generic (model, in, slots);
+      changed = !prev.is_set () || !prev.equals (r);
+      if (prev.is_set ()) prev.remove ();
+    }
+    if (changed) schedule (in->res);
+  }
+  return count;
+}
+
+void
+BtorSimTape::observe (int64_t id)
+{
+  if (id >= num_format_lines) return;
+  Btor2Line *l = btor2parser_get_line_by_id (model, id);
+  if (l && !is_skipped (l)) observed.push_back (id);
+}
+
+static bool
+is_short_circuit (const BtorSimInstr *in)
+{
+  if (in->width_class != BTORSIM_WIDTH_BOOL) return false;
+  return in->op == BTORSIM_OP_AND || in->op == BTORSIM_OP_OR
+         || in->op == BTORSIM_OP_IMPLIES;
+}
+
+/* Slots not computed by the step program are always available. */
+void
+BtorSimTape::reset_computed_at ()
+{
+  computed_at.resize (num_slots ());
+  for (int64_t s = 0; s < num_slots (); s++)
+    computed_at[s] = producer[s] < 0 ? UINT32_MAX : 0;
+}
+
+size_t
+BtorSimTape::execute_lazy (std::vector<BtorSimState> &slots)
+{
+  assert ((int64_t) slots.size () >= num_slots ());
+
+  if (++epoch == UINT32_MAX)
+  {
+    epoch = 1;
+    reset_computed_at ();
+  }
+  auto is_available = [&] (int64_t s) { return computed_at[s] >= epoch; };
+
+  /* demanded slots with the number of operands that were already demanded:
+   * for 'ite' and short-circuit operators first only the first operand, and
+   * then (depending on its value) the second or third one, otherwise all
+   * operands at once */
+  size_t count = 0;
+  std::vector<std::pair<int64_t, uint32_t>> stack;
+  for (size_t i = demanded.size () + observed.size (); i > 0; i--)
+  {
+    int64_t s = i > observed.size () ? demanded[i - observed.size () - 1]
+                                     : observed[i - 1];
+    stack.emplace_back (s, 0);
+  }
+  while (!stack.empty ())
+  {
+    int64_t s      = stack.back ().first;
+    uint32_t phase = stack.back ().second;
+    if (!phase && is_available (s))
+    {
+      stack.pop_back ();
+      continue;
+    }
+    const BtorSimInstr *in = &step[producer[s]];
+    bool is_ite = in->op == BTORSIM_OP_ITE || in->op == BTORSIM_OP_AM_ITE;
+    if (phase == 0 && (is_ite || is_short_circuit (in)))
+    {
+      stack.back ().second = 1;
+      if (!is_available (in->args[0])) stack.emplace_back (in->args[0], 0);
+      continue;
+    }
+    if (phase == 1)
+    {
+      uint64_t a = slots[in->args[0]].bv_word;
+      int64_t arg;
+      if (is_ite)
+        arg = in->args[(a & 1) ? 1 : 2];
+      else if (in->op == BTORSIM_OP_OR ? a : !a)
+      {
+        /* the first operand determines the result, which is 0 for 'and' and
+         * 1 for 'or' and 'implies' */
+        slots[s].update_word (in->op != BTORSIM_OP_AND);
+        computed_at[s] = epoch;
+        stack.pop_back ();
+        count++;
+        continue;
+      }
+      else
+        arg = in->args[1];
+      stack.back ().second = 2;
+      if (!is_available (arg)) stack.emplace_back (arg, 0);
+      continue;
+    }
+    if (phase == 0)
+    {
+      stack.back ().second = 2;
+      for (uint32_t i = in->nargs; i > 0; i--)
+        if (!is_available (in->args[i - 1]))
+          stack.emplace_back (in->args[i - 1], 0);
+      continue;
+    }
+    stack.pop_back ();
+    if (in->is_word)
+      execute_word (in, slots);
+    else
+      execute_generic (model, in, slots);
+    computed_at[s] = epoch;
+    count++;
+  }
+  return count;
+}
+
+bool
+BtorSimTape::supports_lanes () const
+{
+  for (const BtorSimInstr &in : step)
+    if (!in.is_word) return false;
+  return true;
+}
+
+void
+BtorSimTape::load_lanes (const std::vector<BtorSimState> &slots,
+                         std::vector<uint64_t> &vals,
+                         size_t n) const
+{
+  assert (vals.size () >= num_slots () * n);
+  for (const BtorSimInstr &in : constants)
+  {
+    const BtorSimState &c = slots[in.res];
+    /* wide constants can only be operands of other constants */
+    if (!c.is_word ()) continue;
+    assert (c.is_set ());
+    for (size_t l = 0; l < n; l++) vals[in.res * n + l] = c.bv_word;
+  }
+}
+
+void
+BtorSimTape::execute_lanes (std::vector<uint64_t> &vals, size_t n) const
+{
+  assert (vals.size () >= num_slots () * n);
+  for (const BtorSimInstr &in : step)
+  {
+    assert (in.is_word);
+    uint64_t *r       = vals.data () + in.res * n;
+    const uint64_t *a = vals.data () + in.args[0] * n;
+    const uint64_t *b = vals.data () + in.args[1] * n;
+    const uint64_t *c = vals.data () + in.args[2] * n;
+    uint32_t width    = in.width;
+    switch (in.op)
+    {
+      case BTORSIM_OP_ADD: btorsim_bv_batch_add (width, n, a, b, r); break;
+      case BTORSIM_OP_AND: btorsim_bv_batch_and (width, n, a, b, r); break;
+      case BTORSIM_OP_EQ: btorsim_bv_batch_eq (in.arg_width, n, a, b, r); break;
+      case BTORSIM_OP_ITE: btorsim_bv_batch_ite (width, n, a, b, c, r); break;
+      case BTORSIM_OP_MUL: btorsim_bv_batch_mul (width, n, a, b, r); break;
+      case BTORSIM_OP_NEG: btorsim_bv_batch_neg (width, n, a, r); break;
+      case BTORSIM_OP_NOT: btorsim_bv_batch_not (width, n, a, r); break;
+      case BTORSIM_OP_OR: btorsim_bv_batch_or (width, n, a, b, r); break;
+      case BTORSIM_OP_SUB: btorsim_bv_batch_sub (width, n, a, b, r); break;
+      case BTORSIM_OP_ULT:
+        btorsim_bv_batch_ult (in.arg_width, n, a, b, r);
+        break;
+      case BTORSIM_OP_XOR: btorsim_bv_batch_xor (width, n, a, b, r); break;
+      case BTORSIM_OP_COPY:
+      case BTORSIM_OP_UEXT:
+        for (size_t l = 0; l < n; l++) r[l] = a[l];
+        break;
+      case BTORSIM_OP_CONCAT: {
+        uint32_t shift = width - in.arg_width;
+        for (size_t l = 0; l < n; l++) r[l] = (a[l] << shift) | b[l];
+      }
+      break;
+      case BTORSIM_OP_NEQ:
+        for (size_t l = 0; l < n; l++) r[l] = a[l] != b[l];
+        break;
+      case BTORSIM_OP_SLICE: {
+        uint32_t shift = in.imm[1];
+        uint64_t mask  = word_mask (width);
+        for (size_t l = 0; l < n; l++) r[l] = (a[l] >> shift) & mask;
+      }
+      break;
+      case BTORSIM_OP_ULTE:
+        for (size_t l = 0; l < n; l++) r[l] = a[l] <= b[l];
+        break;
+      default:
+        for (size_t l = 0; l < n; l++)
+          r[l] = eval_word (&in, a[l], b[l], c[l]);
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+static bool
+is_array_instr (const BtorSimInstr &in)
+{
+  switch (in.op)
+  {
+    case BTORSIM_OP_AM_EQ:
+    case BTORSIM_OP_AM_ITE:
+    case BTORSIM_OP_AM_NEQ:
+    case BTORSIM_OP_READ:
+    case BTORSIM_OP_WRITE: return true;
+    default: return in.width_class == BTORSIM_WIDTH_ARRAY;
+  }
+}
+
+bool
+BtorSimTape::supports_ternary () const
+{
+  for (const std::vector<BtorSimInstr> *prog : {&constants, &step, &init})
+    for (const BtorSimInstr &in : *prog)
+      if (is_array_instr (in)) return false;
+  return true;
+}
+
+void
+BtorSimTape::load_ternary (const std::vector<BtorSimState> &slots,
+                           std::vector<BtorSimXBitVector> &vals) const
+{
+  assert ((int64_t) vals.size () >= num_slots ());
+  for (const BtorSimInstr &in : constants)
+  {
+    const BtorSimState &c = slots[in.res];
+    assert (c.is_set ());
+    BtorSimXBitVector &r = vals[in.res];
+    if (r.value) btorsim_xbv_free (&r);
+    if (c.is_word ())
+    {
+      BtorSimBitVector *bv = c.copy_bv ();
+      r                    = btorsim_xbv_from_bv (bv);
+      btorsim_bv_free (bv);
+    }
+    else
+      r = btorsim_xbv_from_bv (c.bv_state);
+  }
+}
+
+static void
+execute_ternary_instr (const BtorSimInstr *in,
+                       std::vector<BtorSimXBitVector> &vals)
+{
+  if (in->op == BTORSIM_OP_LEAF) return;
+
+  const BtorSimXBitVector *x = &vals[in->args[0]];
+  const BtorSimXBitVector *y = &vals[in->args[1]];
+  BtorSimXBitVector res;
+  switch (in->op)
+  {
+    case BTORSIM_OP_ADD: res = btorsim_xbv_add (x, y); break;
+    case BTORSIM_OP_AND: res = btorsim_xbv_and (x, y); break;
+    case BTORSIM_OP_CONCAT: res = btorsim_xbv_concat (x, y); break;
+    case BTORSIM_OP_COPY: res = btorsim_xbv_copy (x); break;
+    case BTORSIM_OP_DEC: res = btorsim_xbv_dec (x); break;
+    case BTORSIM_OP_EQ: res = btorsim_xbv_eq (x, y); break;
+    case BTORSIM_OP_IMPLIES: res = btorsim_xbv_implies (x, y); break;
+    case BTORSIM_OP_INC: res = btorsim_xbv_inc (x); break;
+    case BTORSIM_OP_ITE:
+      res = btorsim_xbv_ite (x, y, &vals[in->args[2]]);
+      break;
+    case BTORSIM_OP_MUL: res = btorsim_xbv_mul (x, y); break;
+    case BTORSIM_OP_NAND: res = btorsim_xbv_nand (x, y); break;
+    case BTORSIM_OP_NEG: res = btorsim_xbv_neg (x); break;
+    case BTORSIM_OP_NEQ: res = btorsim_xbv_neq (x, y); break;
+    case BTORSIM_OP_NOR: res = btorsim_xbv_nor (x, y); break;
+    case BTORSIM_OP_NOT: res = btorsim_xbv_not (x); break;
+    case BTORSIM_OP_OR: res = btorsim_xbv_or (x, y); break;
+    case BTORSIM_OP_REDAND: res = btorsim_xbv_redand (x); break;
+    case BTORSIM_OP_REDOR: res = btorsim_xbv_redor (x); break;
+    case BTORSIM_OP_REDXOR: res = btorsim_xbv_redxor (x); break;
+    case BTORSIM_OP_ROL: res = btorsim_xbv_rol (x, y); break;
+    case BTORSIM_OP_ROR: res = btorsim_xbv_ror (x, y); break;
+    case BTORSIM_OP_SDIV: res = btorsim_xbv_sdiv (x, y); break;
+    case BTORSIM_OP_SEXT: res = btorsim_xbv_sext (x, in->imm[0]); break;
+    case BTORSIM_OP_SLICE:
+      res = btorsim_xbv_slice (x, in->imm[0], in->imm[1]);
+      break;
+    case BTORSIM_OP_SLL: res = btorsim_xbv_sll (x, y); break;
+    case BTORSIM_OP_SLT: res = btorsim_xbv_slt (x, y); break;
+    case BTORSIM_OP_SLTE: res = btorsim_xbv_slte (x, y); break;
+    case BTORSIM_OP_SMOD: res = btorsim_xbv_smod (x, y); break;
+    case BTORSIM_OP_SRA: res = btorsim_xbv_sra (x, y); break;
+    case BTORSIM_OP_SREM: res = btorsim_xbv_srem (x, y); break;
+    case BTORSIM_OP_SRL: res = btorsim_xbv_srl (x, y); break;
+    case BTORSIM_OP_SUB: res = btorsim_xbv_sub (x, y); break;
+    case BTORSIM_OP_UDIV: res = btorsim_xbv_udiv (x, y); break;
+    case BTORSIM_OP_UEXT: res = btorsim_xbv_uext (x, in->imm[0]); break;
+    case BTORSIM_OP_ULT: res = btorsim_xbv_ult (x, y); break;
+    case BTORSIM_OP_ULTE: res = btorsim_xbv_ulte (x, y); break;
+    case BTORSIM_OP_UREM: res = btorsim_xbv_urem (x, y); break;
+    case BTORSIM_OP_XNOR: res = btorsim_xbv_xnor (x, y); break;
+    case BTORSIM_OP_XOR: res = btorsim_xbv_xor (x, y); break;
+    default:
+      /* constants are loaded by 'load_ternary' and arrays not supported */
+      die ("can not simulate operator '%s' at line %" PRId64 " in ternary mode",
+           in->line->name,
+           in->line->lineno);
+  }
+  BtorSimXBitVector &r = vals[in->res];
+  if (r.value) btorsim_xbv_free (&r);
+  r = res;
+}
+
+void
+BtorSimTape::execute_ternary (std::vector<BtorSimXBitVector> &vals) const
+{
+  assert ((int64_t) vals.size () >= num_slots ());
+  for (const BtorSimInstr &in : step) execute_ternary_instr (&in, vals);
+}
+
+void
+BtorSimTape::execute_init_ternary (int64_t id,
+                                   std::vector<BtorSimXBitVector> &vals) const
+{
+  assert (0 <= id), assert (id < num_format_lines);
+  assert ((int64_t) vals.size () >= num_slots ());
+  for (size_t i = init_begin[id]; i < init_end[id]; i++)
+    execute_ternary_instr (&init[i], vals);
+}
+
+/*------------------------------------------------------------------------*/
+
+/* Word kernels of 'eval_word' in C, with the same names and semantics, for
+ * the operators that are not emitted as plain C expressions. */
+static const char *native_prelude =
+    "#include <stdint.h>\n"
+    "\n"
+    "static inline uint64_t\n"
+    "word_mask (uint32_t width)\n"
+    "{\n"
+    "  return width == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << width) - 1;\n"
+    "}\n"
+    "\n"
+    "static inline int64_t\n"
+    "word_signed (uint64_t a, uint32_t width)\n"
+    "{\n"
+    "  return (int64_t) (a << (64 - width)) >> (64 - width);\n"
+    "}\n"
+    "\n"
+    "static inline uint64_t\n"
+    "word_udiv (uint64_t a, uint64_t b, uint64_t mask)\n"
+    "{\n"
+    "  return b ? a / b : mask;\n"
+    "}\n"
+    "\n"
+    "static inline uint64_t\n"
+    "word_urem (uint64_t a, uint64_t b)\n"
+    "{\n"
+    "  return b ? a % b : a;\n"
+    "}\n"
+    "\n"
+    "static inline uint64_t\n"
+    "word_srl (uint64_t a, uint64_t b, uint32_t width)\n"
+    "{\n"
+    "  return b >= width ? 0 : a >> b;\n"
+    "}\n"
+    "\n"
+    "static inline uint64_t\n"
+    "word_sll (uint64_t a, uint64_t b, uint32_t width)\n"
+    "{\n"
+    "  return b >= width ? 0 : (a << b) & word_mask (width);\n"
+    "}\n"
+    "\n"
+    "static inline uint64_t\n"
+    "word_rol (uint64_t a, uint64_t b, uint32_t width)\n"
+    "{\n"
+    "  if (b > width) return 0;\n"
+    "  if (b == width || !b) return a;\n"
+    "  return ((a << b) | (a >> (width - b))) & word_mask (width);\n"
+    "}\n"
+    "\n"
+    "static inline uint64_t\n"
+    "word_ror (uint64_t a, uint64_t b, uint32_t width)\n"
+    "{\n"
+    "  return b > width ? 0 : word_rol (a, b ? width - b : 0, width);\n"
+    "}\n"
+    "\n"
+    "static inline uint64_t\n"
+    "word_sra (uint64_t a, uint64_t b, uint32_t width)\n"
+    "{\n"
+    "  uint64_t mask = word_mask (width);\n"
+    "  if ((a >> (width - 1)) & 1)\n"
+    "    return ~word_srl (~a & mask, b, width) & mask;\n"
+    "  return word_srl (a, b, width);\n"
+    "}\n"
+    "\n"
+    "static inline uint64_t\n"
+    "word_sdiv (uint64_t a, uint64_t b, uint32_t width)\n"
+    "{\n"
+    "  uint64_t mask = word_mask (width);\n"
+    "  if (width == 1) return (a | ~b) & 1;\n"
+    "  int sa = (a >> (width - 1)) & 1, sb = (b >> (width - 1)) & 1;\n"
+    "  uint64_t ua  = sa ? (~a + 1) & mask : a;\n"
+    "  uint64_t ub  = sb ? (~b + 1) & mask : b;\n"
+    "  uint64_t res = word_udiv (ua, ub, mask);\n"
+    "  return sa != sb ? (~res + 1) & mask : res;\n"
+    "}\n"
+    "\n"
+    "static inline uint64_t\n"
+    "word_smod (uint64_t a, uint64_t b, uint32_t width)\n"
+    "{\n"
+    "  uint64_t mask = word_mask (width);\n"
+    "  if (width == 1) return a & ~b;\n"
+    "  int sa = (a >> (width - 1)) & 1, sb = (b >> (width - 1)) & 1;\n"
+    "  uint64_t ua = sa ? (~a + 1) & mask : a;\n"
+    "  uint64_t ub = sb ? (~b + 1) & mask : b;\n"
+    "  uint64_t u  = word_urem (ua, ub);\n"
+    "  uint64_t d  = u ? b : 0;\n"
+    "  if (!sa && !sb) return u;\n"
+    "  if (sa && !sb) return (~u + 1 + d) & mask;\n"
+    "  if (!sa && sb) return (u + d) & mask;\n"
+    "  return (~u + 1) & mask;\n"
+    "}\n"
+    "\n"
+    "static inline uint64_t\n"
+    "word_srem (uint64_t a, uint64_t b, uint32_t width)\n"
+    "{\n"
+    "  uint64_t mask = word_mask (width);\n"
+    "  if (width == 1) return a & ~b;\n"
+    "  int sa = (a >> (width - 1)) & 1, sb = (b >> (width - 1)) & 1;\n"
+    "  uint64_t ua  = sa ? (~a + 1) & mask : a;\n"
+    "  uint64_t ub  = sb ? (~b + 1) & mask : b;\n"
+    "  uint64_t res = word_urem (ua, ub);\n"
+    "  return sa ? (~res + 1) & mask : res;\n"
+    "}\n"
+    "\n";
+
+static std::string
+native_var (int64_t s)
+{
+  return "v" + std::to_string (s);
+}
+
+/* Append the C expression computing the result of word instruction 'in'
+ * from the variables of its operands to 'src'. */
+static void
+append_native_expr (const BtorSimInstr *in, std::string &src)
+{
+  std::string a  = native_var (in->args[0]);
+  std::string b  = native_var (in->args[1]);
+  std::string c  = native_var (in->args[2]);
+  std::string w  = std::to_string (in->width);
+  std::string aw = std::to_string (in->arg_width);
+  char buf[32];
+  snprintf (buf, sizeof buf, "UINT64_C (0x%" PRIx64 ")", word_mask (in->width));
+  std::string m = buf;
+  switch (in->op)
+  {
+    case BTORSIM_OP_ADD: src += "(" + a + " + " + b + ") & " + m; break;
+    case BTORSIM_OP_AND: src += a + " & " + b; break;
+    case BTORSIM_OP_CONCAT:
+      src += "(" + a + " << " + std::to_string (in->width - in->arg_width)
+             + ") | " + b;
+      break;
+    case BTORSIM_OP_COPY:
+    case BTORSIM_OP_UEXT: src += a; break;
+    case BTORSIM_OP_DEC: src += "(" + a + " - 1) & " + m; break;
+    case BTORSIM_OP_EQ: src += a + " == " + b; break;
+    case BTORSIM_OP_IMPLIES: src += "(~" + a + " | " + b + ") & " + m; break;
+    case BTORSIM_OP_INC: src += "(" + a + " + 1) & " + m; break;
+    case BTORSIM_OP_ITE: src += "(" + a + " & 1) ? " + b + " : " + c; break;
+    case BTORSIM_OP_MUL: src += "(" + a + " * " + b + ") & " + m; break;
+    case BTORSIM_OP_NAND: src += "~(" + a + " & " + b + ") & " + m; break;
+    case BTORSIM_OP_NEG: src += "(~" + a + " + 1) & " + m; break;
+    case BTORSIM_OP_NEQ: src += a + " != " + b; break;
+    case BTORSIM_OP_NOR: src += "~(" + a + " | " + b + ") & " + m; break;
+    case BTORSIM_OP_NOT: src += "~" + a + " & " + m; break;
+    case BTORSIM_OP_ONE: src += "1"; break;
+    case BTORSIM_OP_ONES: src += m; break;
+    case BTORSIM_OP_OR: src += a + " | " + b; break;
+    case BTORSIM_OP_REDAND: src += a + " == word_mask (" + aw + ")"; break;
+    case BTORSIM_OP_REDOR: src += a + " != 0"; break;
+    case BTORSIM_OP_REDXOR: src += "__builtin_parityll (" + a + ")"; break;
+    case BTORSIM_OP_ROL:
+      src += "word_rol (" + a + ", " + b + ", " + w + ")";
+      break;
+    case BTORSIM_OP_ROR:
+      src += "word_ror (" + a + ", " + b + ", " + w + ")";
+      break;
+    case BTORSIM_OP_SDIV:
+      src += "word_sdiv (" + a + ", " + b + ", " + w + ")";
+      break;
+    case BTORSIM_OP_SEXT:
+      src += "word_signed (" + a + ", " + aw + ") & " + m;
+      break;
+    case BTORSIM_OP_SLICE:
+      src += "(" + a + " >> " + std::to_string (in->imm[1]) + ") & " + m;
+      break;
+    case BTORSIM_OP_SLL:
+      src += "word_sll (" + a + ", " + b + ", " + w + ")";
+      break;
+    case BTORSIM_OP_SLT:
+      src += "word_signed (" + a + ", " + aw + ") < word_signed (" + b + ", "
+             + aw + ")";
+      break;
+    case BTORSIM_OP_SLTE:
+      src += "word_signed (" + a + ", " + aw + ") <= word_signed (" + b
+             + ", " + aw + ")";
+      break;
+    case BTORSIM_OP_SMOD:
+      src += "word_smod (" + a + ", " + b + ", " + w + ")";
+      break;
+    case BTORSIM_OP_SRA:
+      src += "word_sra (" + a + ", " + b + ", " + w + ")";
+      break;
+    case BTORSIM_OP_SREM:
+      src += "word_srem (" + a + ", " + b + ", " + w + ")";
+      break;
+    case BTORSIM_OP_SRL:
+      src += "word_srl (" + a + ", " + b + ", " + w + ")";
+      break;
+    case BTORSIM_OP_SUB: src += "(" + a + " - " + b + ") & " + m; break;
+    case BTORSIM_OP_UDIV:
+      src += "word_udiv (" + a + ", " + b + ", " + m + ")";
+      break;
+    case BTORSIM_OP_ULT: src += a + " < " + b; break;
+    case BTORSIM_OP_ULTE: src += a + " <= " + b; break;
+    case BTORSIM_OP_UREM: src += "word_urem (" + a + ", " + b + ")"; break;
+    case BTORSIM_OP_XNOR: src += "~(" + a + " ^ " + b + ") & " + m; break;
+    case BTORSIM_OP_XOR: src += a + " ^ " + b; break;
+    case BTORSIM_OP_ZERO: src += "0"; break;
+    default:
+      die ("can not compile operator '%s' at line %" PRId64,
+           in->line->name,
+           in->line->lineno);
+  }
+}
+
+void
+BtorSimTape::emit_native (const std::vector<BtorSimState> &slots,
+                          std::string &src)
+{
+  assert ((int64_t) slots.size () >= num_slots ());
+
+  /* results of word instructions that are read by generic instructions or
+   * demanded after executing the step program are stored in 'words' */
+  std::vector<bool> is_stored (num_slots (), false);
+  for (const BtorSimInstr &in : step)
+    if (!in.is_word)
+      for (uint32_t i = 0; i < in.nargs; i++) is_stored[in.args[i]] = true;
+  native_outputs.clear ();
+  std::vector<bool> is_output (num_slots (), false);
+  auto add_output = [&] (int64_t s) {
+    if (producer[s] < 0 || !step[producer[s]].is_word || is_output[s]) return;
+    is_output[s] = is_stored[s] = true;
+    native_outputs.push_back (s);
+  };
+  for (int64_t s : demanded) add_output (s);
+  for (int64_t id : observed) add_output (id);
+
+  src += native_prelude;
+  src +=
+      "void\n"
+      "btorsim_native_step (uint64_t *words,\n"
+      "                     void (*generic) (void *, uint32_t),\n"
+      "                     void *ctx)\n"
+      "{\n";
+  /* variables are declared before their first use, as literals (constants),
+   * loaded from 'words' (inputs, states and results of generic
+   * instructions), or computed by word instructions */
+  std::vector<bool> declared (num_slots (), false);
+  native_inputs.clear ();
+  auto load = [&] (int64_t s) {
+    src += "  const uint64_t " + native_var (s) + " = words["
+           + std::to_string (s) + "];\n";
+    declared[s] = true;
+  };
+  for (size_t i = 0; i < step.size (); i++)
+  {
+    const BtorSimInstr &in = step[i];
+    if (!in.is_word)
+    {
+      src += "  generic (ctx, " + std::to_string (i) + ");\n";
+      if (slots[in.res].is_word ()) load (in.res);
+      continue;
+    }
+    for (uint32_t j = 0; j < in.nargs; j++)
+    {
+      int64_t a = in.args[j];
+      if (declared[a]) continue;
+      if (is_constant[a])
+      {
+        assert (slots[a].is_word ()), assert (slots[a].is_set ());
+        char buf[32];
+        snprintf (
+            buf, sizeof buf, "UINT64_C (0x%" PRIx64 ")", slots[a].bv_word);
+        src += "  const uint64_t " + native_var (a) + " = " + buf + ";\n";
+        declared[a] = true;
+      }
+      else
+      {
+        assert (producer[a] < 0);
+        native_inputs.push_back (a);
+        load (a);
+      }
+    }
+    src += "  const uint64_t " + native_var (in.res) + " = ";
+    append_native_expr (&in, src);
+    src += ";\n";
+    declared[in.res] = true;
+    if (is_stored[in.res])
+      src += "  words[" + std::to_string (in.res) + "] = " + native_var (in.res)
+             + ";\n";
+  }
+  src += "}\n";
+}
+
+void
+BtorSimTape::set_native (BtorSimNativeStep fn)
+{
+  assert (fn);
+  native = fn;
+  native_words.assign (num_slots (), 0);
+}
+
+/* Execute generic instruction 'i' of the step program of 'tape', the values
+ * of its word operands computed by native code are in 'native_words'. */
+void
+BtorSimTape::execute_native_generic (void *tape, uint32_t i)
+{
+  BtorSimTape *t                   = static_cast<BtorSimTape *> (tape);
+  std::vector<BtorSimState> &slots = *t->native_slots;
+  const BtorSimInstr *in           = &t->step[i];
+  assert (!in->is_word);
+  for (uint32_t j = 0; j < in->nargs; j++)
+  {
+    int64_t a = in->args[j];
+    if (t->producer[a] >= 0 && t->step[t->producer[a]].is_word)
+      slots[a].update_word (t->native_words[a]);
+  }
+  execute_generic (t->model, in, slots);
+  BtorSimState &r = slots[in->res];
+  if (r.is_word ()) t->native_words[in->res] = r.bv_word;
+}
+
+void
+BtorSimTape::execute_native (std::vector<BtorSimState> &slots)
+{
+  assert (native);
+  assert ((int64_t) slots.size () >= num_slots ());
+  for (int64_t s : native_inputs)
+  {
+    assert (slots[s].is_word () && slots[s].has_word);
+    native_words[s] = slots[s].bv_word;
+  }
+  native_slots = &slots;
+  native (native_words.data (), execute_native_generic, this);
+  native_slots = nullptr;
+  for (int64_t s : native_outputs) slots[s].update_word (native_words[s]);
+}
+
+/*------------------------------------------------------------------------*/
+
+/* Estimated cost of evaluating instruction 'in' relative to a word
+ * instruction, 0 for instructions that have to be evaluated serially. */
+static size_t
+parallel_cost (const BtorSimInstr *in)
+{
+  if (in->width_class == BTORSIM_WIDTH_ARRAY || in->op == BTORSIM_OP_READ
+      || in->op == BTORSIM_OP_AM_EQ || in->op == BTORSIM_OP_AM_NEQ)
+    return 0;
+  if (in->is_word) return 1;
+  return 8 + in->width / 16;
+}
+
+/* Levels are only evaluated in parallel if every thread gets at least this
+ * much work (in word instructions), which amortizes the barrier. */
+#define BTORSIM_PARALLEL_MIN_COST 1024
+/* Threads claim chunks of at least this many instructions, and there are
+ * about this many chunks per thread for balancing. */
+#define BTORSIM_PARALLEL_MIN_CHUNK 128
+#define BTORSIM_PARALLEL_CHUNKS_PER_THREAD 8
+
+void
+BtorSimTape::levelize (uint32_t num_threads)
+{
+  std::vector<uint32_t> level (num_slots (), 0);
+  std::vector<std::vector<size_t>> by_level;
+  for (size_t i = 0; i < step.size (); i++)
+  {
+    const BtorSimInstr &in = step[i];
+    uint32_t l             = 0;
+    for (uint32_t j = 0; j < in.nargs; j++)
+      if (level[in.args[j]] > l) l = level[in.args[j]];
+    level[in.res] = l + 1;
+    if (by_level.size () <= l) by_level.resize (l + 1);
+    by_level[l].push_back (i);
+  }
+
+  levelized.clear ();
+  phases.clear ();
+  Phase serial        = {0, 0, 0, 0};
+  num_parallel_levels = 0;
+  for (const std::vector<size_t> &instrs : by_level)
+  {
+    size_t cost = 0;
+    for (size_t i : instrs) cost += parallel_cost (&step[i]);
+    if (num_threads < 2 || cost < BTORSIM_PARALLEL_MIN_COST * num_threads)
+    {
+      for (size_t i : instrs) levelized.push_back (step[i]);
+      continue;
+    }
+    serial.end = serial.serial_end = levelized.size ();
+    if (serial.end > serial.begin) phases.push_back (serial);
+    Phase p = {levelized.size (), 0, 0, 0};
+    for (size_t i : instrs)
+      if (!parallel_cost (&step[i])) levelized.push_back (step[i]);
+    p.serial_end = levelized.size ();
+    for (size_t i : instrs)
+      if (parallel_cost (&step[i])) levelized.push_back (step[i]);
+    p.end   = levelized.size ();
+    p.chunk = (p.end - p.serial_end)
+              / (num_threads * BTORSIM_PARALLEL_CHUNKS_PER_THREAD);
+    if (p.chunk < BTORSIM_PARALLEL_MIN_CHUNK)
+      p.chunk = BTORSIM_PARALLEL_MIN_CHUNK;
+    phases.push_back (p);
+    num_parallel_levels++;
+    serial.begin = levelized.size ();
+  }
+  serial.end = serial.serial_end = levelized.size ();
+  if (serial.end > serial.begin) phases.push_back (serial);
+  assert (levelized.size () == step.size ());
+
+  next_chunk.reset (new std::atomic<size_t>[phases.size ()]);
+  levelized_threads = num_threads;
+  msg (1,
+       "levelized %zu instructions into %zu levels, %zu of them evaluated "
+       "in parallel",
+       step.size (),
+       by_level.size (),
+       num_parallel_levels);
+}
+
+void
+BtorSimTape::execute_parallel (std::vector<BtorSimState> &slots,
+                               BtorSimThreadPool &pool)
+{
+  assert ((int64_t) slots.size () >= num_slots ());
+  if (levelized_threads != pool.size ()) levelize (pool.size ());
+  if (!num_parallel_levels)
+  {
+    execute (slots);
+    return;
+  }
+  for (size_t p = 0; p < phases.size (); p++)
+    next_chunk[p].store (phases[p].serial_end, std::memory_order_relaxed);
+
+  const BtorSimInstr *instrs = levelized.data ();
+  pool.run ([&] (uint32_t t) {
+    for (size_t p = 0; p < phases.size (); p++)
+    {
+      const Phase &phase = phases[p];
+      if (!t)
+        execute_instrs (
+            model, instrs + phase.begin, instrs + phase.serial_end, slots);
+      for (;;)
+      {
+        size_t begin = next_chunk[p].fetch_add (phase.chunk);
+        if (begin >= phase.end) break;
+        size_t end = begin + phase.chunk;
+        if (end > phase.end) end = phase.end;
+        execute_instrs (model, instrs + begin, instrs + end, slots);
+      }
+      /* returning from 'run' synchronizes after the last phase */
+      if (p + 1 < phases.size ()) pool.barrier ();
+    }
+  });
+}
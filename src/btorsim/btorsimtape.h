@@ -0,0 +1,289 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#ifndef BTOR2TAPE_H_INCLUDED
+#define BTOR2TAPE_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "btor2parser/btor2parser.h"
+#include "btorsimnative.h"
+#include "btorsimstate.h"
+#include "btorsimthreads.h"
+#include "btorsimxbv.h"
+
+/* Opcodes of tape instructions.  Operators that only differ from another
+ * operator by the order of their operands (e.g. 'ugt' and 'ult') are mapped
+ * to the same opcode, and polymorphic operators get separate opcodes for
+ * arrays. */
+enum BtorSimOp
+{
+  BTORSIM_OP_ADD,
+  BTORSIM_OP_AND,
+  BTORSIM_OP_CONCAT,
+  BTORSIM_OP_CONST,
+  BTORSIM_OP_CONSTD,
+  BTORSIM_OP_CONSTH,
+  BTORSIM_OP_COPY,
+  BTORSIM_OP_DEC,
+  BTORSIM_OP_EQ,
+  BTORSIM_OP_IMPLIES,
+  BTORSIM_OP_INC,
+  BTORSIM_OP_ITE,
+  BTORSIM_OP_MUL,
+  BTORSIM_OP_NAND,
+  BTORSIM_OP_NEG,
+  BTORSIM_OP_NEQ,
+  BTORSIM_OP_NOR,
+  BTORSIM_OP_NOT,
+  BTORSIM_OP_ONE,
+  BTORSIM_OP_ONES,
+  BTORSIM_OP_OR,
+  BTORSIM_OP_REDAND,
+  BTORSIM_OP_REDOR,
+  BTORSIM_OP_REDXOR,
+  BTORSIM_OP_ROL,
+  BTORSIM_OP_ROR,
+  BTORSIM_OP_SDIV,
+  BTORSIM_OP_SEXT,
+  BTORSIM_OP_SLICE,
+  BTORSIM_OP_SLL,
+  BTORSIM_OP_SLT,
+  BTORSIM_OP_SLTE,
+  BTORSIM_OP_SMOD,
+  BTORSIM_OP_SRA,
+  BTORSIM_OP_SREM,
+  BTORSIM_OP_SRL,
+  BTORSIM_OP_SUB,
+  BTORSIM_OP_UDIV,
+  BTORSIM_OP_UEXT,
+  BTORSIM_OP_ULT,
+  BTORSIM_OP_ULTE,
+  BTORSIM_OP_UREM,
+  BTORSIM_OP_XNOR,
+  BTORSIM_OP_XOR,
+  BTORSIM_OP_ZERO,
+  BTORSIM_OP_AM_EQ,
+  BTORSIM_OP_AM_ITE,
+  BTORSIM_OP_AM_NEQ,
+  BTORSIM_OP_READ,
+  BTORSIM_OP_WRITE,
+  /* check that an input or state is set (only in init programs) */
+  BTORSIM_OP_LEAF,
+};
+
+/* Width class of the result of an instruction, values of class 'bool' and
+ * 'word' are stored inline in their slots. */
+enum BtorSimWidthClass
+{
+  BTORSIM_WIDTH_BOOL,  /* 1 bit */
+  BTORSIM_WIDTH_WORD,  /* up to 64 bits */
+  BTORSIM_WIDTH_WIDE,  /* more than 64 bits */
+  BTORSIM_WIDTH_ARRAY, /* array */
+};
+
+struct BtorSimInstr
+{
+  BtorSimOp op;
+  BtorSimWidthClass width_class;
+  /* result and all operands are bit-vectors stored inline */
+  bool is_word;
+  uint32_t nargs;
+  uint32_t width;     /* result width, element width for arrays */
+  uint32_t arg_width; /* width of the first operand */
+  uint32_t imm[2];    /* 'slice' upper and lower bit, extension padding */
+  int64_t res;        /* result slot */
+  int64_t args[3];    /* operand slots */
+  Btor2Line *line;    /* originating line (operand line for negations) */
+};
+
+/* A model compiled into a flat list of instructions in topological order,
+ * which is evaluated without recursion on a vector of value slots.
+ *
+ * Slot 'i < num_lines ()' holds the value of the line with id 'i', negated
+ * operands get additional slots after these.  Inputs and states are not
+ * computed by the tape, their slots have to be set before executing it.
+ * Computed slots keep their value until overwritten by the next execution.
+ * Nodes that depend on neither inputs nor states are hoisted into a separate
+ * program, which is executed only once by 'execute_constants'.
+ * Instructions on bit-vectors that are stored inline are evaluated by word
+ * kernels without going through 'BtorSimBitVector'.
+ */
+class BtorSimTape
+{
+ public:
+  void compile (Btor2Parser *model);
+
+  int64_t num_lines () const { return num_format_lines; }
+  int64_t num_slots () const { return num_format_lines + negated.size (); }
+  size_t size () const { return step.size (); }
+  size_t num_constants () const { return constants.size (); }
+
+  /* slot holding the value of argument 'arg', negative for negated ids */
+  int64_t slot (int64_t arg) const;
+  /* bit-width of the value of slot 's', 0 for arrays */
+  uint32_t slot_width (int64_t s) const;
+
+  /* restrict the step program to the cone of influence of the lines 'roots'
+   * (e.g. bad, constraint or state ids), which includes the next functions
+   * of all states in the cone */
+  void prune (const std::vector<int64_t> &roots);
+  /* whether line 'id' is computed by the (pruned) step program */
+  bool in_coi (int64_t id) const { return coi.empty () || coi[id]; }
+
+  /* compute all constant nodes, has to be called once before executing the
+   * step or init programs */
+  void execute_constants (std::vector<BtorSimState> &slots) const;
+  /* compute all non-constant nodes of the model */
+  void execute (std::vector<BtorSimState> &slots) const;
+  /* event-driven variant of 'execute', which only computes the nodes in the
+   * fan-out of inputs and states that changed since its last call (and only
+   * as long as results change), returns the number of computed nodes */
+  size_t execute_incremental (std::vector<BtorSimState> &slots);
+  /* demand-driven variant of 'execute', which only computes the nodes
+   * needed for next functions, properties and observed lines, evaluates
+   * only the selected branch of 'ite' and short-circuits 1-bit 'and', 'or'
+   * and 'implies', returns the number of computed nodes */
+  size_t execute_lazy (std::vector<BtorSimState> &slots);
+  /* demand the value of line 'id' in 'execute_lazy' */
+  void observe (int64_t id);
+
+  /* Multi-lane execution of the step program on 'n' independent sets of
+   * values, which requires that all its instructions are word instructions.
+   * The value of slot 's' in lane 'l' is 'vals[s * n + l]'. */
+  bool supports_lanes () const;
+  /* copy the values of constants computed in 'slots' to all lanes */
+  void load_lanes (const std::vector<BtorSimState> &slots,
+                   std::vector<uint64_t> &vals,
+                   size_t n) const;
+  void execute_lanes (std::vector<uint64_t> &vals, size_t n) const;
+
+  /* Ternary execution of the step and init programs on values with X bits
+   * (see btorsimxbv.h), which requires that the model has no arrays.  The
+   * value of slot 's' is 'vals[s]', inputs and states are not computed (also
+   * not by init programs). */
+  bool supports_ternary () const;
+  /* copy the values of constants computed in 'slots' to 'vals' */
+  void load_ternary (const std::vector<BtorSimState> &slots,
+                     std::vector<BtorSimXBitVector> &vals) const;
+  void execute_ternary (std::vector<BtorSimXBitVector> &vals) const;
+  void execute_init_ternary (int64_t id,
+                             std::vector<BtorSimXBitVector> &vals) const;
+
+  /* Native execution of the step program.  'emit_native' appends C code
+   * defining the function 'btorsim_native_step', which computes the results
+   * of word instructions in local variables, with the values of constants in
+   * 'slots' as literals, and executes all other instructions through a
+   * callback (i.e. with the kernels of the interpreter).  Its compiled code
+   * is passed to 'set_native' (see btorsimnative.h).  Only the slots
+   * demanded by 'execute_lazy' (including observed lines) are updated.
+   * Pruning discards the compiled code. */
+  void emit_native (const std::vector<BtorSimState> &slots, std::string &src);
+  void set_native (BtorSimNativeStep fn);
+  bool has_native () const { return native; }
+  void execute_native (std::vector<BtorSimState> &slots);
+
+  /* Multi-threaded execution of the step program with the threads of
+   * 'pool'.  Instructions are grouped by combinational level (the length of
+   * the longest path from inputs, states and constants), since instructions
+   * only read results of lower levels.  Levels with enough work for all
+   * threads are evaluated in parallel, in chunks the threads claim until
+   * none are left, and the other levels by the calling thread only.  So
+   * are instructions on arrays, since a read extends the accessed elements
+   * of its operand. */
+  void execute_parallel (std::vector<BtorSimState> &slots,
+                         BtorSimThreadPool &pool);
+
+  /* compute the cone of the init of state 'id' */
+  void execute_init (int64_t id, std::vector<BtorSimState> &slots) const;
+
+ private:
+  Btor2Parser *model       = nullptr;
+  int64_t num_format_lines = 0;
+
+  /* positive ids of negated operands, and their slots indexed by id */
+  std::vector<int64_t> negated;
+  std::vector<int64_t> negated_slot;
+
+  /* slots whose value does not depend on inputs and states */
+  std::vector<bool> is_constant;
+  std::vector<bool> emitted_constant;
+
+  /* lines in the cone of influence (indexed by id up to and including the
+   * largest id), empty if not pruned */
+  std::vector<bool> coi;
+
+  std::vector<BtorSimInstr> constants;
+  std::vector<BtorSimInstr> step;
+  std::vector<BtorSimInstr> init;
+  /* the init program of state 'id' consists of the instructions from
+   * 'init_begin[id]' up to (excluding) 'init_end[id]' of 'init' */
+  std::vector<size_t> init_begin;
+  std::vector<size_t> init_end;
+
+  /* event-driven evaluation: indices of the step instructions reading a
+   * slot, the input and state slots read by the step program, and their
+   * values at the last incremental execution */
+  std::vector<std::vector<size_t>> fanout;
+  std::vector<int64_t> leaves;
+  std::vector<BtorSimState> leaf_values;
+  std::vector<bool> scheduled;
+  bool primed = false;
+
+  /* demand-driven evaluation: the step instruction computing a slot (-1 for
+   * inputs, states and constants), the slots demanded at every step, and
+   * the execution at which slots were computed last ('UINT32_MAX' if not
+   * computed by the step program) */
+  std::vector<int64_t> producer;
+  std::vector<int64_t> demanded;
+  std::vector<int64_t> observed;
+  std::vector<uint32_t> computed_at;
+  uint32_t epoch = 0;
+
+  /* native execution: the compiled step function, the word slots read by it
+   * and the slots written by it that are demanded, word values passed to it
+   * (indexed by slot), and the slots during its execution */
+  BtorSimNativeStep native = nullptr;
+  std::vector<int64_t> native_inputs;
+  std::vector<int64_t> native_outputs;
+  std::vector<uint64_t> native_words;
+  std::vector<BtorSimState> *native_slots = nullptr;
+
+  /* parallel execution: the step program ordered by level, split into
+   * phases separated by barriers, whose instructions from 'begin' up to
+   * (excluding) 'serial_end' are evaluated by the calling thread, and the
+   * remaining ones up to 'end' in chunks of 'chunk' instructions by all
+   * threads, and the next chunk of every phase */
+  struct Phase
+  {
+    size_t begin, serial_end, end, chunk;
+  };
+  std::vector<BtorSimInstr> levelized;
+  std::vector<Phase> phases;
+  std::unique_ptr<std::atomic<size_t>[]> next_chunk;
+  uint32_t levelized_threads = 0;
+  size_t num_parallel_levels = 0;
+
+  void levelize (uint32_t num_threads);
+
+  void index_step ();
+  void reset_computed_at ();
+  static void execute_native_generic (void *tape, uint32_t i);
+  BtorSimInstr make_instr (int64_t s, bool in_init) const;
+  void emit_cone (int64_t root,
+                  std::vector<BtorSimInstr> &prog,
+                  std::vector<bool> &emitted,
+                  bool in_init);
+};
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#include "btorsimthreads.h"
+
+#include <cassert>
+
+BtorSimThreadPool::BtorSimThreadPool (uint32_t num_threads)
+    : num_threads (num_threads)
+{
+  assert (num_threads > 0);
+  for (uint32_t t = 1; t < num_threads; t++)
+    workers.emplace_back (&BtorSimThreadPool::work, this, t);
+}
+
+BtorSimThreadPool::~BtorSimThreadPool ()
+{
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    stop = true;
+  }
+  start.notify_all ();
+  for (std::thread &w : workers) w.join ();
+}
+
+void
+BtorSimThreadPool::work (uint32_t t)
+{
+  uint64_t seen = 0;
+  for (;;)
+  {
+    const std::function<void (uint32_t)> *j;
+    {
+      std::unique_lock<std::mutex> lock (mutex);
+      start.wait (lock, [&] { return stop || generation != seen; });
+      if (stop) return;
+      seen = generation;
+      j    = job;
+    }
+    (*j) (t);
+    {
+      std::lock_guard<std::mutex> lock (mutex);
+      if (!--running) done.notify_one ();
+    }
+  }
+}
+
+void
+BtorSimThreadPool::run (const std::function<void (uint32_t)> &j)
+{
+  if (num_threads == 1)
+  {
+    j (0);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock (mutex);
+    assert (!running);
+    job     = &j;
+    running = num_threads - 1;
+    generation++;
+  }
+  start.notify_all ();
+  j (0);
+  std::unique_lock<std::mutex> lock (mutex);
+  done.wait (lock, [&] { return !running; });
+  job = nullptr;
+}
+
+void
+BtorSimThreadPool::barrier ()
+{
+  if (num_threads == 1) return;
+  uint32_t g = barrier_generation.load (std::memory_order_relaxed);
+  if (arrived.fetch_add (1, std::memory_order_acq_rel) + 1 == num_threads)
+  {
+    arrived.store (0, std::memory_order_relaxed);
+    barrier_generation.store (g + 1, std::memory_order_release);
+    return;
+  }
+  for (uint32_t spins = 0;
+       barrier_generation.load (std::memory_order_acquire) == g;
+       spins++)
+    if (spins >= 64) std::this_thread::yield ();
+}
@@ -0,0 +1,60 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#ifndef BTOR2THREADS_H_INCLUDED
+#define BTOR2THREADS_H_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* A fixed set of threads running the same job, for fine-grained parallelism
+ * within a simulation step.  Thread 0 is the thread calling 'run', the
+ * other threads sleep between jobs. */
+class BtorSimThreadPool
+{
+ public:
+  explicit BtorSimThreadPool (uint32_t num_threads);
+  ~BtorSimThreadPool ();
+
+  /* avoid accidental copies */
+  BtorSimThreadPool (const BtorSimThreadPool &) = delete;
+  BtorSimThreadPool &operator= (const BtorSimThreadPool &) = delete;
+
+  uint32_t size () const { return num_threads; }
+
+  /* call 'job (t)' on every thread 't' and return after all calls returned */
+  void run (const std::function<void (uint32_t)> &job);
+  /* wait until all threads of the running job called 'barrier' (spinning,
+   * since jobs synchronize often) */
+  void barrier ();
+
+ private:
+  uint32_t num_threads;
+  std::vector<std::thread> workers;
+
+  std::mutex mutex;
+  std::condition_variable start;
+  std::condition_variable done;
+  const std::function<void (uint32_t)> *job = nullptr;
+  uint64_t generation                       = 0;
+  uint32_t running                          = 0;
+  bool stop                                 = false;
+
+  std::atomic<uint32_t> arrived{0};
+  std::atomic<uint32_t> barrier_generation{0};
+
+  void work (uint32_t t);
+};
+
+#endif
@@ -255,6 +255,47 @@ BtorSimVCDWriter::write_vcd (Btor2Parser* model)
   for (std::string s : value_changes) vcd_file << s << "\n";
 }
 
+BtorSimVCDWriter::Snapshot::~Snapshot ()
+{
+  for (BtorSimState& s : prev_value)
+    if (s.type != BtorSimState::Type::INVALID) s.remove ();
+}
+
+/* arrays of previous values are shared with the snapshot, since they are
+ * replaced but never modified */
+static void
+share_values (const std::vector<BtorSimState>& from,
+              std::vector<BtorSimState>& to)
+{
+  for (BtorSimState& s : to)
+    if (s.type != BtorSimState::Type::INVALID) s.remove ();
+  to.resize (from.size ());
+  for (std::vector<BtorSimState>::size_type i = 0; i < from.size (); i++)
+    to[i] = from[i].share ();
+}
+
+void
+BtorSimVCDWriter::save (Snapshot& snapshot) const
+{
+  snapshot.current_id     = current_id;
+  snapshot.current_step   = current_step;
+  snapshot.bv_identifiers = bv_identifiers;
+  snapshot.am_identifiers = am_identifiers;
+  snapshot.value_changes  = value_changes;
+  share_values (prev_value, snapshot.prev_value);
+}
+
+void
+BtorSimVCDWriter::restore (const Snapshot& snapshot)
+{
+  current_id     = snapshot.current_id;
+  current_step   = snapshot.current_step;
+  bv_identifiers = snapshot.bv_identifiers;
+  am_identifiers = snapshot.am_identifiers;
+  value_changes  = snapshot.value_changes;
+  share_values (snapshot.prev_value, prev_value);
+}
+
 void
 BtorSimVCDWriter::update_time (int64_t k)
 {
@@ -304,21 +345,22 @@ BtorSimVCDWriter::add_value_change (int64_t k, int64_t id, BtorSimState state)
   switch (state.type)
   {
     case BtorSimState::Type::BITVEC: {
-      if (!state.bv_state)
+      if (!state.is_set ())
       {
         msg (1, "No current state for named state %" PRId64 "!", id);
         return;
       }
-      if (!prev_value[id].bv_state
-          || btorsim_bv_compare (state.bv_state, prev_value[id].bv_state))
+      if (!prev_value[id].is_set () || !prev_value[id].equals (state))
       {
         update_time (k);
         std::string sval ("");
-        if (state.bv_state->width > 1) sval += "b";
-        sval += btorsim_bv_to_string (state.bv_state);
-        if (state.bv_state->width > 1) sval += " ";
+        uint32_t width = state.bv_width ();
+        if (width > 1) sval += "b";
+        state.append_to_string (sval);
+        if (width > 1) sval += " ";
         value_changes.push_back (sval + get_bv_identifier (id));
-        prev_value[id].update (btorsim_bv_copy (state.bv_state));
+        BtorSimState value = state.copy ();
+        prev_value[id].update (value);
       }
     }
     break;
@@ -342,7 +384,7 @@ BtorSimVCDWriter::add_value_change (int64_t k, int64_t id, BtorSimState state)
           {
             std::string sval ("");
             if (it.second->width > 1) sval += "b";
-            sval += btorsim_bv_to_string (it.second);
+            btorsim_bv_append_to_string (sval, it.second);
             if (it.second->width > 1) sval += " ";
             value_changes.push_back (sval + get_am_identifier (id, it.first));
           }
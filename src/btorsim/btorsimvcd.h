@@ -115,6 +115,25 @@ class BtorSimVCDWriter
 
   /* call at end of simulation to write the vcd_file */
   void write_vcd (Btor2Parser* model);
+
+  /* Copy of the value changes and identifiers recorded so far, to continue
+   * the VCD from a snapshot of the simulation (see 'BtorSim::Snapshot'). */
+  struct Snapshot
+  {
+    Snapshot () = default;
+    ~Snapshot ();
+    Snapshot (const Snapshot&) = delete;
+    Snapshot& operator= (const Snapshot&) = delete;
+
+    int current_id;
+    int64_t current_step;
+    std::map<int64_t, std::string> bv_identifiers;
+    std::map<std::pair<int64_t, std::string>, std::string> am_identifiers;
+    std::vector<std::string> value_changes;
+    std::vector<BtorSimState> prev_value;
+  };
+  void save (Snapshot& snapshot) const;
+  void restore (const Snapshot& snapshot);
 };
 
 #endif
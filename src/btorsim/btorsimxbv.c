@@ -0,0 +1,660 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#include "btorsimxbv.h"
+
+#include <assert.h>
+
+#include "util/btor2mem.h"
+
+/*------------------------------------------------------------------------*/
+
+/* take ownership of 'value' and 'known' */
+static BtorSimXBitVector
+make (BtorSimBitVector *value, BtorSimBitVector *known)
+{
+  assert (value);
+  assert (known);
+  assert (value->width == known->width);
+#ifndef NDEBUG
+  BtorSimBitVector *unknown = btorsim_bv_not (known);
+  BtorSimBitVector *both    = btorsim_bv_and (value, unknown);
+  assert (btorsim_bv_is_zero (both));
+  btorsim_bv_free (both);
+  btorsim_bv_free (unknown);
+#endif
+  BtorSimXBitVector res = {value, known};
+  return res;
+}
+
+static BtorSimXBitVector
+make_known (BtorSimBitVector *value)
+{
+  return make (value, btorsim_bv_ones (value->width));
+}
+
+static BtorSimXBitVector
+make_bool (bool value)
+{
+  return make_known (value ? btorsim_bv_one (1) : btorsim_bv_zero (1));
+}
+
+/* bits of 'a' that are known to be 0 */
+static BtorSimBitVector *
+known_zeros (const BtorSimXBitVector *a)
+{
+  BtorSimBitVector *tmp = btorsim_bv_not (a->value);
+  BtorSimBitVector *res = btorsim_bv_and (tmp, a->known);
+  btorsim_bv_free (tmp);
+  return res;
+}
+
+/* the largest unsigned value of 'a', i.e., with all X bits 1 */
+static BtorSimBitVector *
+max_value (const BtorSimXBitVector *a)
+{
+  BtorSimBitVector *tmp = btorsim_bv_not (a->known);
+  BtorSimBitVector *res = btorsim_bv_or (a->value, tmp);
+  btorsim_bv_free (tmp);
+  return res;
+}
+
+/* the smallest and largest signed value of 'a' */
+static BtorSimBitVector *
+min_signed_value (const BtorSimXBitVector *a)
+{
+  uint32_t msb          = a->value->width - 1;
+  BtorSimBitVector *res = btorsim_bv_copy (a->value);
+  if (!btorsim_bv_get_bit (a->known, msb)) btorsim_bv_set_bit (res, msb, 1);
+  return res;
+}
+
+static BtorSimBitVector *
+max_signed_value (const BtorSimXBitVector *a)
+{
+  uint32_t msb          = a->value->width - 1;
+  BtorSimBitVector *res = max_value (a);
+  if (!btorsim_bv_get_bit (a->known, msb)) btorsim_bv_set_bit (res, msb, 0);
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSimXBitVector
+btorsim_xbv_new_x (uint32_t width)
+{
+  return make (btorsim_bv_zero (width), btorsim_bv_zero (width));
+}
+
+BtorSimXBitVector
+btorsim_xbv_from_bv (const BtorSimBitVector *bv)
+{
+  assert (bv);
+  return make_known (btorsim_bv_copy (bv));
+}
+
+BtorSimXBitVector
+btorsim_xbv_copy (const BtorSimXBitVector *a)
+{
+  assert (a);
+  return make (btorsim_bv_copy (a->value), btorsim_bv_copy (a->known));
+}
+
+void
+btorsim_xbv_free (BtorSimXBitVector *a)
+{
+  assert (a);
+  if (a->value) btorsim_bv_free (a->value);
+  if (a->known) btorsim_bv_free (a->known);
+  a->value = a->known = 0;
+}
+
+bool
+btorsim_xbv_is_known (const BtorSimXBitVector *a)
+{
+  assert (a);
+  return btorsim_bv_is_ones (a->known);
+}
+
+char *
+btorsim_xbv_to_char (const BtorSimXBitVector *a)
+{
+  assert (a);
+
+  uint32_t i, width;
+  char *res;
+
+  width = a->value->width;
+  BTOR2_NEWN (res, width + 1);
+  for (i = 0; i < width; i++)
+  {
+    uint32_t pos = width - 1 - i;
+    if (!btorsim_bv_get_bit (a->known, pos))
+      res[i] = 'x';
+    else
+      res[i] = btorsim_bv_get_bit (a->value, pos) ? '1' : '0';
+  }
+  res[width] = 0;
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+typedef BtorSimBitVector *(*BinaryFun) (const BtorSimBitVector *,
+                                        const BtorSimBitVector *);
+
+/* operators without bit-level X propagation: the concrete result if 'a' and
+ * 'b' have no X bits, and otherwise only X bits */
+static BtorSimXBitVector
+binary_concrete (BinaryFun fun,
+                 const BtorSimXBitVector *a,
+                 const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  if (btorsim_xbv_is_known (a) && btorsim_xbv_is_known (b))
+    return make_known (fun (a->value, b->value));
+  return btorsim_xbv_new_x (a->value->width);
+}
+
+/* the sum of 'a', 'b' and the carry-in 'carry', where a bit is known if the
+ * bits of the operands and the carry into it are known */
+static BtorSimXBitVector
+add_carry (const BtorSimXBitVector *a, const BtorSimXBitVector *b, bool carry)
+{
+  assert (a);
+  assert (b);
+  assert (a->value->width == b->value->width);
+
+  BtorSimBitVector *max_a, *max_b, *sum_zero, *sum_one, *tmp, *zeros_a;
+  BtorSimBitVector *zeros_b, *carry_zero, *carry_one, *known, *value;
+
+  /* the sums of the largest and smallest values of the operands, whose
+   * carries are the possible carries that are 0 respectively 1 */
+  max_a    = max_value (a);
+  max_b    = max_value (b);
+  sum_zero = btorsim_bv_add (max_a, max_b);
+  sum_one  = btorsim_bv_add (a->value, b->value);
+  if (carry)
+  {
+    tmp = btorsim_bv_inc (sum_zero);
+    btorsim_bv_free (sum_zero);
+    sum_zero = tmp;
+    tmp      = btorsim_bv_inc (sum_one);
+    btorsim_bv_free (sum_one);
+    sum_one = tmp;
+  }
+
+  /* carries that are known to be 0 and 1 */
+  zeros_a    = known_zeros (a);
+  zeros_b    = known_zeros (b);
+  tmp        = btorsim_bv_xor (sum_zero, zeros_a);
+  carry_zero = btorsim_bv_xnor (tmp, zeros_b);
+  btorsim_bv_free (tmp);
+  tmp       = btorsim_bv_xor (sum_one, a->value);
+  carry_one = btorsim_bv_xor (tmp, b->value);
+  btorsim_bv_free (tmp);
+
+  tmp   = btorsim_bv_or (carry_zero, carry_one);
+  known = btorsim_bv_and (tmp, a->known);
+  btorsim_bv_free (tmp);
+  tmp   = known;
+  known = btorsim_bv_and (tmp, b->known);
+  btorsim_bv_free (tmp);
+  value = btorsim_bv_and (sum_one, known);
+
+  btorsim_bv_free (max_a);
+  btorsim_bv_free (max_b);
+  btorsim_bv_free (sum_zero);
+  btorsim_bv_free (sum_one);
+  btorsim_bv_free (zeros_a);
+  btorsim_bv_free (zeros_b);
+  btorsim_bv_free (carry_zero);
+  btorsim_bv_free (carry_one);
+  return make (value, known);
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSimXBitVector
+btorsim_xbv_not (const BtorSimXBitVector *a)
+{
+  assert (a);
+  BtorSimBitVector *tmp = btorsim_bv_not (a->value);
+  BtorSimBitVector *res = btorsim_bv_and (tmp, a->known);
+  btorsim_bv_free (tmp);
+  return make (res, btorsim_bv_copy (a->known));
+}
+
+BtorSimXBitVector
+btorsim_xbv_neg (const BtorSimXBitVector *a)
+{
+  assert (a);
+  BtorSimXBitVector not_a = btorsim_xbv_not (a);
+  BtorSimXBitVector zero  = make_known (btorsim_bv_zero (a->value->width));
+  BtorSimXBitVector res   = add_carry (&not_a, &zero, true);
+  btorsim_xbv_free (&not_a);
+  btorsim_xbv_free (&zero);
+  return res;
+}
+
+BtorSimXBitVector
+btorsim_xbv_inc (const BtorSimXBitVector *a)
+{
+  assert (a);
+  BtorSimXBitVector zero = make_known (btorsim_bv_zero (a->value->width));
+  BtorSimXBitVector res  = add_carry (a, &zero, true);
+  btorsim_xbv_free (&zero);
+  return res;
+}
+
+BtorSimXBitVector
+btorsim_xbv_dec (const BtorSimXBitVector *a)
+{
+  assert (a);
+  BtorSimXBitVector ones = make_known (btorsim_bv_ones (a->value->width));
+  BtorSimXBitVector res  = add_carry (a, &ones, false);
+  btorsim_xbv_free (&ones);
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSimXBitVector
+btorsim_xbv_redand (const BtorSimXBitVector *a)
+{
+  assert (a);
+  BtorSimBitVector *zeros = known_zeros (a);
+  bool has_zero           = !btorsim_bv_is_zero (zeros);
+  btorsim_bv_free (zeros);
+  if (has_zero) return make_bool (false);
+  if (btorsim_xbv_is_known (a)) return make_bool (true);
+  return btorsim_xbv_new_x (1);
+}
+
+BtorSimXBitVector
+btorsim_xbv_redor (const BtorSimXBitVector *a)
+{
+  assert (a);
+  if (!btorsim_bv_is_zero (a->value)) return make_bool (true);
+  if (btorsim_xbv_is_known (a)) return make_bool (false);
+  return btorsim_xbv_new_x (1);
+}
+
+BtorSimXBitVector
+btorsim_xbv_redxor (const BtorSimXBitVector *a)
+{
+  assert (a);
+  if (btorsim_xbv_is_known (a))
+    return make_bool (btorsim_bv_redxor_p (a->value));
+  return btorsim_xbv_new_x (1);
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSimXBitVector
+btorsim_xbv_and (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  BtorSimBitVector *value   = btorsim_bv_and (a->value, b->value);
+  BtorSimBitVector *zeros_a = known_zeros (a);
+  BtorSimBitVector *zeros_b = known_zeros (b);
+  BtorSimBitVector *zeros   = btorsim_bv_or (zeros_a, zeros_b);
+  BtorSimBitVector *known   = btorsim_bv_or (zeros, value);
+  btorsim_bv_free (zeros_a);
+  btorsim_bv_free (zeros_b);
+  btorsim_bv_free (zeros);
+  return make (value, known);
+}
+
+BtorSimXBitVector
+btorsim_xbv_or (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  BtorSimBitVector *value   = btorsim_bv_or (a->value, b->value);
+  BtorSimBitVector *zeros_a = known_zeros (a);
+  BtorSimBitVector *zeros_b = known_zeros (b);
+  BtorSimBitVector *zeros   = btorsim_bv_and (zeros_a, zeros_b);
+  BtorSimBitVector *known   = btorsim_bv_or (zeros, value);
+  btorsim_bv_free (zeros_a);
+  btorsim_bv_free (zeros_b);
+  btorsim_bv_free (zeros);
+  return make (value, known);
+}
+
+BtorSimXBitVector
+btorsim_xbv_xor (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  BtorSimBitVector *known = btorsim_bv_and (a->known, b->known);
+  BtorSimBitVector *tmp   = btorsim_bv_xor (a->value, b->value);
+  BtorSimBitVector *value = btorsim_bv_and (tmp, known);
+  btorsim_bv_free (tmp);
+  return make (value, known);
+}
+
+BtorSimXBitVector
+btorsim_xbv_nand (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  BtorSimXBitVector tmp = btorsim_xbv_and (a, b);
+  BtorSimXBitVector res = btorsim_xbv_not (&tmp);
+  btorsim_xbv_free (&tmp);
+  return res;
+}
+
+BtorSimXBitVector
+btorsim_xbv_nor (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  BtorSimXBitVector tmp = btorsim_xbv_or (a, b);
+  BtorSimXBitVector res = btorsim_xbv_not (&tmp);
+  btorsim_xbv_free (&tmp);
+  return res;
+}
+
+BtorSimXBitVector
+btorsim_xbv_xnor (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  BtorSimXBitVector tmp = btorsim_xbv_xor (a, b);
+  BtorSimXBitVector res = btorsim_xbv_not (&tmp);
+  btorsim_xbv_free (&tmp);
+  return res;
+}
+
+BtorSimXBitVector
+btorsim_xbv_implies (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  BtorSimXBitVector tmp = btorsim_xbv_not (a);
+  BtorSimXBitVector res = btorsim_xbv_or (&tmp, b);
+  btorsim_xbv_free (&tmp);
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSimXBitVector
+btorsim_xbv_eq (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  assert (a->value->width == b->value->width);
+  BtorSimXBitVector diff = btorsim_xbv_xor (a, b);
+  bool differ            = !btorsim_bv_is_zero (diff.value);
+  bool known             = btorsim_xbv_is_known (&diff);
+  btorsim_xbv_free (&diff);
+  if (differ) return make_bool (false);
+  if (known) return make_bool (true);
+  return btorsim_xbv_new_x (1);
+}
+
+BtorSimXBitVector
+btorsim_xbv_neq (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  BtorSimXBitVector tmp = btorsim_xbv_eq (a, b);
+  BtorSimXBitVector res = btorsim_xbv_not (&tmp);
+  btorsim_xbv_free (&tmp);
+  return res;
+}
+
+/* Comparison of the ranges ['min_a', 'max_a'] and ['min_b', 'max_b'] by
+ * 'fun': 1 if all values are related, 0 if none are, and X otherwise.  Takes
+ * ownership of the bounds. */
+typedef bool (*CompareFun) (const BtorSimBitVector *,
+                            const BtorSimBitVector *);
+
+static BtorSimXBitVector
+compare (CompareFun fun,
+         BtorSimBitVector *min_a,
+         BtorSimBitVector *max_a,
+         BtorSimBitVector *min_b,
+         BtorSimBitVector *max_b)
+{
+  BtorSimXBitVector res;
+  if (fun (max_a, min_b))
+    res = make_bool (true);
+  else if (!fun (min_a, max_b))
+    res = make_bool (false);
+  else
+    res = btorsim_xbv_new_x (1);
+  btorsim_bv_free (min_a);
+  btorsim_bv_free (max_a);
+  btorsim_bv_free (min_b);
+  btorsim_bv_free (max_b);
+  return res;
+}
+
+BtorSimXBitVector
+btorsim_xbv_ult (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  return compare (btorsim_bv_ult_p,
+                  btorsim_bv_copy (a->value),
+                  max_value (a),
+                  btorsim_bv_copy (b->value),
+                  max_value (b));
+}
+
+BtorSimXBitVector
+btorsim_xbv_ulte (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  return compare (btorsim_bv_ulte_p,
+                  btorsim_bv_copy (a->value),
+                  max_value (a),
+                  btorsim_bv_copy (b->value),
+                  max_value (b));
+}
+
+BtorSimXBitVector
+btorsim_xbv_slt (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  return compare (btorsim_bv_slt_p,
+                  min_signed_value (a),
+                  max_signed_value (a),
+                  min_signed_value (b),
+                  max_signed_value (b));
+}
+
+BtorSimXBitVector
+btorsim_xbv_slte (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  return compare (btorsim_bv_slte_p,
+                  min_signed_value (a),
+                  max_signed_value (a),
+                  min_signed_value (b),
+                  max_signed_value (b));
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSimXBitVector
+btorsim_xbv_add (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  return add_carry (a, b, false);
+}
+
+BtorSimXBitVector
+btorsim_xbv_sub (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  BtorSimXBitVector not_b = btorsim_xbv_not (b);
+  BtorSimXBitVector res   = add_carry (a, &not_b, true);
+  btorsim_xbv_free (&not_b);
+  return res;
+}
+
+BtorSimXBitVector
+btorsim_xbv_mul (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  return binary_concrete (btorsim_bv_mul, a, b);
+}
+
+BtorSimXBitVector
+btorsim_xbv_udiv (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  return binary_concrete (btorsim_bv_udiv, a, b);
+}
+
+BtorSimXBitVector
+btorsim_xbv_sdiv (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  return binary_concrete (btorsim_bv_sdiv, a, b);
+}
+
+BtorSimXBitVector
+btorsim_xbv_urem (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  return binary_concrete (btorsim_bv_urem, a, b);
+}
+
+BtorSimXBitVector
+btorsim_xbv_srem (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  return binary_concrete (btorsim_bv_srem, a, b);
+}
+
+BtorSimXBitVector
+btorsim_xbv_smod (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  return binary_concrete (btorsim_bv_smod, a, b);
+}
+
+/*------------------------------------------------------------------------*/
+
+/* Shifts and rotations by a known amount move the X bits of 'a' along with
+ * its values, bits shifted in by 'sll' and 'srl' are known to be 0 and
+ * those shifted in by 'sra' are copies of the sign bit. */
+
+BtorSimXBitVector
+btorsim_xbv_sll (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  if (!btorsim_xbv_is_known (b)) return btorsim_xbv_new_x (a->value->width);
+  BtorSimBitVector *unknown = btorsim_bv_not (a->known);
+  BtorSimBitVector *tmp     = btorsim_bv_sll (unknown, b->value);
+  BtorSimBitVector *known   = btorsim_bv_not (tmp);
+  btorsim_bv_free (unknown);
+  btorsim_bv_free (tmp);
+  return make (btorsim_bv_sll (a->value, b->value), known);
+}
+
+BtorSimXBitVector
+btorsim_xbv_srl (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  if (!btorsim_xbv_is_known (b)) return btorsim_xbv_new_x (a->value->width);
+  BtorSimBitVector *unknown = btorsim_bv_not (a->known);
+  BtorSimBitVector *tmp     = btorsim_bv_srl (unknown, b->value);
+  BtorSimBitVector *known   = btorsim_bv_not (tmp);
+  btorsim_bv_free (unknown);
+  btorsim_bv_free (tmp);
+  return make (btorsim_bv_srl (a->value, b->value), known);
+}
+
+BtorSimXBitVector
+btorsim_xbv_sra (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  if (!btorsim_xbv_is_known (b)) return btorsim_xbv_new_x (a->value->width);
+  return make (btorsim_bv_sra (a->value, b->value),
+               btorsim_bv_sra (a->known, b->value));
+}
+
+BtorSimXBitVector
+btorsim_xbv_rol (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  if (!btorsim_xbv_is_known (b)) return btorsim_xbv_new_x (a->value->width);
+  return make (btorsim_bv_rol (a->value, b->value),
+               btorsim_bv_rol (a->known, b->value));
+}
+
+BtorSimXBitVector
+btorsim_xbv_ror (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  if (!btorsim_xbv_is_known (b)) return btorsim_xbv_new_x (a->value->width);
+  return make (btorsim_bv_ror (a->value, b->value),
+               btorsim_bv_ror (a->known, b->value));
+}
+
+/*------------------------------------------------------------------------*/
+
+BtorSimXBitVector
+btorsim_xbv_ite (const BtorSimXBitVector *c,
+                 const BtorSimXBitVector *t,
+                 const BtorSimXBitVector *e)
+{
+  assert (c);
+  assert (t);
+  assert (e);
+  assert (c->value->width == 1);
+  if (btorsim_xbv_is_known (c))
+    return btorsim_xbv_copy (btorsim_bv_is_true (c->value) ? t : e);
+
+  /* bits that are known and equal in both branches */
+  BtorSimBitVector *same  = btorsim_bv_xnor (t->value, e->value);
+  BtorSimBitVector *tmp   = btorsim_bv_and (t->known, e->known);
+  BtorSimBitVector *known = btorsim_bv_and (tmp, same);
+  BtorSimBitVector *value = btorsim_bv_and (t->value, known);
+  btorsim_bv_free (same);
+  btorsim_bv_free (tmp);
+  return make (value, known);
+}
+
+BtorSimXBitVector
+btorsim_xbv_concat (const BtorSimXBitVector *a, const BtorSimXBitVector *b)
+{
+  assert (a);
+  assert (b);
+  return make (btorsim_bv_concat (a->value, b->value),
+               btorsim_bv_concat (a->known, b->known));
+}
+
+BtorSimXBitVector
+btorsim_xbv_slice (const BtorSimXBitVector *a, uint32_t upper, uint32_t lower)
+{
+  assert (a);
+  return make (btorsim_bv_slice (a->value, upper, lower),
+               btorsim_bv_slice (a->known, upper, lower));
+}
+
+BtorSimXBitVector
+btorsim_xbv_uext (const BtorSimXBitVector *a, uint32_t len)
+{
+  assert (a);
+  /* the extension bits are known to be 0 */
+  BtorSimBitVector *unknown = btorsim_bv_not (a->known);
+  BtorSimBitVector *tmp     = btorsim_bv_uext (unknown, len);
+  BtorSimBitVector *known   = btorsim_bv_not (tmp);
+  btorsim_bv_free (unknown);
+  btorsim_bv_free (tmp);
+  return make (btorsim_bv_uext (a->value, len), known);
+}
+
+BtorSimXBitVector
+btorsim_xbv_sext (const BtorSimXBitVector *a, uint32_t len)
+{
+  assert (a);
+  /* the extension bits are copies of the sign bit, X if it is X */
+  return make (btorsim_bv_sext (a->value, len),
+               btorsim_bv_sext (a->known, len));
+}
@@ -0,0 +1,135 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+#ifndef BTOR2XBV_H_INCLUDED
+#define BTOR2XBV_H_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "btorsimbv.h"
+
+#if __cplusplus
+extern "C" {
+#endif
+
+/* Ternary bit-vectors, whose bits are 0, 1 or X (unknown).  Bit 'i' is X if
+ * bit 'i' of 'known' is 0, and bit 'i' of 'value' otherwise.  Bits of
+ * 'value' that are X are 0.
+ *
+ * Operations are sound, i.e., every bit that is not X in the result has
+ * the same value for all values of the X bits of the operands.  Bitwise
+ * operations, 'ite', extensions, slices and concatenations, comparisons,
+ * additions and subtractions (with X propagation through carries) and shifts
+ * and rotations by known amounts are precise for every bit.  All other
+ * results are entirely X as soon as any operand bit is X.
+ *
+ * All operations return new bit-vectors, which are released with
+ * 'btorsim_xbv_free'. */
+
+struct BtorSimXBitVector
+{
+  BtorSimBitVector *value;
+  BtorSimBitVector *known;
+};
+
+typedef struct BtorSimXBitVector BtorSimXBitVector;
+
+/* a bit-vector of 'width' X bits */
+BtorSimXBitVector btorsim_xbv_new_x (uint32_t width);
+/* a bit-vector without X bits with the value 'bv' (copied) */
+BtorSimXBitVector btorsim_xbv_from_bv (const BtorSimBitVector *bv);
+BtorSimXBitVector btorsim_xbv_copy (const BtorSimXBitVector *a);
+void btorsim_xbv_free (BtorSimXBitVector *a);
+
+bool btorsim_xbv_is_known (const BtorSimXBitVector *a);
+/* return a new string of '0', '1' and 'x' (most significant bit first) */
+char *btorsim_xbv_to_char (const BtorSimXBitVector *a);
+
+BtorSimXBitVector btorsim_xbv_not (const BtorSimXBitVector *a);
+BtorSimXBitVector btorsim_xbv_neg (const BtorSimXBitVector *a);
+BtorSimXBitVector btorsim_xbv_inc (const BtorSimXBitVector *a);
+BtorSimXBitVector btorsim_xbv_dec (const BtorSimXBitVector *a);
+
+BtorSimXBitVector btorsim_xbv_redand (const BtorSimXBitVector *a);
+BtorSimXBitVector btorsim_xbv_redor (const BtorSimXBitVector *a);
+BtorSimXBitVector btorsim_xbv_redxor (const BtorSimXBitVector *a);
+
+BtorSimXBitVector btorsim_xbv_and (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_or (const BtorSimXBitVector *a,
+                                  const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_xor (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_nand (const BtorSimXBitVector *a,
+                                    const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_nor (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_xnor (const BtorSimXBitVector *a,
+                                    const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_implies (const BtorSimXBitVector *a,
+                                       const BtorSimXBitVector *b);
+
+BtorSimXBitVector btorsim_xbv_eq (const BtorSimXBitVector *a,
+                                  const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_neq (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_ult (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_ulte (const BtorSimXBitVector *a,
+                                    const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_slt (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_slte (const BtorSimXBitVector *a,
+                                    const BtorSimXBitVector *b);
+
+BtorSimXBitVector btorsim_xbv_add (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_sub (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_mul (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_udiv (const BtorSimXBitVector *a,
+                                    const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_sdiv (const BtorSimXBitVector *a,
+                                    const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_urem (const BtorSimXBitVector *a,
+                                    const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_srem (const BtorSimXBitVector *a,
+                                    const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_smod (const BtorSimXBitVector *a,
+                                    const BtorSimXBitVector *b);
+
+BtorSimXBitVector btorsim_xbv_sll (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_srl (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_sra (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_rol (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_ror (const BtorSimXBitVector *a,
+                                   const BtorSimXBitVector *b);
+
+BtorSimXBitVector btorsim_xbv_ite (const BtorSimXBitVector *c,
+                                   const BtorSimXBitVector *t,
+                                   const BtorSimXBitVector *e);
+BtorSimXBitVector btorsim_xbv_concat (const BtorSimXBitVector *a,
+                                      const BtorSimXBitVector *b);
+BtorSimXBitVector btorsim_xbv_slice (const BtorSimXBitVector *a,
+                                     uint32_t upper,
+                                     uint32_t lower);
+BtorSimXBitVector btorsim_xbv_uext (const BtorSimXBitVector *a, uint32_t len);
+BtorSimXBitVector btorsim_xbv_sext (const BtorSimXBitVector *a, uint32_t len);
+
+#if __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,390 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+/* Checks of the word-level bit-vector operations of 'btorsimbv.c' against
+ * bit-by-bit reference implementations, on random values at widths around
+ * the boundaries of its 32-bit words. */
+
+#include "btorsim/btorsimbv.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_WIDTH 257
+
+static const uint32_t widths[] = {1,  2,  7,  8,   31,  32,  33,  63,  64,
+                                  65, 95, 96, 127, 128, 129, 160, 256, 257};
+
+#define NWIDTHS (sizeof widths / sizeof *widths)
+
+/* random values per width */
+#define NROUNDS 200
+
+static BtorSimRNG rng;
+static int32_t failed;
+
+/*------------------------------------------------------------------------*/
+
+/* Reference values are arrays of bits, least significant bit first. */
+
+static void
+get_bits (const BtorSimBitVector *bv, uint8_t *bits)
+{
+  uint32_t i;
+  for (i = 0; i < bv->width; i++) bits[i] = btorsim_bv_get_bit (bv, i);
+}
+
+/* Return a random value, which is zero, ones, a single bit, random or only
+ * random in or ones in a random range of bits, such that counts of leading
+ * and trailing bits and shift amounts cover all positions. */
+static BtorSimBitVector *
+random_value (uint32_t width)
+{
+  BtorSimBitVector *res;
+  uint32_t i, kind, lo, up, bit;
+
+  res  = btorsim_bv_new (width);
+  kind = btorsim_rng_pick_rand (&rng, 0, 5);
+  lo   = btorsim_rng_pick_rand (&rng, 0, width - 1);
+  up   = btorsim_rng_pick_rand (&rng, lo, width - 1);
+  for (i = 0; i < width; i++)
+  {
+    switch (kind)
+    {
+      case 0: bit = 0; break;
+      case 1: bit = 1; break;
+      case 2: bit = i == lo; break;
+      case 3: bit = btorsim_rng_rand (&rng) & 1; break;
+      case 4: bit = lo <= i && i <= up && btorsim_rng_rand (&rng) & 1; break;
+      default: bit = lo <= i && i <= up;
+    }
+    btorsim_bv_set_bit (res, i, bit);
+  }
+  return res;
+}
+
+/* the value of 'bits' as shift amount, where all amounts larger than
+ * 'width' are the same */
+static uint64_t
+shift_amount (const uint8_t *bits, uint32_t width)
+{
+  uint64_t res = 0;
+  uint32_t i;
+  for (i = width; i-- > 0;)
+  {
+    res = 2 * res + bits[i];
+    if (res > width) return width + 1;
+  }
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+static void
+print_operand (const char *name, const BtorSimBitVector *bv)
+{
+  uint32_t i;
+  if (!bv) return;
+  fprintf (stderr, "  %s = ", name);
+  for (i = bv->width; i-- > 0;)
+    fputc ('0' + btorsim_bv_get_bit (bv, i), stderr);
+  fputc ('\n', stderr);
+}
+
+static void
+report (const char *op,
+        uint32_t width,
+        const BtorSimBitVector *a,
+        const BtorSimBitVector *b)
+{
+  fprintf (stderr, "btorsimbvtest: '%s' failed at width %u\n", op, width);
+  print_operand ("a", a);
+  print_operand ("b", b);
+  failed++;
+}
+
+/* check that 'res' has the bits 'expected' and delete it */
+static void
+check_bits (const char *op,
+            BtorSimBitVector *res,
+            const uint8_t *expected,
+            uint32_t width,
+            const BtorSimBitVector *a,
+            const BtorSimBitVector *b)
+{
+  uint8_t bits[MAX_WIDTH];
+  if (res->width != width)
+    report (op, width, a, b);
+  else
+  {
+    get_bits (res, bits);
+    if (memcmp (bits, expected, width)) report (op, width, a, b);
+  }
+  btorsim_bv_free (res);
+}
+
+static void
+check_value (const char *op,
+             uint64_t res,
+             uint64_t expected,
+             const BtorSimBitVector *a)
+{
+  if (res != expected) report (op, a->width, a, 0);
+}
+
+/*------------------------------------------------------------------------*/
+
+static void
+check_counts (const BtorSimBitVector *a)
+{
+  uint8_t bits[MAX_WIDTH];
+  uint32_t w = a->width, i, tz, lz, lo, ones;
+  int64_t pow2;
+
+  get_bits (a, bits);
+  for (tz = 0; tz < w && !bits[tz]; tz++)
+    ;
+  for (lz = 0; lz < w && !bits[w - 1 - lz]; lz++)
+    ;
+  for (lo = 0; lo < w && bits[w - 1 - lo]; lo++)
+    ;
+  for (ones = 0, i = 0; i < w; i++) ones += bits[i];
+  /* as before the word-level version, zero is reported as 2^0 */
+  pow2 = ones > 1 ? -1 : ones ? (int64_t) tz : 0;
+
+  check_value ("trailing_zeros", btorsim_bv_get_num_trailing_zeros (a), tz, a);
+  check_value ("leading_zeros", btorsim_bv_get_num_leading_zeros (a), lz, a);
+  check_value ("leading_ones", btorsim_bv_get_num_leading_ones (a), lo, a);
+  check_value ("power_of_two", btorsim_bv_power_of_two (a), pow2, a);
+  check_value ("redxor_p", btorsim_bv_redxor_p (a), ones & 1, a);
+  bits[0] = ones & 1;
+  check_bits ("redxor", btorsim_bv_redxor (a), bits, 1, a, 0);
+}
+
+static void
+check_shifts (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  uint8_t x[MAX_WIDTH], y[MAX_WIDTH], sll[MAX_WIDTH], srl[MAX_WIDTH];
+  uint8_t rol[MAX_WIDTH], ror[MAX_WIDTH];
+  uint32_t w = a->width, i;
+  uint64_t n;
+
+  get_bits (a, x);
+  get_bits (b, y);
+  n = shift_amount (y, w);
+  for (i = 0; i < w; i++)
+  {
+    sll[i] = i >= n ? x[i - n] : 0;
+    srl[i] = i + n < w ? x[i + n] : 0;
+    /* rotating by the width gives 'a', by more gives zero */
+    rol[i] = n > w ? 0 : x[(i + w - n % w) % w];
+    ror[i] = n > w ? 0 : x[(i + n) % w];
+  }
+  check_bits ("sll", btorsim_bv_sll (a, b), sll, w, a, b);
+  check_bits ("srl", btorsim_bv_srl (a, b), srl, w, a, b);
+  check_bits ("rol", btorsim_bv_rol (a, b), rol, w, a, b);
+  check_bits ("ror", btorsim_bv_ror (a, b), ror, w, a, b);
+}
+
+static void
+check_mul (const BtorSimBitVector *a, const BtorSimBitVector *b)
+{
+  uint8_t x[MAX_WIDTH], y[MAX_WIDTH], res[MAX_WIDTH];
+  uint32_t w = a->width, i, j, sum, carry;
+
+  get_bits (a, x);
+  get_bits (b, y);
+  memset (res, 0, w);
+  for (i = 0; i < w; i++)
+  {
+    if (!y[i]) continue;
+    for (j = i, carry = 0; j < w; j++)
+    {
+      sum    = res[j] + x[j - i] + carry;
+      res[j] = sum & 1;
+      carry  = sum >> 1;
+    }
+  }
+  check_bits ("mul", btorsim_bv_mul (a, b), res, w, a, b);
+}
+
+static void
+check_ranges (const BtorSimBitVector *a)
+{
+  uint8_t x[MAX_WIDTH], res[MAX_WIDTH];
+  char str[MAX_WIDTH + 1];
+  uint32_t w = a->width, i, lo, up;
+  BtorSimBitVector *r;
+
+  get_bits (a, x);
+  lo = btorsim_rng_pick_rand (&rng, 0, w - 1);
+  up = btorsim_rng_pick_rand (&rng, lo, w - 1);
+
+  memcpy (res, x + lo, up - lo + 1);
+  check_bits ("slice", btorsim_bv_slice (a, up, lo), res, up - lo + 1, a, 0);
+
+  for (i = 0; i < w; i++) res[i] = x[i] ^ (lo <= i && i <= up);
+  r = btorsim_bv_flipped_bit_range (a, up, lo);
+  check_bits ("flipped_bit_range", r, res, w, a, 0);
+
+  /* only the range is random */
+  r = btorsim_bv_new_random_bit_range (&rng, w, up, lo);
+  get_bits (r, res);
+  for (i = 0; i < w; i++)
+    if (res[i] && (i < lo || i > up)) break;
+  if (i < w) report ("new_random_bit_range", w, r, 0);
+  btorsim_bv_free (r);
+
+  for (i = 0; i < w; i++) str[i] = '0' + x[w - 1 - i];
+  str[w] = 0;
+  check_bits ("const", btorsim_bv_const (str, w), x, w, a, 0);
+}
+
+/* check binary and hexadecimal text, returned and written to buffers */
+static void
+check_text (const BtorSimBitVector *a)
+{
+  uint8_t x[MAX_WIDTH];
+  char bin[MAX_WIDTH + 1], hex[MAX_WIDTH / 4 + 2], buf[MAX_WIDTH + 2], *res;
+  uint32_t w = a->width, n = (w + 3) / 4, i, j, nibble;
+
+  get_bits (a, x);
+  for (i = 0; i < w; i++) bin[i] = '0' + x[w - 1 - i];
+  bin[w] = 0;
+  for (i = 0; i < n; i++)
+  {
+    for (j = 4, nibble = 0; j-- > 0;)
+      nibble = 2 * nibble + (4 * i + j < w && x[4 * i + j]);
+    hex[n - 1 - i] = "0123456789abcdef"[nibble];
+  }
+  hex[n] = 0;
+
+  res = btorsim_bv_to_char (a);
+  if (strcmp (res, bin)) report ("to_char", w, a, 0);
+  free (res);
+  res = btorsim_bv_to_hex_char (a);
+  if (strcmp (res, hex)) report ("to_hex_char", w, a, 0);
+  free (res);
+
+  /* buffers are written exactly up to the terminating '\0' */
+  memset (buf, '#', sizeof buf);
+  btorsim_bv_to_char_buf (a, buf);
+  if (strcmp (buf, bin) || buf[w + 1] != '#') report ("to_char_buf", w, a, 0);
+  memset (buf, '#', sizeof buf);
+  btorsim_bv_to_hex_char_buf (a, buf);
+  if (strcmp (buf, hex) || buf[n + 1] != '#')
+    report ("to_hex_char_buf", w, a, 0);
+}
+
+/* decimal digits of 'bits' by doubling, least significant digit first */
+static uint32_t
+dec_digits (const uint8_t *bits, uint32_t width, uint8_t *digits)
+{
+  uint32_t i, j, n = 1, d, carry;
+  digits[0] = 0;
+  for (i = width; i-- > 0;)
+  {
+    for (j = 0, carry = bits[i]; j < n; j++)
+    {
+      d         = 2 * digits[j] + carry;
+      digits[j] = d % 10;
+      carry     = d / 10;
+    }
+    if (carry) digits[n++] = carry;
+  }
+  return n;
+}
+
+/* write the decimal text of 'bits' to 'str' after 'zeros' leading zeros */
+static void
+dec_string (const uint8_t *bits, uint32_t width, uint32_t zeros, char *str)
+{
+  uint8_t digits[MAX_WIDTH];
+  uint32_t i, n;
+
+  n = dec_digits (bits, width, digits);
+  for (i = 0; i < zeros; i++) *str++ = '0';
+  for (i = 0; i < n; i++) *str++ = '0' + digits[n - 1 - i];
+  *str = 0;
+}
+
+/* Check decimal text of 'a' and 'constd' of positive and negative decimal
+ * text, where leading zeros move the digits across chunks of 9 digits. */
+static void
+check_dec (const BtorSimBitVector *a)
+{
+  uint8_t x[MAX_WIDTH], neg[MAX_WIDTH];
+  char str[MAX_WIDTH + 11], *res;
+  uint32_t w = a->width, i, carry, zeros;
+
+  get_bits (a, x);
+  dec_string (x, w, 0, str);
+  res = btorsim_bv_to_dec_char (a);
+  if (strcmp (res, str)) report ("to_dec_char", w, a, 0);
+  free (res);
+
+  zeros = btorsim_rng_pick_rand (&rng, 0, 9);
+  dec_string (x, w, zeros, str);
+  check_bits ("constd", btorsim_bv_constd (str, w), x, w, a, 0);
+
+  /* negative values down to the minimum signed value of the width */
+  if (x[w - 1])
+    for (i = 0; i < w; i++) x[i] = i == w - 1;
+  else if (w == 1)
+    x[0] = 1;
+  str[0] = '-';
+  dec_string (x, w, zeros, str + 1);
+  for (i = 0, carry = 1; i < w; i++)
+  {
+    neg[i] = (!x[i] + carry) & 1;
+    carry  = !x[i] && carry;
+  }
+  check_bits ("constd", btorsim_bv_constd (str, w), neg, w, a, 0);
+}
+
+/*------------------------------------------------------------------------*/
+
+int32_t
+main (void)
+{
+  BtorSimBitVector *a, *b;
+  uint32_t i, j, w, max;
+
+  btorsim_rng_init (&rng, 0);
+  for (i = 0; i < NWIDTHS; i++)
+  {
+    w = widths[i];
+    for (j = 0; j < NROUNDS; j++)
+    {
+      a = random_value (w);
+      b = random_value (w);
+      check_counts (a);
+      check_shifts (a, b);
+      check_mul (a, b);
+      check_ranges (a);
+      check_text (a);
+      check_dec (a);
+      btorsim_bv_free (b);
+      /* all shift amounts up to more than the width */
+      max = w == 1 ? 1 : w + 1;
+      b   = btorsim_bv_uint64_to_bv (btorsim_rng_pick_rand (&rng, 0, max), w);
+      check_shifts (a, b);
+      btorsim_bv_free (b);
+      btorsim_bv_free (a);
+    }
+  }
+  if (failed)
+  {
+    fprintf (stderr, "%d checks failed\n", failed);
+    return 1;
+  }
+  printf ("all checks passed\n");
+  return 0;
+}
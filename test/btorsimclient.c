@@ -0,0 +1,101 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+/* Client of 'btorsim --socket' for 'btorsimservertest.sh', which sends
+ * '<stdin>' as requests to the server and copies its responses to
+ * '<stdout>' until the server closes the connection. */
+
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static int32_t
+fail (const char *what)
+{
+  fprintf (stderr, "btorsimclient: %s: %s\n", what, strerror (errno));
+  return 1;
+}
+
+/* Copy one chunk from 'from' to 'to' and return its size (0 at the end). */
+static ssize_t
+copy (int from, int to)
+{
+  char buf[1 << 16];
+  ssize_t n = read (from, buf, sizeof buf), written;
+  for (ssize_t i = 0; i < n; i += written)
+  {
+    written = write (to, buf + i, n - i);
+    if (written <= 0) return -1;
+  }
+  return n;
+}
+
+int32_t
+main (int32_t argc, char **argv)
+{
+  struct sockaddr_un addr;
+  struct pollfd fds[2];
+  int32_t fd, i;
+
+  if (argc != 2 || strlen (argv[1]) >= sizeof addr.sun_path)
+  {
+    fprintf (stderr, "usage: btorsimclient <socket>\n");
+    return 1;
+  }
+  memset (&addr, 0, sizeof addr);
+  addr.sun_family = AF_UNIX;
+  strcpy (addr.sun_path, argv[1]);
+
+  /* the server may not listen yet */
+  fd = socket (AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) return fail ("socket");
+  for (i = 0; connect (fd, (struct sockaddr *) &addr, sizeof addr); i++)
+  {
+    if (i == 100) return fail ("connect");
+    usleep (50000);
+  }
+
+  /* requests and responses are copied at the same time, such that the
+   * server never waits for responses to be read */
+  fds[0].fd     = 0;
+  fds[0].events = POLLIN;
+  fds[1].fd     = fd;
+  fds[1].events = POLLIN;
+  for (;;)
+  {
+    if (poll (fds, 2, -1) < 0)
+    {
+      if (errno == EINTR) continue;
+      return fail ("poll");
+    }
+    if (fds[0].revents)
+    {
+      ssize_t n = copy (0, fd);
+      if (n < 0) return fail ("sending requests");
+      if (!n)
+      {
+        shutdown (fd, SHUT_WR);
+        fds[0].fd = -1;
+      }
+    }
+    if (fds[1].revents)
+    {
+      ssize_t n = copy (fd, 1);
+      if (n < 0) return fail ("receiving responses");
+      if (!n) break;
+    }
+  }
+  close (fd);
+  return 0;
+}
@@ -0,0 +1,256 @@
+/**
+ *  Btor2Tools: A tool package for the BTOR format.
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of the Btor2Tools package.
+ *  See LICENSE.txt for more information on using this software.
+ */
+
+/* Tests of the step-level interface of 'libbtorsim' (see 'btorsimlib.h'). */
+
+#include "btorsim/btorsimlib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int32_t failed;
+
+#define CHECK(cond)                                                        \
+  do                                                                       \
+  {                                                                        \
+    if (!(cond))                                                           \
+    {                                                                      \
+      fprintf (stderr, "%s:%d: '%s' failed\n", __FILE__, __LINE__, #cond); \
+      failed++;                                                            \
+    }                                                                      \
+  } while (0)
+
+#define CHECK_VALUE(s, id, bits)                   \
+  do                                               \
+  {                                                \
+    const char *value = btorsim_get_value (s, id); \
+    CHECK (value && !strcmp (value, bits));        \
+  } while (0)
+
+/* A 4-bit counter incremented if input 'en' is set, with bad state property
+ * 'cnt == 3' and an array state without next function read at 'cnt'. */
+static const char *counter =
+    "1 sort bitvec 4\n"
+    "2 sort bitvec 1\n"
+    "3 input 2 en\n"
+    "4 zero 1\n"
+    "5 state 1 cnt\n"
+    "6 init 1 5 4\n"
+    "7 one 1\n"
+    "8 add 1 5 7\n"
+    "9 ite 1 3 8 5\n"
+    "10 next 1 5 9\n"
+    "11 constd 1 3\n"
+    "12 eq 2 5 11\n"
+    "13 bad 12\n"
+    "14 sort array 1 1\n"
+    "15 state 14 mem\n"
+    "16 read 1 15 5\n";
+
+static FILE *
+open_model (const char *src)
+{
+  FILE *file = tmpfile ();
+  if (!file)
+  {
+    perror ("tmpfile");
+    exit (1);
+  }
+  fputs (src, file);
+  rewind (file);
+  return file;
+}
+
+static BtorSimulator *
+new_counter (void)
+{
+  BtorSimulator *s = btorsim_new ();
+  FILE *file       = open_model (counter);
+  CHECK (btorsim_read_model (s, file, "counter"));
+  fclose (file);
+  return s;
+}
+
+static void
+test_errors (void)
+{
+  BtorSimulator *s = btorsim_new ();
+  FILE *file;
+
+  /* no model read yet */
+  CHECK (btorsim_step (s) == -1);
+  CHECK (strlen (btorsim_error (s)));
+  CHECK (!btorsim_set_input (s, 0, "1"));
+  CHECK (!btorsim_snapshot (s));
+  CHECK (!btorsim_get_value (s, 1));
+  CHECK (btorsim_reached_bad (s, 0) == -1);
+  CHECK (btorsim_num_inputs (s) == 0);
+
+  /* parse errors */
+  file = open_model ("1 sort bitvec 4\n2 state 7\n");
+  CHECK (!btorsim_read_model (s, file, "invalid"));
+  CHECK (strlen (btorsim_error (s)));
+  fclose (file);
+  btorsim_delete (s);
+
+  s    = new_counter ();
+  file = open_model (counter);
+  CHECK (!btorsim_read_model (s, file, "counter"));
+  CHECK (!strcmp (btorsim_error (s), "model already read"));
+  fclose (file);
+
+  /* invalid positions and values */
+  CHECK (btorsim_input_id (s, 1) == -1);
+  CHECK (btorsim_state_id (s, -1) == -1);
+  CHECK (btorsim_bad_id (s, 1) == -1);
+  CHECK (!btorsim_set_input (s, 1, "1"));
+  CHECK (!btorsim_set_input (s, 0, "01"));
+  CHECK (!btorsim_set_input (s, 0, "x"));
+  CHECK (!btorsim_set_state (s, 0, "001"));
+  CHECK (!btorsim_set_state (s, 1, "0"));
+  CHECK (strlen (btorsim_error (s)));
+  CHECK (btorsim_reached_bad (s, 1) == -1);
+
+  /* arrays and invalid ids have no value */
+  CHECK (btorsim_step (s) == 0);
+  CHECK (!btorsim_get_value (s, 15));
+  CHECK (!btorsim_get_value (s, 0));
+  CHECK (!btorsim_get_value (s, 17));
+  btorsim_delete (s);
+}
+
+static void
+test_step (void)
+{
+  BtorSimulator *s = new_counter ();
+  int64_t i;
+
+  CHECK (btorsim_num_inputs (s) == 1);
+  CHECK (btorsim_num_states (s) == 2);
+  CHECK (btorsim_num_bads (s) == 1);
+  CHECK (btorsim_input_id (s, 0) == 3);
+  CHECK (btorsim_state_id (s, 0) == 5);
+  CHECK (btorsim_state_id (s, 1) == 15);
+  CHECK (btorsim_bad_id (s, 0) == 13);
+
+  /* unset inputs are zero without seed */
+  CHECK (btorsim_step (s) == 0);
+  CHECK_VALUE (s, 3, "0");
+  CHECK_VALUE (s, 5, "0000");
+  CHECK (btorsim_step (s) == 1);
+  CHECK_VALUE (s, 5, "0000");
+
+  for (i = 2; i <= 4; i++)
+  {
+    CHECK (btorsim_set_input (s, 0, "1"));
+    CHECK (btorsim_step (s) == i);
+    CHECK_VALUE (s, 3, "1");
+  }
+  CHECK_VALUE (s, 5, "0010");
+  CHECK_VALUE (s, 12, "0");
+  CHECK (btorsim_reached_bad (s, 0) == -1);
+  CHECK (btorsim_step (s) == 5);
+  CHECK_VALUE (s, 5, "0011");
+  CHECK_VALUE (s, 12, "1");
+  CHECK (btorsim_reached_bad (s, 0) == 5);
+  CHECK (btorsim_constraints_violated (s) == -1);
+
+  /* states set explicitly override their next function */
+  CHECK (btorsim_set_state (s, 0, "1110"));
+  CHECK_VALUE (s, 5, "1110");
+  CHECK (btorsim_set_input (s, 0, "1"));
+  CHECK (btorsim_step (s) == 6);
+  CHECK_VALUE (s, 8, "1111");
+  CHECK (btorsim_reached_bad (s, 0) == 5);
+
+  btorsim_reset (s);
+  CHECK (btorsim_step (s) == 0);
+  CHECK_VALUE (s, 5, "0000");
+  CHECK (btorsim_reached_bad (s, 0) == -1);
+  btorsim_delete (s);
+}
+
+static void
+test_snapshot (void)
+{
+  BtorSimulator *s = new_counter (), *t = new_counter ();
+  BtorSimSnapshot *snapshot;
+  int32_t i;
+
+  CHECK (btorsim_set_input (s, 0, "1"));
+  CHECK (btorsim_step (s) == 0);
+  CHECK (btorsim_set_input (s, 0, "1"));
+  CHECK (btorsim_step (s) == 1);
+  snapshot = btorsim_snapshot (s);
+  CHECK (snapshot);
+  if (!snapshot) return;
+
+  /* restoring any number of times continues from step 1 */
+  for (i = 0; i < 2; i++)
+  {
+    CHECK (btorsim_set_input (s, 0, "1"));
+    CHECK (btorsim_step (s) == 2);
+    CHECK (btorsim_set_input (s, 0, "1"));
+    CHECK (btorsim_step (s) == 3);
+    CHECK_VALUE (s, 5, "0011");
+    CHECK (btorsim_reached_bad (s, 0) == 3);
+
+    CHECK (btorsim_restore (s, snapshot));
+    CHECK_VALUE (s, 5, "0001");
+    CHECK_VALUE (s, 8, "0010");
+    CHECK (btorsim_reached_bad (s, 0) == -1);
+  }
+  CHECK (btorsim_step (s) == 2);
+  CHECK_VALUE (s, 5, "0010");
+
+  CHECK (!btorsim_restore (t, snapshot));
+  CHECK (!strcmp (btorsim_error (t), "snapshot of another simulator"));
+
+  btorsim_delete_snapshot (snapshot);
+  btorsim_delete (t);
+  btorsim_delete (s);
+}
+
+/* the same seed gives the same trace */
+static void
+test_seed (void)
+{
+  BtorSimulator *s = new_counter (), *t = new_counter ();
+  char value[5];
+  int32_t i;
+
+  btorsim_set_seed (s, 42);
+  btorsim_set_seed (t, 42);
+  for (i = 0; i < 20; i++)
+  {
+    CHECK (btorsim_step (s) == i);
+    CHECK (btorsim_step (t) == i);
+    strcpy (value, btorsim_get_value (s, 5));
+    CHECK_VALUE (t, 5, value);
+  }
+  btorsim_delete (t);
+  btorsim_delete (s);
+}
+
+int32_t
+main (void)
+{
+  test_errors ();
+  test_step ();
+  test_snapshot ();
+  test_seed ();
+  if (failed)
+  {
+    fprintf (stderr, "%d checks failed\n", failed);
+    return 1;
+  }
+  printf ("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,205 @@
+#!/bin/sh
+
+# Regression test of 'btorsim --server' and '--socket': traces, values and
+# witness checks of the server are compared with those of 'btorsim -s' and
+# 'btorsim -c' on the examples.
+#
+# usage: btorsimservertest.sh <btorsim> <btorsimclient> <examples> <outdir>
+
+readonly BTORSIM=$1
+readonly CLIENT=$2
+readonly EXAMPLES=$3
+readonly OUTDIR=$4
+
+status=0
+
+failed () {
+  echo "[error] $*"
+  status=1
+}
+
+# Check that the responses '$1.responses' are the expected '$1.expected'
+same () {
+  diff $1.expected $1.responses || failed "unexpected responses in '$1'"
+}
+
+# the result of 'btorsim -c' for model '$1' and witness '$2' as response
+check () {
+  $BTORSIM -v -c $1.btor2 $2 2>&1 | sed -n \
+    -e "s/^\[btorsim\] reached bad state properties { \(.*\) }$/ok \1/p" \
+    -e "s/^\*\*\* 'btorsim' error: /error /p" \
+    -e "s/^\*\*\* 'btorsim' parse error /error parse error /p"
+}
+
+# Simulate model '$1' randomly with seed '$2' (if any) and write requests
+# of the same trace to '$OUTDIR/$3.requests' with their expected responses
+# in '$OUTDIR/$3.expected': 'step' for every step, 'value' of the states and
+# inputs of the step in the witness, which are printed with '--states', and
+# 'bad 0' for the step at which 'btorsim -c' reaches the first property.
+trace () {
+  out=$OUTDIR/$3
+  rm -f $out.requests $out.expected
+  if [ -n "$2" ]
+  then
+    echo "seed $2" >> $out.requests
+    echo "ok" >> $out.expected
+  fi
+  $BTORSIM -b 0 -r 20 ${2:+-s $2} $1.btor2 > $out.witness
+  $BTORSIM -b 0 -r 20 ${2:+-s $2} --states $1.btor2 \
+    | awk -v requests=$out.requests -v expected=$out.expected '
+      function request(r, e) { print r >> requests; print e >> expected }
+      /^#/ { n = 0; next }
+      /^@/ { request("step", "ok " substr($1, 2))
+             for (i = 0; i < n; i++) request(states[i], values[i])
+             n = -1; next }
+      /^[0-9]/ { sym = $3; sub(/[@#].*/, "", sym)
+                 if (n < 0) request("value " sym, "ok " $2)
+                 else { states[n] = "value " sym; values[n++] = "ok " $2 } }'
+  echo "bad 0" >> $out.requests
+  check $1 $out.witness | sed 's/^ok.* b0@\([0-9]*\).*/ok \1/' >> $out.expected
+}
+
+# the last expected response of trace '$1' to request '$2'
+response () {
+  paste -d '|' $OUTDIR/$1.requests $OUTDIR/$1.expected \
+    | grep "^$2|" | tail -1 | cut -d '|' -f 2
+}
+
+mkdir -p $OUTDIR || exit 1
+cd $EXAMPLES || exit 1
+
+### Traces of 'step' and 'value' against random simulation
+trace twocount2c 11 seed11
+trace twocount2c 19 seed19
+trace factorial4even "" factorial4even
+
+### Snapshots continue the trace of the step at which they were taken
+last=`grep '^@' $OUTDIR/seed11.witness | tail -1 | cut -c 2-`
+cp $OUTDIR/seed11.requests $OUTDIR/server.requests
+cp $OUTDIR/seed11.expected $OUTDIR/server.expected
+cat >> $OUTDIR/server.requests << EOF
+snapshot
+reset
+seed 11
+step 3
+bad 0
+restore 0
+value s
+value t
+value a
+value b
+value 20
+bad 0
+snapshot
+drop 0
+restore 0
+drop 0
+restore 1
+input 0 0
+input 1 0
+step
+value s
+constraints
+EOF
+cat >> $OUTDIR/server.expected << EOF
+ok 0
+ok
+ok
+ok 2
+ok -1
+ok
+`response seed11 'value s'`
+`response seed11 'value t'`
+`response seed11 'value a'`
+`response seed11 'value b'`
+ok 1
+`response seed11 'bad 0'`
+ok 1
+ok
+error invalid snapshot in 'restore 0'
+error invalid snapshot in 'drop 0'
+ok
+ok
+ok
+ok $((last + 1))
+ok 0
+ok -1
+EOF
+
+### Witness checks against 'btorsim -c'
+sed "/^@$last$/,\$d" $OUTDIR/seed11.witness > $OUTDIR/unreached.witness
+echo . >> $OUTDIR/unreached.witness
+sed 's/^0 \([01]\) s@0$/0 \1\1 s@0/' $OUTDIR/seed11.witness \
+  > $OUTDIR/invalid.witness
+for witness in seed11 unreached invalid
+do
+  echo "check $OUTDIR/$witness.witness" >> $OUTDIR/server.requests
+  check twocount2c $OUTDIR/$witness.witness >> $OUTDIR/server.expected
+done
+
+### Invalid requests, the last one without new-line
+cat >> $OUTDIR/server.requests << EOF
+frobnicate
+value nosuchsymbol
+value 0
+input 2 1
+input 0 11
+step 1048577
+seed
+EOF
+printf "bad 1" >> $OUTDIR/server.requests
+cat >> $OUTDIR/server.expected << EOF
+error unknown request 'frobnicate'
+error invalid line 'nosuchsymbol'
+error invalid line '0'
+error invalid input '2'
+error expected 1 bits '0' or '1' for '3'
+error at most 1048576 steps per request
+error expected 'seed <s>'
+error expected 'bad <pos>'
+EOF
+
+for name in seed11 server
+do
+  $BTORSIM --server twocount2c.btor2 \
+    < $OUTDIR/$name.requests > $OUTDIR/$name.responses
+  same $OUTDIR/$name
+done
+$BTORSIM --server factorial4even.btor2 \
+  < $OUTDIR/factorial4even.requests > $OUTDIR/factorial4even.responses
+same $OUTDIR/factorial4even
+
+### Two clients at once on one socket, each repeating its own trace
+socket=$OUTDIR/btorsim.socket
+rm -f $socket
+$BTORSIM --socket $socket twocount2c.btor2 &
+server=$!
+clients=
+for name in seed11 seed19
+do
+  rm -f $OUTDIR/$name.repeated.*
+  for i in 1 2 3 4 5 6 7 8 9 10
+  do
+    echo reset >> $OUTDIR/$name.repeated.requests
+    echo ok >> $OUTDIR/$name.repeated.expected
+    cat $OUTDIR/$name.requests >> $OUTDIR/$name.repeated.requests
+    cat $OUTDIR/$name.expected >> $OUTDIR/$name.repeated.expected
+  done
+  $CLIENT $socket \
+    < $OUTDIR/$name.repeated.requests > $OUTDIR/$name.repeated.responses &
+  clients="$clients $!"
+done
+wait $clients
+if [ "`ls -l $socket | cut -c 1-10`" != "srwx------" ]
+then
+  failed "socket '$socket' accessible by other users"
+fi
+kill $server
+wait $server 2> /dev/null
+rm -f $socket
+for name in seed11 seed19
+do
+  same $OUTDIR/$name.repeated
+done
+
+exit $status
@@ -41,6 +41,18 @@ do
   runtest $name
 done
 
+echo -n "btorsimlibtest ..."
+if $BINDIR/btorsimlibtest 1>btorsimlibtest.log 2>&1
+then
+  echo -en "${GREEN} ok${NOCOLOR}\r"
+  ok=`expr $ok + 1`
+  erase
+else
+  echo -e "${RED} failed${NOCOLOR}"
+  failed=`expr $failed + 1`
+fi
+total=`expr $total + 1`
+
 echo
 if [ $ok -ne 0 ]
 then